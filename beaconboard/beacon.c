@@ -24,6 +24,7 @@
 #include <string.h>
 #include <math.h>
 
+#ifndef HOST_VERSION_BEACON_TEST
 #include <aversive.h>
 #include <aversive/pgmspace.h>
 #include <aversive/wait.h>
@@ -48,6 +49,11 @@
 
 #include "../common/i2c_commands.h"
 #include "main.h"
+#else
+/* host replay, see tests/beacon_replay */
+#include "beacon_host.h"
+#include "../common/i2c_commands.h"
+#endif
 #include "beacon.h"
 #include "beacon_calib.h"
 
@@ -76,13 +82,20 @@
 #endif /* BEACON_MODE_EXTERNAL */
 
 /* IR sensors pin read value */
+#ifndef HOST_VERSION_BEACON_TEST
 #define IR_SENSOR_0_DEG_PIN()     (!(_RC4))
 #define IR_SENSOR_180_DEG_PIN()     (!(_RC5))
+#endif
 
 #define EDGE_RISING        0
 #define EDGE_FALLING     1
 #define EDGE_MAX             2
 
+/* valid range of pulse widths, (size/period) x 100000, wider than the
+ * calibration range. Out of it the pulse is spurious */
+#define PULSE_MEASURE_MIN   600
+#define PULSE_MEASURE_MAX   6500
+
 /* modulo of timer base */
 #define MODULO_TIMER (65535L)
 
@@ -113,8 +126,50 @@ static volatile int32_t
 count_edge_ov[IR_SENSOR_MAX][EDGE_MAX] = {{0, 0}, {0 ,0}};    /* overflow flag   */
 static volatile int8_t 
 valid_pulse[IR_SENSOR_MAX] = {0, 0};    /* new valid measures available */
+static volatile microseconds
+edge_time_us[IR_SENSOR_MAX] = {0, 0};   /* time of falling edge */
 static int32_t invalid_count[IR_SENSOR_MAX] = {0, 0};        /* timeout of pulse measure */
 
+/* Capture of Timer 2 counts on an edge of an IR sensor.
+ * After falling edge set valid_pulse.
+ */
+static inline void beacon_edge_capture(uint8_t sensor, uint8_t edge,
+                                       int32_t count, int32_t ov, microseconds time_us)
+{
+    uint8_t flags;
+
+    IRQ_LOCK(flags);
+    count_edge[sensor][edge] = count;
+    count_edge_ov[sensor][edge] = ov;
+    if (edge == EDGE_FALLING)
+        edge_time_us[sensor] = time_us;
+    valid_pulse[sensor] = (edge == EDGE_FALLING);
+    IRQ_UNLOCK(flags);
+}
+
+/* Capture of Timer 2 counts on a turn, called with timer reset */
+static inline void beacon_period_capture(int32_t count, int32_t ov)
+{
+    count_period = count;
+    count_period_ov = ov;
+    valid_period = 1;
+}
+
+#ifdef HOST_VERSION_BEACON_TEST
+/* host replay of recorded captures, see tests/beacon_replay */
+void beacon_host_edge(uint8_t sensor, uint8_t rising,
+                      int32_t count, int32_t ov, microseconds time_us)
+{
+    beacon_edge_capture(sensor, rising? EDGE_RISING: EDGE_FALLING,
+                        count, ov, time_us);
+}
+
+void beacon_host_period(int32_t count, int32_t ov)
+{
+    beacon_period_capture(count, ov);
+}
+#endif
+
 
 /* initialize beacon */
 void beacon_init(void)
@@ -124,17 +179,20 @@ void beacon_init(void)
     beacon.opponent1_x = I2C_OPPONENT_NOT_THERE;
 #ifdef TWO_OPPONENTS
     beacon.opponent2_x = I2C_OPPONENT_NOT_THERE;
-    beacon.tracking_opp1_x = beacon.tracking_opp1_y = I2C_OPPONENT_NOT_THERE;
-    beacon.tracking_opp2_x = beacon.tracking_opp2_y = I2C_OPPONENT_NOT_THERE;
+    beacon_track_init(&beacon.tracker);
 #endif
 #ifdef ROBOT_2ND
     beacon.robot_2nd_x = I2C_OPPONENT_NOT_THERE;
 #endif
 
+    /* pulse width filters, see beacon_filter.h */
+    beacon_filter_init(&beacon.filter[IR_SENSOR_0_DEG], PULSE_MEASURE_MIN, PULSE_MEASURE_MAX);
+    beacon_filter_init(&beacon.filter[IR_SENSOR_180_DEG], PULSE_MEASURE_MIN, PULSE_MEASURE_MAX);
+
     /* default values */
     beaconboard.our_color = I2C_COLOR_RED;
 
-
+#ifndef HOST_VERSION_BEACON_TEST
     /* HARDWARE INIT */
 
     /* XXX: all measures are syncronized with then Timer 2 */
@@ -194,78 +252,49 @@ void beacon_init(void)
     /* CS EVENT */
     scheduler_add_periodical_event_priority(beacon_calc, NULL,
                         EVENT_PERIOD_BEACON / SCHEDULER_UNIT, EVENT_PRIO_BEACON);
-
+#endif
 }
 
+#ifndef HOST_VERSION_BEACON_TEST
+
 /* input compare 1 interrupt connected to IR_SENSOR_0_DEG */
 void __attribute__((__interrupt__, no_auto_psv)) _IC1Interrupt(void)
 {
-    uint8_t flags;
-
     /* reset flag */
     _IC1IF=0;
 
-    /* Capture of Timer 2 counts on falling and risign edge of IR sensor.
-    * After falling edge set valid_pulse.
-     */
-
     /* NOTE: Timer 2 count is hardware buffered by Input capture so,
      *       we don't lose counts.
      */
 
     /* rising edge */
-    if ( IR_SENSOR_0_DEG_PIN()) {
-        IRQ_LOCK(flags);
-        count_edge[IR_SENSOR_0_DEG][EDGE_RISING] = (int32_t)IC1BUF;
-        count_edge_ov[IR_SENSOR_0_DEG][EDGE_RISING] = _T2IF;
-        IRQ_UNLOCK(flags);
-        valid_pulse[IR_SENSOR_0_DEG] = 0;
-    }
+    if ( IR_SENSOR_0_DEG_PIN())
+        beacon_edge_capture(IR_SENSOR_0_DEG, EDGE_RISING,
+                            (int32_t)IC1BUF, _T2IF, 0);
     /* falling edge */
-    else {
-        IRQ_LOCK(flags);
-        count_edge[IR_SENSOR_0_DEG][EDGE_FALLING] = (int32_t)IC1BUF;
-        count_edge_ov[IR_SENSOR_0_DEG][EDGE_FALLING] = _T2IF;
-        IRQ_UNLOCK(flags);
-        valid_pulse[IR_SENSOR_0_DEG] = 1;
-
-    }
-
+    else
+        beacon_edge_capture(IR_SENSOR_0_DEG, EDGE_FALLING,
+                            (int32_t)IC1BUF, _T2IF, time_get_us2());
 }
 
 /* input compare 2 interrupt connected to IR_SENSOR_180_DEG */
 void __attribute__((__interrupt__, no_auto_psv)) _IC2Interrupt(void)
 {
-    uint8_t flags;
-
     /* reset flag */
     _IC2IF=0;
 
-    /* Capture of Timer 2 counts on falling and risign edge of IR sensor.
-    * After falling edge set valid_pulse.
-     */
-
     /* NOTE: Timer 2 count is hardware buffered by Input capture so,
      *       we don't lose counts.
      */
 
     /* rising edge */
-    if ( IR_SENSOR_180_DEG_PIN()) {
-        IRQ_LOCK(flags);
-        count_edge[IR_SENSOR_180_DEG][EDGE_RISING] = (int32_t)IC2BUF;
-        count_edge_ov[IR_SENSOR_180_DEG][EDGE_RISING] = _T2IF;
-        valid_pulse[IR_SENSOR_180_DEG] = 0;
-        IRQ_UNLOCK(flags);
-    }
+    if ( IR_SENSOR_180_DEG_PIN())
+        beacon_edge_capture(IR_SENSOR_180_DEG, EDGE_RISING,
+                            (int32_t)IC2BUF, _T2IF, 0);
     /* falling edge */
-    else {
-        IRQ_LOCK(flags);
-        count_edge[IR_SENSOR_180_DEG][EDGE_FALLING] = (int32_t)IC2BUF;
-        count_edge_ov[IR_SENSOR_180_DEG][EDGE_FALLING] = _T2IF;
-        valid_pulse[IR_SENSOR_180_DEG] = 1;
-        IRQ_UNLOCK(flags);
-    }
-
+    else
+        beacon_edge_capture(IR_SENSOR_180_DEG, EDGE_FALLING,
+                            (int32_t)IC2BUF, _T2IF, time_get_us2());
 }
 
 /* input compare 7 interrupt connected to turn sensor aligned with IR_SENSOR_0_DEG */
@@ -290,16 +319,12 @@ void __attribute__((__interrupt__, no_auto_psv)) _IC7Interrupt(void)
     * and timer reset, this involve an offset error on angle measure.
     */
 
-    /* save bufferd counts and overflow flag */
-    count_period = (int32_t)IC7BUF;
-    count_period_ov = _T2IF;
+    /* save bufferd counts and overflow flag, set valid_period */
+    beacon_period_capture((int32_t)IC7BUF, _T2IF);
 
     /* reset overflow flag */
     _T2IF = 0;
 
-    /* set valid_period */
-    valid_period = 1;
-
     /* unblock interrupt */
     IRQ_UNLOCK(flags);
 }
@@ -366,11 +391,15 @@ void beacon_stop(void)
     beacon.opponent1_x = I2C_OPPONENT_NOT_THERE;
 #ifdef TWO_OPPONENTS
     beacon.opponent2_x = I2C_OPPONENT_NOT_THERE;
+    beacon_track_init(&beacon.tracker);
 #endif
 #ifdef ROBOT_2ND
     beacon.robot_2nd_x = I2C_OPPONENT_NOT_THERE;
 #endif
+    beacon_filter_reset(&beacon.filter[IR_SENSOR_0_DEG]);
+    beacon_filter_reset(&beacon.filter[IR_SENSOR_180_DEG]);
 }
+#endif /* !HOST_VERSION_BEACON_TEST */
 
 /**********************************************************************
  * HELPERS FOR BEACON CALCULUS
@@ -518,8 +547,11 @@ void sensor_calc(uint8_t sensor)
     int32_t count_middle;
     static int32_t count_middle_filtered = 0;
 
+    int32_t measure;
+
     int32_t local_angle;
     int32_t local_dist;
+    microseconds local_time_us;
 
 #ifdef BEACON_MODE_EXTERNAL
     int32_t local_robot_x = 0;
@@ -528,11 +560,10 @@ void sensor_calc(uint8_t sensor)
 #endif
 
 #ifdef TWO_OPPONENTS
-    int16_t d_opp1, d_opp2;
-    uint8_t tracking_update = 0;
+    int8_t tracking_update;
+#ifdef ROBOT_2ND
     int16_t angle_dif = 0;
-#define OPPONENT_1    1
-#define OPPONENT_2    2
+#endif
 #endif
 
     int32_t result_x = 0;
@@ -566,6 +597,10 @@ void sensor_calc(uint8_t sensor)
         goto error;
     }
 
+    /* no turn period yet */
+    if(local_count_period <= 0)
+        goto error;
+
     /* continue with the calculus ... */
 
     /* read measurements */
@@ -579,6 +614,9 @@ void sensor_calc(uint8_t sensor)
     local_count_edge[EDGE_FALLING] = count_edge[sensor][EDGE_FALLING];
     local_count_edge_ov[EDGE_FALLING] = count_edge_ov[sensor][EDGE_FALLING];
 
+    /* capture time */
+    local_time_us = edge_time_us[sensor];
+
     /* reset flag */
     valid_pulse[sensor]=0;
 
@@ -613,12 +651,14 @@ void sensor_calc(uint8_t sensor)
     return;
     */
 
-    /* if pulse width is out of range return */
-/*        if(count_size > 5000){
-            BEACON_DEBUG("count_size_discarted = %ld", count_size);
-            goto error;
-        }
-*/
+    /* pulse width filter, discards spurious pulses, see beacon_filter.h */
+    measure = (count_size*100000L)/local_count_period;
+    measure = beacon_filter_pulse(&beacon.filter[sensor],
+                                  (uint16_t)(((count_middle*3600L)/local_count_period)%3600), measure);
+    if(measure < 0) {
+        //BEACON_DEBUG("pulse discarted, size = %ld", count_size);
+        goto error;
+    }
 
     /* calculate angle in Mega degrees */
     if(sensor == IR_SENSOR_180_DEG)
@@ -626,8 +666,8 @@ void sensor_calc(uint8_t sensor)
     else
         local_angle = get_angle(count_middle, local_count_period, 0);
 
-    /* calculate distance in mm */
-    local_dist = get_dist_array(sensor, count_size, local_count_period);
+    /* calculate distance in mm, from the filtered measure */
+    local_dist = get_dist_array(sensor, measure, 100000L);
     //local_dist = get_dist_array(sensor, count_size_filtered, local_count_period_filtered);
 
     if(local_dist == DIST_ERROR)
@@ -696,6 +736,7 @@ void sensor_calc(uint8_t sensor)
         beacon.opponent1_y = result_y;
         beacon.opponent1_angle = local_angle;
         beacon.opponent1_dist = local_dist;
+        beacon.opponent1_time_us = local_time_us;
         IRQ_UNLOCK(flags);
 
         /* final results */
@@ -706,8 +747,6 @@ void sensor_calc(uint8_t sensor)
 
     #else /* TWO OPPONENTS */
 
-#define TRACKING_WINDOW_mm    200
-
         /* XXX
             HIGH LIKELY CASE: case of reflexive beacon on in our secondary robot.
             Solution: discard if the angle is very similar to secondary robot angle
@@ -729,75 +768,39 @@ void sensor_calc(uint8_t sensor)
 #endif
 
 
-        /* distance from new xy to opponents xy */
-        d_opp1 = distance_between(result_x, result_y, beacon.tracking_opp1_x, beacon.tracking_opp1_y);
-        d_opp2 = distance_between(result_x, result_y, beacon.tracking_opp2_x, beacon.tracking_opp2_y);
+        /* associate to opponent 1 or 2, see beacon_track.h */
+        tracking_update = beacon_track_fix(&beacon.tracker, result_x, result_y, local_time_us);
 
-        /* mimimun distance inside a window */
-        if(d_opp1 <= d_opp2) {
-             if(d_opp1 < TRACKING_WINDOW_mm)
-                tracking_update = OPPONENT_1;
-        }
-        else {
-            if(d_opp2 < TRACKING_WINDOW_mm)
-                tracking_update = OPPONENT_2;
-        }
-
-        /* initialization or not in window */
-        if(tracking_update == 0) {
-
-            /* initial state or lost both opponents */
-            if(beacon.opponent1_x == I2C_OPPONENT_NOT_THERE) {
-                tracking_update = OPPONENT_1;
-                BEACON_DEBUG("Opponent 1 intialized");
-            }
-            else if(beacon.opponent2_x == I2C_OPPONENT_NOT_THERE) {
-                tracking_update = OPPONENT_2;
-                BEACON_DEBUG("Opponent 2 intialized");
-            }
-            else {
-                BEACON_DEBUG("Point out of windows");
-
-                if(d_opp1 < d_opp2) tracking_update = OPPONENT_1;
-                else tracking_update = OPPONENT_2;
-            }
-        }
+        if(tracking_update < 0)
+            BEACON_DEBUG("Point out of gates (%ld %ld)", result_x, result_y);
 
         /* update results */
-        if(tracking_update == OPPONENT_1) {
+        if(tracking_update == 0) {
             IRQ_LOCK(flags);
-            beacon.opponent1_x = beacon.tracking_opp1_x = result_x;
-            beacon.opponent1_y = beacon.tracking_opp1_y = result_y;
+            beacon.opponent1_x = result_x;
+            beacon.opponent1_y = result_y;
             beacon.opponent1_angle = local_angle;
             beacon.opponent1_dist = local_dist;
+            beacon.opponent1_time_us = local_time_us;
             IRQ_UNLOCK(flags);
-
-            /* reset tracking watchdog counter */
-            beacon.tracking_opp1_counts = 0;
         }
-        else if(tracking_update == OPPONENT_2) {
+        else if(tracking_update == 1) {
             IRQ_LOCK(flags);
-            beacon.opponent2_x = beacon.tracking_opp2_x = result_x;
-            beacon.opponent2_y = beacon.tracking_opp2_y = result_y;
+            beacon.opponent2_x = result_x;
+            beacon.opponent2_y = result_y;
             beacon.opponent2_angle = local_angle;
             beacon.opponent2_dist = local_dist;
+            beacon.opponent2_time_us = local_time_us;
             IRQ_UNLOCK(flags);
-
-            /* reset tracking watchdog counter */
-            beacon.tracking_opp2_counts = 0;
         }
 
         /* traking watchdog */
-        if(beacon.tracking_opp1_counts < 10)
-            beacon.tracking_opp1_counts++;
-        else {
+        if(!beacon.tracker.track[0].valid) {
             //BEACON_DEBUG("opponent 1 not there");
             beacon.opponent1_x = I2C_OPPONENT_NOT_THERE;
         }
 
-        if(beacon.tracking_opp2_counts < 10)
-            beacon.tracking_opp2_counts++;
-        else {
+        if(!beacon.tracker.track[1].valid) {
             //BEACON_DEBUG("opponent 2 not there");
             beacon.opponent2_x = I2C_OPPONENT_NOT_THERE;
         }
@@ -834,6 +837,7 @@ void sensor_calc(uint8_t sensor)
         beacon.robot_2nd_y = result_y;
         beacon.robot_2nd_angle = local_angle;
         beacon.robot_2nd_dist = local_dist;
+        beacon.robot_2nd_time_us = local_time_us;
         IRQ_UNLOCK(flags);
 
         /* final results */
@@ -871,6 +875,7 @@ error:
             beacon.opponent1_x = I2C_OPPONENT_NOT_THERE;
 #ifdef TWO_OPPONENTS
             beacon.opponent2_x = I2C_OPPONENT_NOT_THERE;
+            beacon_track_init(&beacon.tracker);
 #endif
             IRQ_UNLOCK(flags);
 
@@ -889,6 +894,7 @@ error:
 
 }
 
+#ifndef HOST_VERSION_BEACON_TEST
 /* beacon calculus event */
 void beacon_calc(void *dummy)
 {
@@ -907,6 +913,7 @@ void beacon_calc(void *dummy)
         sensor_calc(IR_SENSOR_180_DEG);
     }
 }
+#endif
 
 
 
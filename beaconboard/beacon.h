@@ -20,6 +20,9 @@
  *  Javier Balias Santos <javier@arc-robots.org>
  */
 
+#include "beacon_track.h"
+#include "beacon_filter.h"
+
 /* IR sensor management */
 #define IR_SENSOR_0_DEG		0
 #define IR_SENSOR_180_DEG	1
@@ -37,26 +40,26 @@ struct beacon {
 	int32_t opponent1_dist;
 	int32_t opponent1_x;
 	int32_t opponent1_y;
+	microseconds opponent1_time_us;	/* capture time */
 
 #ifdef TWO_OPPONENTS
 	int32_t opponent2_angle;
 	int32_t opponent2_dist;
 	int32_t opponent2_x;
 	int32_t opponent2_y;
+	microseconds opponent2_time_us;
 
-	uint8_t tracking_opp1_counts;
-	uint8_t tracking_opp2_counts;
-	int32_t tracking_opp1_x;
-	int32_t tracking_opp1_y;
-	int32_t tracking_opp2_x;
-	int32_t tracking_opp2_y;
+	struct beacon_tracker tracker;	/* opponents association */
 #endif
 #ifdef ROBOT_2ND
 	int32_t robot_2nd_angle;
 	int32_t robot_2nd_dist;
 	int32_t robot_2nd_x;
 	int32_t robot_2nd_y;
+	microseconds robot_2nd_time_us;
 #endif
+
+	struct beacon_filter filter[IR_SENSOR_MAX];	/* pulse width filters */
 };
 
 extern struct beacon beacon;
@@ -67,3 +70,13 @@ void beacon_stop(void);
 void beacon_calc(void *dummy);
 
 void beacon_angle_dist_to_x_y(int32_t angle, int32_t dist, int32_t *x, int32_t *y);
+
+/* calculate the opponent position of the last pulse of a sensor */
+void sensor_calc(uint8_t sensor);
+
+#ifdef HOST_VERSION_BEACON_TEST
+/* host replay of recorded Timer 2 captures, see tests/beacon_replay */
+void beacon_host_edge(uint8_t sensor, uint8_t rising,
+                      int32_t count, int32_t ov, microseconds time_us);
+void beacon_host_period(int32_t count, int32_t ov);
+#endif
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdint.h>
 
+#ifndef HOST_VERSION_BEACON_TEST
 #include <aversive.h>
 #include <aversive/pgmspace.h>
 #include <aversive/wait.h>
@@ -43,6 +44,9 @@
 #include <blocking_detection_manager.h>
 
 #include "main.h"
+#else
+#include "beacon_host.h"
+#endif
 #include "beacon.h"
 #include "beacon_calib.h"
 
@@ -72,572 +76,20 @@
 #define S180_MEASURE_MIN 	920
 
 /* get distance params */
-#define S180_X_EVAL_DELTA	8
 #define S180_X_EVAL_MIN		920
-#define S180_ARRAY_SIZE		561
+#define S180_KNOT_SHIFT		7
 
-uint8_t measure2distance_sensor_180 [] = {
-23	,
-23	,
-24	,
-24	,
-25	,
-25	,
-26	,
-27	,
-27	,
-28	,
-28	,
-29	,
-29	,
-30	,
-30	,
-31	,
-32	,
-32	,
-33	,
-33	,
-34	,
-34	,
-35	,
-36	,
-36	,
-37	,
-37	,
-38	,
-38	,
-39	,
-40	,
-40	,
-41	,
-41	,
-42	,
-42	,
-43	,
-44	,
-44	,
-45	,
-45	,
-46	,
-46	,
-47	,
-48	,
-48	,
-49	,
-49	,
-50	,
-50	,
-51	,
-51	,
-52	,
-53	,
-53	,
-54	,
-54	,
-55	,
-55	,
-56	,
-56	,
-57	,
-57	,
-58	,
-58	,
-59	,
-60	,
-60	,
-61	,
-61	,
-62	,
-62	,
-63	,
-63	,
-64	,
-64	,
-65	,
-65	,
-66	,
-66	,
-67	,
-67	,
-68	,
-68	,
-69	,
-69	,
-69	,
-70	,
-70	,
-71	,
-71	,
-72	,
-72	,
-73	,
-73	,
-74	,
-74	,
-74	,
-75	,
-75	,
-76	,
-76	,
-77	,
-77	,
-77	,
-78	,
-78	,
-79	,
-79	,
-79	,
-80	,
-80	,
-81	,
-81	,
-81	,
-82	,
-82	,
-83	,
-83	,
-83	,
-84	,
-84	,
-84	,
-85	,
-85	,
-86	,
-86	,
-86	,
-87	,
-87	,
-87	,
-88	,
-88	,
-88	,
-89	,
-89	,
-89	,
-90	,
-90	,
-90	,
-91	,
-91	,
-91	,
-92	,
-92	,
-92	,
-93	,
-93	,
-93	,
-93	,
-94	,
-94	,
-94	,
-95	,
-95	,
-95	,
-96	,
-96	,
-96	,
-96	,
-97	,
-97	,
-97	,
-98	,
-98	,
-98	,
-98	,
-99	,
-99	,
-99	,
-99	,
-100	,
-100	,
-100	,
-101	,
-101	,
-101	,
-101	,
-102	,
-102	,
-102	,
-102	,
-103	,
-103	,
-103	,
-103	,
-104	,
-104	,
-104	,
-104	,
-105	,
-105	,
-105	,
-105	,
-106	,
-106	,
-106	,
-106	,
-107	,
-107	,
-107	,
-107	,
-108	,
-108	,
-108	,
-108	,
-109	,
-109	,
-109	,
-109	,
-110	,
-110	,
-110	,
-110	,
-111	,
-111	,
-111	,
-111	,
-112	,
-112	,
-112	,
-112	,
-113	,
-113	,
-113	,
-113	,
-114	,
-114	,
-114	,
-114	,
-115	,
-115	,
-115	,
-115	,
-116	,
-116	,
-116	,
-116	,
-117	,
-117	,
-117	,
-117	,
-118	,
-118	,
-118	,
-119	,
-119	,
-119	,
-119	,
-120	,
-120	,
-120	,
-120	,
-121	,
-121	,
-121	,
-122	,
-122	,
-122	,
-122	,
-123	,
-123	,
-123	,
-124	,
-124	,
-124	,
-124	,
-125	,
-125	,
-125	,
-126	,
-126	,
-126	,
-127	,
-127	,
-127	,
-127	,
-128	,
-128	,
-128	,
-129	,
-129	,
-129	,
-130	,
-130	,
-130	,
-131	,
-131	,
-131	,
-132	,
-132	,
-132	,
-133	,
-133	,
-133	,
-134	,
-134	,
-134	,
-135	,
-135	,
-135	,
-136	,
-136	,
-136	,
-137	,
-137	,
-137	,
-138	,
-138	,
-138	,
-139	,
-139	,
-139	,
-140	,
-140	,
-141	,
-141	,
-141	,
-142	,
-142	,
-142	,
-143	,
-143	,
-143	,
-144	,
-144	,
-145	,
-145	,
-145	,
-146	,
-146	,
-147	,
-147	,
-147	,
-148	,
-148	,
-148	,
-149	,
-149	,
-150	,
-150	,
-150	,
-151	,
-151	,
-152	,
-152	,
-152	,
-153	,
-153	,
-154	,
-154	,
-154	,
-155	,
-155	,
-156	,
-156	,
-156	,
-157	,
-157	,
-158	,
-158	,
-158	,
-159	,
-159	,
-160	,
-160	,
-161	,
-161	,
-161	,
-162	,
-162	,
-163	,
-163	,
-163	,
-164	,
-164	,
-165	,
-165	,
-166	,
-166	,
-166	,
-167	,
-167	,
-168	,
-168	,
-168	,
-169	,
-169	,
-170	,
-170	,
-170	,
-171	,
-171	,
-172	,
-172	,
-173	,
-173	,
-173	,
-174	,
-174	,
-175	,
-175	,
-175	,
-176	,
-176	,
-177	,
-177	,
-177	,
-178	,
-178	,
-179	,
-179	,
-179	,
-180	,
-180	,
-181	,
-181	,
-181	,
-182	,
-182	,
-183	,
-183	,
-183	,
-184	,
-184	,
-184	,
-185	,
-185	,
-186	,
-186	,
-186	,
-187	,
-187	,
-187	,
-188	,
-188	,
-189	,
-189	,
-189	,
-190	,
-190	,
-190	,
-191	,
-191	,
-191	,
-192	,
-192	,
-192	,
-193	,
-193	,
-194	,
-194	,
-194	,
-195	,
-195	,
-195	,
-196	,
-196	,
-196	,
-197	,
-197	,
-197	,
-197	,
-198	,
-198	,
-198	,
-199	,
-199	,
-199	,
-200	,
-200	,
-200	,
-201	,
-201	,
-201	,
-201	,
-202	,
-202	,
-202	,
-203	,
-203	,
-203	,
-203	,
-204	,
-204	,
-204	,
-204	,
-205	,
-205	,
-205	,
-205	,
-206	,
-206	,
-206	,
-207	,
-207	,
-207	,
-207	,
-207	,
-208	,
-208	,
-208	,
-208	,
-209	,
-209	,
-209	,
-209	,
-210	,
-210	,
-210	,
-210	,
-211	,
-211	,
-211	,
-211	,
-211	,
-212	,
-212	,
-212	,
-212	,
-212	,
-213	,
-213	,
-213	,
-213	,
-214	,
-214	,
-214	,
-214	,
-214	,
-215	,
-215	,
-215	,
-215	,
-215	,
-216	,
-216	,
-216	,
-216	,
-216	,
-217	,
-217	,
-217	,
-217	,
-217	,
-218	,
-218	,
-218	,
-218	,
-219	,
-219	,
-219	,
-219	,
-219	,
-220	,
-220	,
-220	,
-220	,
-221	,
-221	,
-221 };
+/* S180 distance (mm) every 2^S180_KNOT_SHIFT measures from S180_X_EVAL_MIN,
+ * generated by tests/beacon/beacon_dist_fit.py from beacon_robot_calib_3m.mat */
+#define S180_KNOTS		36
+
+static const int16_t s180_knots[S180_KNOTS] = {
+	2211, 2175, 2141, 2107, 2070, 2028, 1981, 1928,
+	1871, 1810, 1746, 1680, 1614, 1548, 1485, 1424,
+	1366, 1312, 1262, 1216, 1172, 1131, 1091, 1052,
+	1011,  967,  919,  866,  807,  740,  666,  585,
+	 498,  407,  316,  228,
+};
 
 /* SENSOR 0 ***************************************************************************/
 
@@ -646,478 +98,41 @@ uint8_t measure2distance_sensor_180 [] = {
 #define S0_MEASURE_MIN 	1236 //820
 
 /* get distance params */
-#define S0_X_EVAL_DELTA		8
 #define S0_X_EVAL_MIN		820
-#define S0_ARRAY_SIZE		461
+#define S0_KNOT_SHIFT		7
+
+/* S0 distance (mm) every 2^S0_KNOT_SHIFT measures from S0_X_EVAL_MIN,
+ * generated by tests/beacon/beacon_dist_fit.py from beacon_robot_calib_2ndrobot_3m.mat */
+#define S0_KNOTS		30
+
+static const int16_t s0_knots[S0_KNOTS] = {
+	2267, 2105, 1976, 1871, 1784, 1707, 1637, 1570,
+	1503, 1435, 1365, 1292, 1217, 1139, 1059,  978,
+	 898,  819,  743,  670,  602,  540,  484,  435,
+	 394,  360,  334,  316,  305,  300,
+};
+
+/* linear interpolation between the knots of a table, measure relative
+ * to the first knot */
+static uint16_t dist_interp(const int16_t *knots, uint8_t nb_knots,
+                            uint8_t shift, uint32_t measure)
+{
+	uint16_t index;
+	int32_t frac;
 
-uint16_t measure2distance_sensor_0 [] = {
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-30	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-31	,
-32	,
-32	,
-32	,
-32	,
-32	,
-32	,
-32	,
-32	,
-32	,
-33	,
-33	,
-33	,
-33	,
-33	,
-33	,
-33	,
-33	,
-34	,
-34	,
-34	,
-34	,
-34	,
-34	,
-34	,
-35	,
-35	,
-35	,
-35	,
-35	,
-35	,
-36	,
-36	,
-36	,
-36	,
-36	,
-37	,
-37	,
-37	,
-37	,
-37	,
-38	,
-38	,
-38	,
-38	,
-38	,
-39	,
-39	,
-39	,
-39	,
-40	,
-40	,
-40	,
-40	,
-41	,
-41	,
-41	,
-41	,
-42	,
-42	,
-42	,
-42	,
-43	,
-43	,
-43	,
-44	,
-44	,
-44	,
-44	,
-45	,
-45	,
-45	,
-46	,
-46	,
-46	,
-47	,
-47	,
-47	,
-47	,
-48	,
-48	,
-48	,
-49	,
-49	,
-49	,
-50	,
-50	,
-50	,
-51	,
-51	,
-51	,
-52	,
-52	,
-53	,
-53	,
-53	,
-54	,
-54	,
-54	,
-55	,
-55	,
-56	,
-56	,
-56	,
-57	,
-57	,
-57	,
-58	,
-58	,
-59	,
-59	,
-59	,
-60	,
-60	,
-61	,
-61	,
-61	,
-62	,
-62	,
-63	,
-63	,
-64	,
-64	,
-64	,
-65	,
-65	,
-66	,
-66	,
-67	,
-67	,
-67	,
-68	,
-68	,
-69	,
-69	,
-70	,
-70	,
-71	,
-71	,
-72	,
-72	,
-72	,
-73	,
-73	,
-74	,
-74	,
-75	,
-75	,
-76	,
-76	,
-77	,
-77	,
-78	,
-78	,
-79	,
-79	,
-80	,
-80	,
-80	,
-81	,
-81	,
-82	,
-82	,
-83	,
-83	,
-84	,
-84	,
-85	,
-85	,
-86	,
-86	,
-87	,
-87	,
-88	,
-88	,
-89	,
-89	,
-90	,
-90	,
-91	,
-91	,
-92	,
-92	,
-93	,
-93	,
-94	,
-94	,
-95	,
-95	,
-96	,
-96	,
-97	,
-97	,
-98	,
-98	,
-99	,
-99	,
-100	,
-100	,
-101	,
-101	,
-102	,
-102	,
-103	,
-103	,
-104	,
-104	,
-105	,
-105	,
-106	,
-106	,
-107	,
-107	,
-108	,
-108	,
-109	,
-109	,
-110	,
-110	,
-111	,
-111	,
-112	,
-112	,
-113	,
-113	,
-114	,
-114	,
-115	,
-115	,
-116	,
-116	,
-117	,
-117	,
-118	,
-118	,
-119	,
-119	,
-120	,
-120	,
-121	,
-121	,
-122	,
-122	,
-123	,
-123	,
-124	,
-124	,
-125	,
-125	,
-125	,
-126	,
-126	,
-127	,
-127	,
-128	,
-128	,
-129	,
-129	,
-130	,
-130	,
-131	,
-131	,
-132	,
-132	,
-132	,
-133	,
-133	,
-134	,
-134	,
-135	,
-135	,
-136	,
-136	,
-137	,
-137	,
-137	,
-138	,
-138	,
-139	,
-139	,
-140	,
-140	,
-141	,
-141	,
-141	,
-142	,
-142	,
-143	,
-143	,
-144	,
-144	,
-144	,
-145	,
-145	,
-146	,
-146	,
-147	,
-147	,
-147	,
-148	,
-148	,
-149	,
-149	,
-149	,
-150	,
-150	,
-151	,
-151	,
-152	,
-152	,
-152	,
-153	,
-153	,
-154	,
-154	,
-154	,
-155	,
-155	,
-156	,
-156	,
-157	,
-157	,
-157	,
-158	,
-158	,
-159	,
-159	,
-159	,
-160	,
-160	,
-161	,
-161	,
-162	,
-162	,
-162	,
-163	,
-163	,
-164	,
-164	,
-165	,
-165	,
-165	,
-166	,
-166	,
-167	,
-167	,
-168	,
-168	,
-168	,
-169	,
-169	,
-170	,
-170	,
-171	,
-171	,
-172	,
-172	,
-173	,
-173	,
-173	,
-174	,
-174	,
-175	,
-175	,
-176	,
-176	,
-177	,
-177	,
-178	,
-178	,
-179	,
-179	,
-180	,
-180	,
-181	,
-181	,
-182	,
-183	,
-183	,
-184	,
-184	,
-185	,
-185	,
-186	,
-187	,
-187	,
-188	,
-188	,
-189	,
-190	,
-190	,
-191	,
-191	,
-192	,
-193	,
-193	,
-194	,
-195	,
-196	,
-196	,
-197	,
-198	,
-198	,
-199	,
-200	,
-201	,
-201	,
-202	,
-203	,
-204	,
-205	,
-205	,
-206	,
-207	,
-208	,
-209	,
-210	,
-211	,
-211	,
-212	,
-213	,
-214	,
-215	,
-216	,
-217	,
-218	,
-219	,
-220	,
-221	,
-222	,
-223	,
-224	,
-226	,
-227 };
+	index = measure >> shift;
+	if(index > nb_knots - 2)
+		index = nb_knots - 2;
+
+	frac = measure - ((uint32_t)index << shift);
+
+	return knots[index] + ((int32_t)(knots[index+1] - knots[index]) * frac) / (1L << shift);
+}
 
-/* get distance (cm) from relative size */
+/* get distance (mm) from relative size */
 uint16_t get_dist_array(uint8_t sensor, int32_t size, int32_t period)
 {
 	uint32_t measure;
-	uint16_t index;
 
 	/* calculate measure */
 	measure = (uint32_t)((size*100000)/period);
@@ -1130,14 +145,9 @@ uint16_t get_dist_array(uint8_t sensor, int32_t size, int32_t period)
 		if(measure < S180_MEASURE_MIN)
 			measure = S180_MEASURE_MIN;
 	
-		/* calculate array index */
-		index = (S180_ARRAY_SIZE-1) - ((measure-S180_X_EVAL_MIN)/S180_X_EVAL_DELTA);	
-	
-		//BEACON_DEBUG("measure = %.4ld / index = %.3d / dist = %.3d cm",
-		//		       measure, index, measure2distance_sensor_180[index]);
-	
-		/* return distance from array in mm */
-		return (measure2distance_sensor_180[index]*10);
+			/* return distance in mm */
+		return dist_interp(s180_knots, S180_KNOTS, S180_KNOT_SHIFT,
+		                   measure - S180_X_EVAL_MIN);
 	}
 	else 
 	{
@@ -1152,14 +162,9 @@ uint16_t get_dist_array(uint8_t sensor, int32_t size, int32_t period)
 			return DIST_ERROR;			/* HACK for not detect s180 beacon, very specific case */
 		}
 	
-		/* calculate array index */
-		index = (S0_ARRAY_SIZE-1) - ((measure-S0_X_EVAL_MIN)/S0_X_EVAL_DELTA);	
-	
-		//BEACON_DEBUG("measure = %.4ld / index = %.3d / dist = %.3d cm",
-		//		       measure, index, measure2distance_sensor_0[index]);
-	
-		/* return distance from array in mm */
-		return (measure2distance_sensor_0[index]*10);
+		/* return distance in mm */
+		return dist_interp(s0_knots, S0_KNOTS, S0_KNOT_SHIFT,
+		                   measure - S0_X_EVAL_MIN);
 	}
 
 }
@@ -21,6 +21,6 @@
  */
 
 
-/* get distance (cm) from calib array */
+/* get distance (mm) from the calibration model of a sensor */
 #define DIST_ERROR 3000
 uint16_t get_dist_array(uint8_t sensor, int32_t size, int32_t period);
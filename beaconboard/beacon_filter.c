@@ -0,0 +1,117 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "beacon_filter.h"
+
+/* difference of two angles in 0.1 deg, between 0 and 1800 */
+static uint16_t angle_diff(uint16_t a1, uint16_t a2)
+{
+	int16_t d = (int16_t)a1 - (int16_t)a2;
+
+	if (d < 0)
+		d = -d;
+	if (d > 1800)
+		d = 3600 - d;
+	return d;
+}
+
+void beacon_filter_init(struct beacon_filter *bf,
+			int32_t measure_min, int32_t measure_max)
+{
+	memset(bf, 0, sizeof(*bf));
+	bf->n = BEACON_FILTER_N;
+	bf->outlier_pct = BEACON_FILTER_OUTLIER_PCT;
+	bf->window = BEACON_FILTER_WINDOW;
+	bf->measure_min = measure_min;
+	bf->measure_max = measure_max;
+}
+
+void beacon_filter_reset(struct beacon_filter *bf)
+{
+	bf->head = 0;
+	bf->count = 0;
+}
+
+int32_t beacon_filter_pulse(struct beacon_filter *bf,
+			    uint16_t angle, int32_t measure)
+{
+	uint16_t win[BEACON_FILTER_MAX], v;
+	int32_t median, dev;
+	uint8_t i, j, k, nb = 0, n;
+
+	bf->stats.pulses++;
+
+	if (measure < bf->measure_min || measure > bf->measure_max) {
+		bf->stats.range++;
+		return -1;
+	}
+
+	n = bf->n;
+	if (n > BEACON_FILTER_MAX)
+		n = BEACON_FILTER_MAX;
+
+	/* newest pulses at the same angle */
+	win[nb++] = measure;
+	for (i = 0; i < bf->count && nb < n; i++) {
+		k = (bf->head + BEACON_FILTER_HIST - 1 - i) % BEACON_FILTER_HIST;
+		if (angle_diff(bf->hist[k].angle, angle) <= bf->window)
+			win[nb++] = bf->hist[k].measure;
+	}
+
+	bf->hist[bf->head].angle = angle;
+	bf->hist[bf->head].measure = measure;
+	bf->head = (bf->head + 1) % BEACON_FILTER_HIST;
+	if (bf->count < BEACON_FILTER_HIST)
+		bf->count++;
+
+	if (n <= 1)
+		return measure;
+
+	if (nb == 1) {
+		bf->stats.isolated++;
+		return -1;
+	}
+
+	/* insertion sort, few values */
+	for (i = 1; i < nb; i++) {
+		v = win[i];
+		for (j = i; j > 0 && win[j-1] > v; j--)
+			win[j] = win[j-1];
+		win[j] = v;
+	}
+	median = ((int32_t)win[(nb-1)/2] + win[nb/2]) / 2;
+
+	/* two pulses can't tell which one is wrong */
+	if (nb >= 3) {
+		dev = measure - median;
+		if (dev < 0)
+			dev = -dev;
+		if (dev * 100 > (int32_t)bf->outlier_pct * median) {
+			bf->stats.outliers++;
+			return -1;
+		}
+	}
+
+	return median;
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Pulse width filter of a beacon IR sensor. The width is given as the
+ * measure ((size/period) x 100000) and the angle of the pulse middle.
+ * A pulse is rejected if its width is out of the valid range, if no
+ * pulse was seen at the same angle in the last revolutions (isolated),
+ * or if its width is far from the median of the pulses at the same
+ * angle (outlier). Else the median is the filtered width. No
+ * dependencies, host testable.
+ */
+
+#ifndef _BEACON_FILTER_H_
+#define _BEACON_FILTER_H_
+
+#include <stdint.h>
+
+#define BEACON_FILTER_MAX		7	/* max pulses of the median */
+#define BEACON_FILTER_HIST		(2*BEACON_FILTER_MAX)	/* two opponents */
+
+/* defaults */
+#define BEACON_FILTER_N			5
+#define BEACON_FILTER_OUTLIER_PCT	25
+#define BEACON_FILTER_WINDOW	100	/* 0.1 deg */
+
+struct beacon_filter_stats {
+	uint32_t pulses;			/* pulses given */
+	uint32_t range;				/* width out of the valid range */
+	uint32_t isolated;			/* no pulses at the same angle */
+	uint32_t outliers;			/* width far from the median */
+};
+
+struct beacon_filter {
+	/* config */
+	uint8_t n;					/* pulses of the median, 1 is no filter */
+	uint8_t outlier_pct;		/* max deviation to the median, % */
+	uint16_t window;			/* same angle, 0.1 deg */
+	int32_t measure_min;		/* valid range of widths */
+	int32_t measure_max;
+
+	/* last pulses, rejected too */
+	struct {
+		uint16_t angle;
+		uint16_t measure;
+	} hist[BEACON_FILTER_HIST];
+	uint8_t head;
+	uint8_t count;
+
+	struct beacon_filter_stats stats;
+};
+
+/* default config, clear history and stats */
+void beacon_filter_init(struct beacon_filter *bf,
+			int32_t measure_min, int32_t measure_max);
+
+/* clear history, keep config and stats */
+void beacon_filter_reset(struct beacon_filter *bf);
+
+/* filter a pulse, angle in 0.1 deg. Return the filtered measure or -1
+ * if rejected */
+int32_t beacon_filter_pulse(struct beacon_filter *bf,
+			    uint16_t angle, int32_t measure);
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "beacon_track.h"
+
+/* gate radius, grows with the time since the last update */
+#define GATE_MIN_mm			200		/* was TRACKING_WINDOW_mm */
+#define GATE_SPEED_mm_s		1200	/* unknown opponent acceleration */
+#define GATE_MAX_mm			600
+
+#define PREDICT_MAX_US		200000L	/* max extrapolation time */
+#define V_MIN_DT_US			20000L	/* min time between velocity samples */
+#define V_MAX_mm_s			1500
+#define V_FILTER_SHIFT		2		/* filter gain 1/4 */
+
+#define CAND_TIMEOUT_US		300000L	/* new opponent hypothesis timeout */
+#define REPLACE_MISS_MIN	4		/* only missed tracks can be replaced */
+
+static int32_t gate_mm(int32_t dt_us)
+{
+	int32_t gate;
+
+	if (dt_us < 0)
+		dt_us = 0;
+
+	gate = GATE_MIN_mm + (int32_t)(((int64_t)GATE_SPEED_mm_s * dt_us) / 1000000L);
+	return gate > GATE_MAX_mm? GATE_MAX_mm: gate;
+}
+
+static int32_t dist_mm(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+	int32_t dx = x2 - x1, dy = y2 - y1;
+
+	return (int32_t)sqrt((double)(dx*dx + dy*dy));
+}
+
+/* distance from the fix to the predicted track position, normalized
+ * by the gate (x1000). Return -1 if out of the gate */
+static int32_t track_distance(const struct beacon_track *t,
+			      int32_t x, int32_t y, int32_t time_us)
+{
+	int32_t dt_us = time_us - t->time_us;
+	int32_t px, py, d, gate;
+
+	if (!t->valid)
+		return -1;
+
+	if (dt_us > PREDICT_MAX_US)
+		dt_us = PREDICT_MAX_US;
+	if (dt_us < 0)
+		dt_us = 0;
+
+	px = t->x + (int32_t)(((int64_t)t->vx * dt_us) / 1000000L);
+	py = t->y + (int32_t)(((int64_t)t->vy * dt_us) / 1000000L);
+
+	d = dist_mm(x, y, px, py);
+	gate = gate_mm(time_us - t->time_us);
+	if (d >= gate)
+		return -1;
+
+	return (d * 1000L) / gate;
+}
+
+static void track_start(struct beacon_track *t,
+			int32_t x, int32_t y, int32_t time_us)
+{
+	memset(t, 0, sizeof(*t));
+	t->valid = 1;
+	t->x = x;
+	t->y = y;
+	t->time_us = time_us;
+}
+
+static void track_update(struct beacon_track *t,
+			 int32_t x, int32_t y, int32_t time_us)
+{
+	int32_t dt_us = time_us - t->time_us;
+	int32_t vx, vy;
+
+	if (dt_us >= V_MIN_DT_US) {
+		vx = (int32_t)(((int64_t)(x - t->x) * 1000000L) / dt_us);
+		vy = (int32_t)(((int64_t)(y - t->y) * 1000000L) / dt_us);
+
+		if (vx > V_MAX_mm_s) vx = V_MAX_mm_s;
+		if (vx < -V_MAX_mm_s) vx = -V_MAX_mm_s;
+		if (vy > V_MAX_mm_s) vy = V_MAX_mm_s;
+		if (vy < -V_MAX_mm_s) vy = -V_MAX_mm_s;
+
+		t->vx += (vx - t->vx) >> V_FILTER_SHIFT;
+		t->vy += (vy - t->vy) >> V_FILTER_SHIFT;
+	}
+
+	t->x = x;
+	t->y = y;
+	t->time_us = time_us;
+	t->miss = 0;
+}
+
+void beacon_track_init(struct beacon_tracker *bt)
+{
+	memset(bt->track, 0, sizeof(bt->track));
+	bt->cand_valid = 0;
+}
+
+int8_t beacon_track_fix(struct beacon_tracker *bt,
+			int32_t x, int32_t y, int32_t time_us)
+{
+	int32_t d[BEACON_TRACK_MAX];
+	int8_t i, num = -1;
+
+	bt->stats.fixes++;
+
+	for (i = 0; i < BEACON_TRACK_MAX; i++)
+		d[i] = track_distance(&bt->track[i], x, y, time_us);
+
+	/* inside the gates */
+	if (d[0] >= 0 && d[1] >= 0) {
+		bt->stats.ambiguous++;
+		num = (d[0] <= d[1])? 0: 1;
+	}
+	else if (d[0] >= 0)
+		num = 0;
+	else if (d[1] >= 0)
+		num = 1;
+
+	if (num >= 0) {
+		track_update(&bt->track[num], x, y, time_us);
+		bt->stats.updates++;
+		goto watchdog;
+	}
+
+	/* new opponent in a free track */
+	for (i = 0; i < BEACON_TRACK_MAX; i++) {
+		if (!bt->track[i].valid) {
+			num = i;
+			track_start(&bt->track[num], x, y, time_us);
+			bt->stats.inits++;
+			goto watchdog;
+		}
+	}
+
+	/* new opponent confirmed by two fixes, replaces the track missed
+	 * for longer, else this fix is the hypothesis */
+	i = (bt->track[0].miss >= bt->track[1].miss)? 0: 1;
+
+	if (bt->cand_valid && bt->track[i].miss >= REPLACE_MISS_MIN &&
+	    (time_us - bt->cand_time_us) < CAND_TIMEOUT_US &&
+	    dist_mm(x, y, bt->cand_x, bt->cand_y) < gate_mm(time_us - bt->cand_time_us)) {
+
+		num = i;
+		track_start(&bt->track[num], x, y, time_us);
+		bt->cand_valid = 0;
+		bt->stats.replaces++;
+		goto watchdog;
+	}
+
+	bt->cand_valid = 1;
+	bt->cand_x = x;
+	bt->cand_y = y;
+	bt->cand_time_us = time_us;
+	bt->stats.outliers++;
+
+ watchdog:
+	/* tracks without updates for BEACON_TRACK_MISS_MAX fixes */
+	for (i = 0; i < BEACON_TRACK_MAX; i++) {
+		if (i == num || !bt->track[i].valid)
+			continue;
+
+		if (++bt->track[i].miss >= BEACON_TRACK_MISS_MAX) {
+			bt->track[i].valid = 0;
+			bt->stats.lost++;
+		}
+	}
+
+	return num;
+}
@@ -0,0 +1,76 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Two opponents association of the beacon fixes. Each fix is compared
+ * with the position of each track predicted at the capture time, inside
+ * a gate that grows with the time since the last update. A fix out of
+ * all the gates is an outlier unless there is a free track, or a second
+ * fix confirms it is a new opponent (then it replaces the track that
+ * has been missed for longer). No dependencies, host testable.
+ */
+
+#ifndef _BEACON_TRACK_H_
+#define _BEACON_TRACK_H_
+
+#include <stdint.h>
+
+#define BEACON_TRACK_MAX		2
+#define BEACON_TRACK_MISS_MAX	10	/* fixes without update, track lost */
+
+struct beacon_track {
+	uint8_t valid;
+	uint8_t miss;				/* fixes since last update */
+	int32_t x, y;				/* last fix, mm */
+	int32_t vx, vy;				/* filtered velocity, mm/s */
+	int32_t time_us;			/* capture time of last fix */
+};
+
+struct beacon_track_stats {
+	uint32_t fixes;				/* fixes given */
+	uint32_t updates;			/* fixes associated to a track */
+	uint32_t ambiguous;			/* fixes inside the gates of both tracks */
+	uint32_t outliers;			/* fixes discarded, out of the gates */
+	uint32_t inits;				/* tracks started in a free track */
+	uint32_t replaces;			/* tracks replaced by a confirmed opponent */
+	uint32_t lost;				/* tracks lost by the watchdog */
+};
+
+struct beacon_tracker {
+	struct beacon_track track[BEACON_TRACK_MAX];
+
+	/* fix out of the gates, new opponent hypothesis */
+	uint8_t cand_valid;
+	int32_t cand_x, cand_y;
+	int32_t cand_time_us;
+
+	struct beacon_track_stats stats;
+};
+
+/* clear tracks, keep stats */
+void beacon_track_init(struct beacon_tracker *bt);
+
+/* associate a fix captured at time_us, return the track updated or -1
+ * if discarded */
+int8_t beacon_track_fix(struct beacon_tracker *bt,
+			int32_t x, int32_t y, int32_t time_us);
+
+#endif
@@ -45,17 +45,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=../cmdline.c ../commands.c ../commands_cs.c ../commands_gen.c ../cs.c ../main.c ../sensor.c ../beacon.c ../commands_beaconboard.c ../beacon_calib.c ../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager/blocking_detection_manager.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_align.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_head.c ../../libs/aversive4dspic/modules/devices/control_system/control_system_manager/control_system_manager.c ../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic/encoders_dspic.c ../../libs/aversive4dspic/modules/debug/error/error.c ../../libs/aversive4dspic/modules/hardware/dspic/oscillator/oscillator.c ../../libs/aversive4dspic/modules/ihm/parse/parse.c ../../libs/aversive4dspic/modules/ihm/parse/parse_num.c ../../libs/aversive4dspic/modules/ihm/parse/parse_string.c ../../libs/aversive4dspic/modules/devices/control_system/filters/pid/pid.c ../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc/pwm_mc.c ../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp/quadramp.c ../../libs/aversive4dspic/modules/ihm/rdline/rdline.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_add.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_del.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_dump.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_interrupt.c ../../libs/aversive4dspic/modules/base/time/time.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_setconf.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_dev_io.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_events.c ../../libs/aversive4dspic/modules/ihm/vt100/vt100.c
+SOURCEFILES_QUOTED_IF_SPACED=../cmdline.c ../commands.c ../commands_cs.c ../commands_gen.c ../cs.c ../main.c ../sensor.c ../beacon.c ../commands_beaconboard.c ../beacon_calib.c ../beacon_track.c ../beacon_filter.c ../../common/log_ring.c ../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager/blocking_detection_manager.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_align.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_head.c ../../libs/aversive4dspic/modules/devices/control_system/control_system_manager/control_system_manager.c ../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic/encoders_dspic.c ../../libs/aversive4dspic/modules/debug/error/error.c ../../libs/aversive4dspic/modules/hardware/dspic/oscillator/oscillator.c ../../libs/aversive4dspic/modules/ihm/parse/parse.c ../../libs/aversive4dspic/modules/ihm/parse/parse_num.c ../../libs/aversive4dspic/modules/ihm/parse/parse_string.c ../../libs/aversive4dspic/modules/devices/control_system/filters/pid/pid.c ../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc/pwm_mc.c ../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp/quadramp.c ../../libs/aversive4dspic/modules/ihm/rdline/rdline.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_add.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_del.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_dump.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_interrupt.c ../../libs/aversive4dspic/modules/base/time/time.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_setconf.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_dev_io.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_events.c ../../libs/aversive4dspic/modules/ihm/vt100/vt100.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/1472/cmdline.o ${OBJECTDIR}/_ext/1472/commands.o ${OBJECTDIR}/_ext/1472/commands_cs.o ${OBJECTDIR}/_ext/1472/commands_gen.o ${OBJECTDIR}/_ext/1472/cs.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/sensor.o ${OBJECTDIR}/_ext/1472/beacon.o ${OBJECTDIR}/_ext/1472/commands_beaconboard.o ${OBJECTDIR}/_ext/1472/beacon_calib.o ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_align.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_head.o ${OBJECTDIR}/_ext/2070070979/control_system_manager.o ${OBJECTDIR}/_ext/58830053/encoders_dspic.o ${OBJECTDIR}/_ext/2031334780/error.o ${OBJECTDIR}/_ext/1304587501/oscillator.o ${OBJECTDIR}/_ext/127553078/parse.o ${OBJECTDIR}/_ext/127553078/parse_num.o ${OBJECTDIR}/_ext/127553078/parse_string.o ${OBJECTDIR}/_ext/1331945997/pid.o ${OBJECTDIR}/_ext/1874181410/pwm_mc.o ${OBJECTDIR}/_ext/1331398257/quadramp.o ${OBJECTDIR}/_ext/400662767/rdline.o ${OBJECTDIR}/_ext/725505851/scheduler.o ${OBJECTDIR}/_ext/725505851/scheduler_add.o ${OBJECTDIR}/_ext/725505851/scheduler_del.o ${OBJECTDIR}/_ext/725505851/scheduler_dump.o ${OBJECTDIR}/_ext/725505851/scheduler_interrupt.o ${OBJECTDIR}/_ext/1453454205/time.o ${OBJECTDIR}/_ext/519785181/uart_setconf.o ${OBJECTDIR}/_ext/519785181/uart.o ${OBJECTDIR}/_ext/519785181/uart_dev_io.o ${OBJECTDIR}/_ext/519785181/uart_recv.o ${OBJECTDIR}/_ext/519785181/uart_recv_nowait.o ${OBJECTDIR}/_ext/519785181/uart_send.o ${OBJECTDIR}/_ext/519785181/uart_send_nowait.o ${OBJECTDIR}/_ext/519785181/uart_events.o ${OBJECTDIR}/_ext/121510518/vt100.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/1472/cmdline.o.d ${OBJECTDIR}/_ext/1472/commands.o.d ${OBJECTDIR}/_ext/1472/commands_cs.o.d ${OBJECTDIR}/_ext/1472/commands_gen.o.d ${OBJECTDIR}/_ext/1472/cs.o.d ${OBJECTDIR}/_ext/1472/main.o.d ${OBJECTDIR}/_ext/1472/sensor.o.d ${OBJECTDIR}/_ext/1472/beacon.o.d ${OBJECTDIR}/_ext/1472/commands_beaconboard.o.d ${OBJECTDIR}/_ext/1472/beacon_calib.o.d ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_align.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_head.o.d ${OBJECTDIR}/_ext/2070070979/control_system_manager.o.d ${OBJECTDIR}/_ext/58830053/encoders_dspic.o.d ${OBJECTDIR}/_ext/2031334780/error.o.d ${OBJECTDIR}/_ext/1304587501/oscillator.o.d ${OBJECTDIR}/_ext/127553078/parse.o.d ${OBJECTDIR}/_ext/127553078/parse_num.o.d ${OBJECTDIR}/_ext/127553078/parse_string.o.d ${OBJECTDIR}/_ext/1331945997/pid.o.d ${OBJECTDIR}/_ext/1874181410/pwm_mc.o.d ${OBJECTDIR}/_ext/1331398257/quadramp.o.d ${OBJECTDIR}/_ext/400662767/rdline.o.d ${OBJECTDIR}/_ext/725505851/scheduler.o.d ${OBJECTDIR}/_ext/725505851/scheduler_add.o.d ${OBJECTDIR}/_ext/725505851/scheduler_del.o.d ${OBJECTDIR}/_ext/725505851/scheduler_dump.o.d ${OBJECTDIR}/_ext/725505851/scheduler_interrupt.o.d ${OBJECTDIR}/_ext/1453454205/time.o.d ${OBJECTDIR}/_ext/519785181/uart_setconf.o.d ${OBJECTDIR}/_ext/519785181/uart.o.d ${OBJECTDIR}/_ext/519785181/uart_dev_io.o.d ${OBJECTDIR}/_ext/519785181/uart_recv.o.d ${OBJECTDIR}/_ext/519785181/uart_recv_nowait.o.d ${OBJECTDIR}/_ext/519785181/uart_send.o.d ${OBJECTDIR}/_ext/519785181/uart_send_nowait.o.d ${OBJECTDIR}/_ext/519785181/uart_events.o.d ${OBJECTDIR}/_ext/121510518/vt100.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/1472/cmdline.o ${OBJECTDIR}/_ext/1472/commands.o ${OBJECTDIR}/_ext/1472/commands_cs.o ${OBJECTDIR}/_ext/1472/commands_gen.o ${OBJECTDIR}/_ext/1472/cs.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/sensor.o ${OBJECTDIR}/_ext/1472/beacon.o ${OBJECTDIR}/_ext/1472/commands_beaconboard.o ${OBJECTDIR}/_ext/1472/beacon_calib.o ${OBJECTDIR}/_ext/1472/beacon_track.o ${OBJECTDIR}/_ext/1472/beacon_filter.o ${OBJECTDIR}/_ext/1329223797/log_ring.o ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_align.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_head.o ${OBJECTDIR}/_ext/2070070979/control_system_manager.o ${OBJECTDIR}/_ext/58830053/encoders_dspic.o ${OBJECTDIR}/_ext/2031334780/error.o ${OBJECTDIR}/_ext/1304587501/oscillator.o ${OBJECTDIR}/_ext/127553078/parse.o ${OBJECTDIR}/_ext/127553078/parse_num.o ${OBJECTDIR}/_ext/127553078/parse_string.o ${OBJECTDIR}/_ext/1331945997/pid.o ${OBJECTDIR}/_ext/1874181410/pwm_mc.o ${OBJECTDIR}/_ext/1331398257/quadramp.o ${OBJECTDIR}/_ext/400662767/rdline.o ${OBJECTDIR}/_ext/725505851/scheduler.o ${OBJECTDIR}/_ext/725505851/scheduler_add.o ${OBJECTDIR}/_ext/725505851/scheduler_del.o ${OBJECTDIR}/_ext/725505851/scheduler_dump.o ${OBJECTDIR}/_ext/725505851/scheduler_interrupt.o ${OBJECTDIR}/_ext/1453454205/time.o ${OBJECTDIR}/_ext/519785181/uart_setconf.o ${OBJECTDIR}/_ext/519785181/uart.o ${OBJECTDIR}/_ext/519785181/uart_dev_io.o ${OBJECTDIR}/_ext/519785181/uart_recv.o ${OBJECTDIR}/_ext/519785181/uart_recv_nowait.o ${OBJECTDIR}/_ext/519785181/uart_send.o ${OBJECTDIR}/_ext/519785181/uart_send_nowait.o ${OBJECTDIR}/_ext/519785181/uart_events.o ${OBJECTDIR}/_ext/121510518/vt100.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/1472/cmdline.o.d ${OBJECTDIR}/_ext/1472/commands.o.d ${OBJECTDIR}/_ext/1472/commands_cs.o.d ${OBJECTDIR}/_ext/1472/commands_gen.o.d ${OBJECTDIR}/_ext/1472/cs.o.d ${OBJECTDIR}/_ext/1472/main.o.d ${OBJECTDIR}/_ext/1472/sensor.o.d ${OBJECTDIR}/_ext/1472/beacon.o.d ${OBJECTDIR}/_ext/1472/commands_beaconboard.o.d ${OBJECTDIR}/_ext/1472/beacon_calib.o.d ${OBJECTDIR}/_ext/1472/beacon_track.o.d ${OBJECTDIR}/_ext/1472/beacon_filter.o.d ${OBJECTDIR}/_ext/1329223797/log_ring.o.d ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_add_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_align.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_del_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_head.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_tail.o.d ${OBJECTDIR}/_ext/1391665571/cirbuf_get_head.o.d ${OBJECTDIR}/_ext/2070070979/control_system_manager.o.d ${OBJECTDIR}/_ext/58830053/encoders_dspic.o.d ${OBJECTDIR}/_ext/2031334780/error.o.d ${OBJECTDIR}/_ext/1304587501/oscillator.o.d ${OBJECTDIR}/_ext/127553078/parse.o.d ${OBJECTDIR}/_ext/127553078/parse_num.o.d ${OBJECTDIR}/_ext/127553078/parse_string.o.d ${OBJECTDIR}/_ext/1331945997/pid.o.d ${OBJECTDIR}/_ext/1874181410/pwm_mc.o.d ${OBJECTDIR}/_ext/1331398257/quadramp.o.d ${OBJECTDIR}/_ext/400662767/rdline.o.d ${OBJECTDIR}/_ext/725505851/scheduler.o.d ${OBJECTDIR}/_ext/725505851/scheduler_add.o.d ${OBJECTDIR}/_ext/725505851/scheduler_del.o.d ${OBJECTDIR}/_ext/725505851/scheduler_dump.o.d ${OBJECTDIR}/_ext/725505851/scheduler_interrupt.o.d ${OBJECTDIR}/_ext/1453454205/time.o.d ${OBJECTDIR}/_ext/519785181/uart_setconf.o.d ${OBJECTDIR}/_ext/519785181/uart.o.d ${OBJECTDIR}/_ext/519785181/uart_dev_io.o.d ${OBJECTDIR}/_ext/519785181/uart_recv.o.d ${OBJECTDIR}/_ext/519785181/uart_recv_nowait.o.d ${OBJECTDIR}/_ext/519785181/uart_send.o.d ${OBJECTDIR}/_ext/519785181/uart_send_nowait.o.d ${OBJECTDIR}/_ext/519785181/uart_events.o.d ${OBJECTDIR}/_ext/121510518/vt100.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/_ext/1472/cmdline.o ${OBJECTDIR}/_ext/1472/commands.o ${OBJECTDIR}/_ext/1472/commands_cs.o ${OBJECTDIR}/_ext/1472/commands_gen.o ${OBJECTDIR}/_ext/1472/cs.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/sensor.o ${OBJECTDIR}/_ext/1472/beacon.o ${OBJECTDIR}/_ext/1472/commands_beaconboard.o ${OBJECTDIR}/_ext/1472/beacon_calib.o ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_align.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_head.o ${OBJECTDIR}/_ext/2070070979/control_system_manager.o ${OBJECTDIR}/_ext/58830053/encoders_dspic.o ${OBJECTDIR}/_ext/2031334780/error.o ${OBJECTDIR}/_ext/1304587501/oscillator.o ${OBJECTDIR}/_ext/127553078/parse.o ${OBJECTDIR}/_ext/127553078/parse_num.o ${OBJECTDIR}/_ext/127553078/parse_string.o ${OBJECTDIR}/_ext/1331945997/pid.o ${OBJECTDIR}/_ext/1874181410/pwm_mc.o ${OBJECTDIR}/_ext/1331398257/quadramp.o ${OBJECTDIR}/_ext/400662767/rdline.o ${OBJECTDIR}/_ext/725505851/scheduler.o ${OBJECTDIR}/_ext/725505851/scheduler_add.o ${OBJECTDIR}/_ext/725505851/scheduler_del.o ${OBJECTDIR}/_ext/725505851/scheduler_dump.o ${OBJECTDIR}/_ext/725505851/scheduler_interrupt.o ${OBJECTDIR}/_ext/1453454205/time.o ${OBJECTDIR}/_ext/519785181/uart_setconf.o ${OBJECTDIR}/_ext/519785181/uart.o ${OBJECTDIR}/_ext/519785181/uart_dev_io.o ${OBJECTDIR}/_ext/519785181/uart_recv.o ${OBJECTDIR}/_ext/519785181/uart_recv_nowait.o ${OBJECTDIR}/_ext/519785181/uart_send.o ${OBJECTDIR}/_ext/519785181/uart_send_nowait.o ${OBJECTDIR}/_ext/519785181/uart_events.o ${OBJECTDIR}/_ext/121510518/vt100.o
+OBJECTFILES=${OBJECTDIR}/_ext/1472/cmdline.o ${OBJECTDIR}/_ext/1472/commands.o ${OBJECTDIR}/_ext/1472/commands_cs.o ${OBJECTDIR}/_ext/1472/commands_gen.o ${OBJECTDIR}/_ext/1472/cs.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/sensor.o ${OBJECTDIR}/_ext/1472/beacon.o ${OBJECTDIR}/_ext/1472/commands_beaconboard.o ${OBJECTDIR}/_ext/1472/beacon_calib.o ${OBJECTDIR}/_ext/1472/beacon_track.o ${OBJECTDIR}/_ext/1472/beacon_filter.o ${OBJECTDIR}/_ext/1329223797/log_ring.o ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_add_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_align.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_del_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_head.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_buf_tail.o ${OBJECTDIR}/_ext/1391665571/cirbuf_get_head.o ${OBJECTDIR}/_ext/2070070979/control_system_manager.o ${OBJECTDIR}/_ext/58830053/encoders_dspic.o ${OBJECTDIR}/_ext/2031334780/error.o ${OBJECTDIR}/_ext/1304587501/oscillator.o ${OBJECTDIR}/_ext/127553078/parse.o ${OBJECTDIR}/_ext/127553078/parse_num.o ${OBJECTDIR}/_ext/127553078/parse_string.o ${OBJECTDIR}/_ext/1331945997/pid.o ${OBJECTDIR}/_ext/1874181410/pwm_mc.o ${OBJECTDIR}/_ext/1331398257/quadramp.o ${OBJECTDIR}/_ext/400662767/rdline.o ${OBJECTDIR}/_ext/725505851/scheduler.o ${OBJECTDIR}/_ext/725505851/scheduler_add.o ${OBJECTDIR}/_ext/725505851/scheduler_del.o ${OBJECTDIR}/_ext/725505851/scheduler_dump.o ${OBJECTDIR}/_ext/725505851/scheduler_interrupt.o ${OBJECTDIR}/_ext/1453454205/time.o ${OBJECTDIR}/_ext/519785181/uart_setconf.o ${OBJECTDIR}/_ext/519785181/uart.o ${OBJECTDIR}/_ext/519785181/uart_dev_io.o ${OBJECTDIR}/_ext/519785181/uart_recv.o ${OBJECTDIR}/_ext/519785181/uart_recv_nowait.o ${OBJECTDIR}/_ext/519785181/uart_send.o ${OBJECTDIR}/_ext/519785181/uart_send_nowait.o ${OBJECTDIR}/_ext/519785181/uart_events.o ${OBJECTDIR}/_ext/121510518/vt100.o
 
 # Source Files
-SOURCEFILES=../cmdline.c ../commands.c ../commands_cs.c ../commands_gen.c ../cs.c ../main.c ../sensor.c ../beacon.c ../commands_beaconboard.c ../beacon_calib.c ../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager/blocking_detection_manager.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_align.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_head.c ../../libs/aversive4dspic/modules/devices/control_system/control_system_manager/control_system_manager.c ../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic/encoders_dspic.c ../../libs/aversive4dspic/modules/debug/error/error.c ../../libs/aversive4dspic/modules/hardware/dspic/oscillator/oscillator.c ../../libs/aversive4dspic/modules/ihm/parse/parse.c ../../libs/aversive4dspic/modules/ihm/parse/parse_num.c ../../libs/aversive4dspic/modules/ihm/parse/parse_string.c ../../libs/aversive4dspic/modules/devices/control_system/filters/pid/pid.c ../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc/pwm_mc.c ../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp/quadramp.c ../../libs/aversive4dspic/modules/ihm/rdline/rdline.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_add.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_del.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_dump.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_interrupt.c ../../libs/aversive4dspic/modules/base/time/time.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_setconf.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_dev_io.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_events.c ../../libs/aversive4dspic/modules/ihm/vt100/vt100.c
+SOURCEFILES=../cmdline.c ../commands.c ../commands_cs.c ../commands_gen.c ../cs.c ../main.c ../sensor.c ../beacon.c ../commands_beaconboard.c ../beacon_calib.c ../beacon_track.c ../beacon_filter.c ../../common/log_ring.c ../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager/blocking_detection_manager.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_add_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_align.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_del_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_head.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_buf_tail.c ../../libs/aversive4dspic/modules/base/cirbuf/cirbuf_get_head.c ../../libs/aversive4dspic/modules/devices/control_system/control_system_manager/control_system_manager.c ../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic/encoders_dspic.c ../../libs/aversive4dspic/modules/debug/error/error.c ../../libs/aversive4dspic/modules/hardware/dspic/oscillator/oscillator.c ../../libs/aversive4dspic/modules/ihm/parse/parse.c ../../libs/aversive4dspic/modules/ihm/parse/parse_num.c ../../libs/aversive4dspic/modules/ihm/parse/parse_string.c ../../libs/aversive4dspic/modules/devices/control_system/filters/pid/pid.c ../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc/pwm_mc.c ../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp/quadramp.c ../../libs/aversive4dspic/modules/ihm/rdline/rdline.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_add.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_del.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_dump.c ../../libs/aversive4dspic/modules/base/scheduler/scheduler_interrupt.c ../../libs/aversive4dspic/modules/base/time/time.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_setconf.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_dev_io.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_recv_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_send_nowait.c ../../libs/aversive4dspic/modules/comm/dspic/uart/uart_events.c ../../libs/aversive4dspic/modules/ihm/vt100/vt100.c
 
 
 CFLAGS=
@@ -161,6 +161,27 @@ ${OBJECTDIR}/_ext/1472/beacon_calib.o: ../beacon_calib.c  nbproject/Makefile-${C
 	@${RM} ${OBJECTDIR}/_ext/1472/beacon_calib.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/beacon_calib.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1 -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1472/beacon_calib.o.d" -o ${OBJECTDIR}/_ext/1472/beacon_calib.o ../beacon_calib.c    
 	
+${OBJECTDIR}/_ext/1472/beacon_track.o: ../beacon_track.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_track.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_track.o.ok ${OBJECTDIR}/_ext/1472/beacon_track.o.err 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_track.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/beacon_track.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1 -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1472/beacon_track.o.d" -o ${OBJECTDIR}/_ext/1472/beacon_track.o ../beacon_track.c    
+	
+${OBJECTDIR}/_ext/1472/beacon_filter.o: ../beacon_filter.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_filter.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_filter.o.ok ${OBJECTDIR}/_ext/1472/beacon_filter.o.err 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_filter.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/beacon_filter.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1 -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1472/beacon_filter.o.d" -o ${OBJECTDIR}/_ext/1472/beacon_filter.o ../beacon_filter.c    
+	
+${OBJECTDIR}/_ext/1329223797/log_ring.o: ../../common/log_ring.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1329223797 
+	@${RM} ${OBJECTDIR}/_ext/1329223797/log_ring.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1329223797/log_ring.o.ok ${OBJECTDIR}/_ext/1329223797/log_ring.o.err 
+	@${RM} ${OBJECTDIR}/_ext/1329223797/log_ring.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1329223797/log_ring.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_ICD3=1 -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1329223797/log_ring.o.d" -o ${OBJECTDIR}/_ext/1329223797/log_ring.o ../../common/log_ring.c    
+	
 ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o: ../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager/blocking_detection_manager.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR}/_ext/1158586392 
 	@${RM} ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o.d 
@@ -519,6 +540,27 @@ ${OBJECTDIR}/_ext/1472/beacon_calib.o: ../beacon_calib.c  nbproject/Makefile-${C
 	@${RM} ${OBJECTDIR}/_ext/1472/beacon_calib.o 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/beacon_calib.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1472/beacon_calib.o.d" -o ${OBJECTDIR}/_ext/1472/beacon_calib.o ../beacon_calib.c    
 	
+${OBJECTDIR}/_ext/1472/beacon_track.o: ../beacon_track.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_track.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_track.o.ok ${OBJECTDIR}/_ext/1472/beacon_track.o.err 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_track.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/beacon_track.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1472/beacon_track.o.d" -o ${OBJECTDIR}/_ext/1472/beacon_track.o ../beacon_track.c    
+	
+${OBJECTDIR}/_ext/1472/beacon_filter.o: ../beacon_filter.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_filter.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_filter.o.ok ${OBJECTDIR}/_ext/1472/beacon_filter.o.err 
+	@${RM} ${OBJECTDIR}/_ext/1472/beacon_filter.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/beacon_filter.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1472/beacon_filter.o.d" -o ${OBJECTDIR}/_ext/1472/beacon_filter.o ../beacon_filter.c    
+	
+${OBJECTDIR}/_ext/1329223797/log_ring.o: ../../common/log_ring.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1329223797 
+	@${RM} ${OBJECTDIR}/_ext/1329223797/log_ring.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1329223797/log_ring.o.ok ${OBJECTDIR}/_ext/1329223797/log_ring.o.err 
+	@${RM} ${OBJECTDIR}/_ext/1329223797/log_ring.o 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1329223797/log_ring.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c ${MP_CC} $(MP_EXTRA_CC_PRE)  -omf=elf -x c -c -mcpu=$(MP_PROCESSOR_OPTION) -Wall -I".." -I"../../libs/aversive4dspic/include" -I"../../libs/aversive4dspic/include/aversive" -I"../../libs/aversive4dspic/include/aversive/dspic" -I"../../libs/aversive4dspic/modules/base/cirbuf" -I"../../libs/aversive4dspic/modules/base/scheduler" -I"../../libs/aversive4dspic/modules/base/math/fixed_point" -I"../../libs/aversive4dspic/modules/base/math/geometry" -I"../../libs/aversive4dspic/modules/base/math/vect2" -I"../../libs/aversive4dspic/modules/base/time" -I"../../libs/aversive4dspic/modules/debug" -I"../../libs/aversive4dspic/modules/debug/error" -I"../../libs/aversive4dspic/modules/debug/diagnostic" -I"../../libs/aversive4dspic/modules/comm/dspic/uart" -I"../../libs/aversive4dspic/modules/ihm/parse" -I"../../libs/aversive4dspic/modules/ihm/rdline" -I"../../libs/aversive4dspic/modules/ihm/vt100" -I"../../libs/aversive4dspic/modules/hardware/dspic/oscillator" -I"../../libs/aversive4dspic/modules/hardware/dspic/pwm_mc" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/pid" -I"../../libs/aversive4dspic/modules/devices/encoders/dspic/encoders_dspic" -I"../../libs/aversive4dspic/modules/devices/control_system/filters/quadramp" -I"../../libs/aversive4dspic/modules/devices/control_system/control_system_manager" -I"../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager" -I"../../common" -I"." -Os -MMD -MF "${OBJECTDIR}/_ext/1329223797/log_ring.o.d" -o ${OBJECTDIR}/_ext/1329223797/log_ring.o ../../common/log_ring.c    
+	
 ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o: ../../libs/aversive4dspic/modules/devices/robot/blocking_detection_manager/blocking_detection_manager.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR}/_ext/1158586392 
 	@${RM} ${OBJECTDIR}/_ext/1158586392/blocking_detection_manager.o.d 
@@ -48,6 +48,7 @@
 
 #include "main.h"
 #include "cmdline.h"
+#include "../common/log_ring.h"
 
 
 /* See in commands.c for the list of commands. */
@@ -114,6 +115,16 @@ void mylog(struct error * e, ...)
 	}
 
 	va_start(ap, e);
+
+	/* deferred, drained by cmdline_interact(). Errors are printed now */
+	if (log_ring_get_mode() != LOG_MODE_SYNC &&
+	    e->severity > ERROR_SEVERITY_ERROR) {
+		log_ring_vpush(e->err_num, e->severity, e->text,
+			       time_get_us2(), NULL, 0, ap);
+		va_end(ap);
+		return;
+	}
+
 	tv = time_get_time();
 	printf_P(PSTR("%ld.%.3ld: "), tv.s, (tv.us/1000UL));
 	vfprintf_P(stdout, e->text, ap);
@@ -121,6 +132,11 @@ void mylog(struct error * e, ...)
 	va_end(ap);
 }
 
+void mylog_init(void)
+{
+	log_ring_init(write_char);
+}
+
 /* init rdline and loop waiting for commands, never returns */
 int cmdline_interact(void)
 {
@@ -133,6 +149,9 @@ int cmdline_interact(void)
 	rdline_newline(&beaconboard.rdl, beaconboard.prompt);
 
 	while (1) {
+		beacon_status_push();
+		log_ring_drain();
+
 		c = uart_recv_nowait(CMDLINE_UART);
 		if (c == -1) 
 			continue;
@@ -32,9 +32,15 @@ void emergency(char c);
 /* log function */
 void mylog(struct error * e, ...);
 
+/* deferred logs, see ../common/log_ring.h */
+void mylog_init(void);
+
 /* launch cmdline */
 int cmdline_interact(void);
 
+/* push beacon status, see commands_beaconboard.c */
+void beacon_status_push (void);
+
 static inline uint8_t cmdline_keypressed(void) {
 	return (uart_recv_nowait(CMDLINE_UART) != -1);
 }
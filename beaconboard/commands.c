@@ -40,6 +40,7 @@ extern parse_pgm_inst_t cmd_sensor;
 extern parse_pgm_inst_t cmd_log;
 extern parse_pgm_inst_t cmd_log_show;
 extern parse_pgm_inst_t cmd_log_type;
+extern parse_pgm_inst_t cmd_log_mode;
 extern parse_pgm_inst_t cmd_scheduler;
 
 /* commands_cs.c */
@@ -63,6 +64,10 @@ extern parse_pgm_inst_t cmd_event;
 extern parse_pgm_inst_t cmd_test;
 extern parse_pgm_inst_t cmd_beacon;
 extern parse_pgm_inst_t cmd_opponent;
+extern parse_pgm_inst_t cmd_beacon_push;
+extern parse_pgm_inst_t cmd_beacon_tracking;
+extern parse_pgm_inst_t cmd_beacon_filter;
+extern parse_pgm_inst_t cmd_beacon_filter_show;
 extern parse_pgm_inst_t cmd_color;
 
 
@@ -77,6 +82,7 @@ parse_pgm_ctx_t main_ctx[] = {
 	(parse_pgm_inst_t *)&cmd_log,
 	(parse_pgm_inst_t *)&cmd_log_show,
 	(parse_pgm_inst_t *)&cmd_log_type,
+	(parse_pgm_inst_t *)&cmd_log_mode,
 	(parse_pgm_inst_t *)&cmd_scheduler,
 
 	/* commands_cs.c */
@@ -100,6 +106,10 @@ parse_pgm_ctx_t main_ctx[] = {
 	(parse_pgm_inst_t *)&cmd_test,
 	(parse_pgm_inst_t *)&cmd_beacon,
 	(parse_pgm_inst_t *)&cmd_opponent,
+	(parse_pgm_inst_t *)&cmd_beacon_push,
+	(parse_pgm_inst_t *)&cmd_beacon_tracking,
+	(parse_pgm_inst_t *)&cmd_beacon_filter,
+	(parse_pgm_inst_t *)&cmd_beacon_filter_show,
 	(parse_pgm_inst_t *)&cmd_color,
 
 	NULL,
@@ -404,51 +404,50 @@ void uart_send_buffer (uint8_t *buff, uint16_t length)
 	}	
 }
 
-/* function called when cmd_opponent is parsed successfully */
-static void cmd_opponent_parsed(void * parsed_result, void *data)
+/* status push mode, see bt_commands.h */
+static struct {
+	uint16_t period_ms;
+	uint16_t min_mm;
+	microseconds time_us;
+	int16_t opponent1_x;
+	int16_t opponent1_y;
+	int16_t opponent2_x;
+	int16_t opponent2_y;
+} status_push;
+
+/* sequence number of status frames */
+static uint8_t status_seq = 0;
+
+/* fill the status answer with the opponents position */
+static void beacon_status_fill (struct bt_beacon_status_ans *ans)
 {
-	struct cmd_opponent_result *res = parsed_result;
 	int32_t opponent1_x, opponent1_y, opponent1_dist, opponent1_angle;
+	microseconds opponent1_time_us;
 #ifdef TWO_OPPONENTS
 	int32_t opponent2_x, opponent2_y, opponent2_dist, opponent2_angle;
+	microseconds opponent2_time_us;
 #endif
 #ifdef ROBOT_2ND
 	int32_t robot_2nd_x, robot_2nd_y, robot_2nd_dist, robot_2nd_angle;
 #endif
+	microseconds now;
 	uint8_t flags;
-	struct bt_beacon_status_ans ans;
 	static uint16_t i=0;
 
-	/* reset watchdog */
-	beaconboard.watchdog = WATCHDOG_NB_TIMES;
-
-	/* test checksum */
-	if (!strcmp_P(res->arg0, PSTR("opponent")))
-		res->checksum = (uint16_t) (res->robot_x + res->robot_y + res->robot_a);
-	else {
-
-		if (res->checksum != (uint16_t)(res->robot_x + res->robot_y + res->robot_a)) {
-			ERROR (E_USER_BEACON, "checksum ERROR");
-			return;
-		}
-	}
-
-	/* get robot and opponents position */
+	/* get opponents position */
 	IRQ_LOCK(flags);
-	beacon.robot_x = (int32_t)res->robot_x;
-	beacon.robot_y = (int32_t)res->robot_y;
-	beacon.robot_a = (int32_t)res->robot_a;
-	
 	opponent1_x = beacon.opponent1_x;
 	opponent1_y = beacon.opponent1_y;
 	opponent1_angle = beacon.opponent1_angle;
 	opponent1_dist = beacon.opponent1_dist;
+	opponent1_time_us = beacon.opponent1_time_us;
 
 #ifdef TWO_OPPONENTS
 	opponent2_x = beacon.opponent2_x;
 	opponent2_y = beacon.opponent2_y;
 	opponent2_angle = beacon.opponent2_angle;
 	opponent2_dist = beacon.opponent2_dist;
+	opponent2_time_us = beacon.opponent2_time_us;
 #endif
 #ifdef ROBOT_2ND
 	robot_2nd_x = beacon.robot_2nd_x;
@@ -483,44 +482,135 @@ static void cmd_opponent_parsed(void * parsed_result, void *data)
 //#define DEBUG_STATUS
 #ifdef DEBUG_STATUS
 	/* fill answer structure */
-	ans.hdr.cmd = BT_BEACON_STATUS_ANS;
-	ans.opponent_x = i++;
-	ans.opponent_y = i+1000;
-	ans.opponent_a = i+2000;
-	ans.opponent_d = i+3000;
+	ans->hdr.cmd = BT_BEACON_STATUS_ANS;
+	ans->opponent_x = i++;
+	ans->opponent_y = i+1000;
+	ans->opponent_a = i+2000;
+	ans->opponent_d = i+3000;
 
 #ifdef TWO_OPPONENTS
-	ans.opponent2_x = i;
-	ans.opponent2_y = i+1000;
-	ans.opponent2_a = i+2000;
-	ans.opponent2_d = i+3000;
+	ans->opponent2_x = i;
+	ans->opponent2_y = i+1000;
+	ans->opponent2_a = i+2000;
+	ans->opponent2_d = i+3000;
 #endif
 
 #else
 	/* fill answer structure */
-	ans.hdr.cmd = BT_BEACON_STATUS_ANS;
-	ans.opponent1_x = opponent1_x;
-	ans.opponent1_y = opponent1_y;
-	ans.opponent1_a = opponent1_angle;
-	ans.opponent1_d = opponent1_dist;
+	ans->hdr.cmd = BT_BEACON_STATUS_ANS;
+	ans->opponent1_x = opponent1_x;
+	ans->opponent1_y = opponent1_y;
+	ans->opponent1_a = opponent1_angle;
+	ans->opponent1_d = opponent1_dist;
 
 #ifdef TWO_OPPONENTS
-	ans.opponent2_x = opponent2_x;
-	ans.opponent2_y = opponent2_y;
-	ans.opponent2_a = opponent2_angle;
-	ans.opponent2_d = opponent2_dist;
+	ans->opponent2_x = opponent2_x;
+	ans->opponent2_y = opponent2_y;
+	ans->opponent2_a = opponent2_angle;
+	ans->opponent2_d = opponent2_dist;
 #endif
 
 #ifdef ROBOT_2ND
-	ans.robot_2nd_x = robot_2nd_x;
-	ans.robot_2nd_y = robot_2nd_y;
-	ans.robot_2nd_a = robot_2nd_angle;
-	ans.robot_2nd_d = robot_2nd_dist;
+	ans->robot_2nd_x = robot_2nd_x;
+	ans->robot_2nd_y = robot_2nd_y;
+	ans->robot_2nd_a = robot_2nd_angle;
+	ans->robot_2nd_d = robot_2nd_dist;
+#endif
+
+#endif
+
+	/* age of captures, mainboard gets the capture time from it */
+	now = time_get_us2();
+	ans->opponent1_age = bt_age_ms(now - opponent1_time_us);
+#ifdef TWO_OPPONENTS
+	ans->opponent2_age = bt_age_ms(now - opponent2_time_us);
 #endif
 
+	ans->seq = status_seq;
+	ans->reserved = 0;
+	ans->checksum = bt_checksum ((uint8_t *)ans, sizeof (*ans)-sizeof(ans->checksum));
+}
+
+/* send a status frame to mainboard */
+static void beacon_status_send (struct bt_beacon_status_ans *ans)
+{
+	uint8_t sync_header[] = BT_BEACON_SYNC_HEADER;
+
+	uart_send_buffer (sync_header, sizeof(sync_header)); 
+	uart_send_buffer ((uint8_t*) ans, sizeof(*ans)); 
+
+	status_seq ++;
+	status_push.time_us = time_get_us2();
+	status_push.opponent1_x = ans->opponent1_x;
+	status_push.opponent1_y = ans->opponent1_y;
+#ifdef TWO_OPPONENTS
+	status_push.opponent2_x = ans->opponent2_x;
+	status_push.opponent2_y = ans->opponent2_y;
 #endif
+}
+
+/* push the status if it's time or if opponents have moved,
+ * called from cmdline loop */
+void beacon_status_push (void)
+{
+	struct bt_beacon_status_ans ans;
+	uint32_t elapsed_ms;
+	uint16_t moved_mm;
 
-	ans.checksum = bt_checksum ((uint8_t *)&ans, sizeof (ans)-sizeof(ans.checksum));
+	if (status_push.period_ms == 0)
+		return;
+
+	elapsed_ms = (time_get_us2() - status_push.time_us) / 1000L;
+	if (elapsed_ms < BT_STATUS_PUSH_MIN_MS)
+		return;
+
+	beacon_status_fill (&ans);
+
+	moved_mm = ABS(ans.opponent1_x - status_push.opponent1_x) +
+				ABS(ans.opponent1_y - status_push.opponent1_y);
+#ifdef TWO_OPPONENTS
+	moved_mm = MAX(moved_mm, ABS(ans.opponent2_x - status_push.opponent2_x) +
+							 ABS(ans.opponent2_y - status_push.opponent2_y));
+#endif
+
+	if (bt_status_push_test (elapsed_ms, status_push.period_ms,
+	                         moved_mm, status_push.min_mm))
+		beacon_status_send (&ans);
+}
+
+/* function called when cmd_opponent is parsed successfully */
+static void cmd_opponent_parsed(void * parsed_result, void *data)
+{
+	struct cmd_opponent_result *res = parsed_result;
+	uint8_t flags;
+	struct bt_beacon_status_ans ans;
+
+	/* reset watchdog */
+	beaconboard.watchdog = WATCHDOG_NB_TIMES;
+
+	/* test checksum */
+	if (!strcmp_P(res->arg0, PSTR("opponent")))
+		res->checksum = (uint16_t) (res->robot_x + res->robot_y + res->robot_a);
+	else {
+
+		if (res->checksum != (uint16_t)(res->robot_x + res->robot_y + res->robot_a)) {
+			ERROR (E_USER_BEACON, "checksum ERROR");
+			return;
+		}
+	}
+
+	/* get robot position */
+	IRQ_LOCK(flags);
+	beacon.robot_x = (int32_t)res->robot_x;
+	beacon.robot_y = (int32_t)res->robot_y;
+	beacon.robot_a = (int32_t)res->robot_a;
+	IRQ_UNLOCK(flags);
+
+	/* in push mode status is sent by beacon_status_push() */
+	if (status_push.period_ms && strcmp_P(res->arg0, PSTR("opponent")))
+		return;
+
+	beacon_status_fill (&ans);
 
 	/* send answer */
 	if (!strcmp_P(res->arg0, PSTR("opponent"))) {
@@ -534,15 +624,10 @@ static void cmd_opponent_parsed(void * parsed_result, void *data)
 					(int16_t)ans.opponent2_a, (int16_t)ans.opponent2_d);
 		printf("cksum %x \n\r", ans.checksum);
 	}
-	else {
-		uint8_t sync_header[] = BT_BEACON_SYNC_HEADER;
-		uart_send_buffer (sync_header, sizeof(sync_header)); 
-		uart_send_buffer ((uint8_t*) &ans, sizeof(ans)); 
-
-	}
+	else
+		beacon_status_send (&ans);
 }
 
-
 prog_char str_opponent_arg0[] = "status#opponent";
 parse_pgm_token_string_t cmd_opponent_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_opponent_result, arg0, str_opponent_arg0);
 parse_pgm_token_num_t cmd_opponent_robot_x = TOKEN_NUM_INITIALIZER(struct cmd_opponent_result, robot_x, INT16);
@@ -565,6 +650,223 @@ parse_pgm_inst_t cmd_opponent = {
 	},
 };
 
+/**********************************************************/
+/* Beacon status push */
+
+/* this structure is filled when cmd_beacon_push is parsed successfully */
+struct cmd_beacon_push_result {
+	fixed_string_t arg0;
+	fixed_string_t arg1;
+	uint16_t period_ms;
+	uint16_t min_mm;
+};
+
+/* function called when cmd_beacon_push is parsed successfully */
+static void cmd_beacon_push_parsed(void *parsed_result, void *data)
+{
+	struct cmd_beacon_push_result *res = (struct cmd_beacon_push_result *) parsed_result;
+
+	status_push.period_ms = res->period_ms;
+	status_push.min_mm = res->min_mm;
+	status_push.time_us = 0;
+
+	printf_P(PSTR("Done\r\n"));
+}
+
+prog_char str_beacon_push_arg0[] = "beacon";
+parse_pgm_token_string_t cmd_beacon_push_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_push_result, arg0, str_beacon_push_arg0);
+prog_char str_beacon_push_arg1[] = "push";
+parse_pgm_token_string_t cmd_beacon_push_arg1 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_push_result, arg1, str_beacon_push_arg1);
+parse_pgm_token_num_t cmd_beacon_push_period_ms = TOKEN_NUM_INITIALIZER(struct cmd_beacon_push_result, period_ms, UINT16);
+parse_pgm_token_num_t cmd_beacon_push_min_mm = TOKEN_NUM_INITIALIZER(struct cmd_beacon_push_result, min_mm, UINT16);
+
+prog_char help_beacon_push[] = "Push status every period_ms or when opponents move min_mm (period_ms 0 is pulling mode)";
+parse_pgm_inst_t cmd_beacon_push = {
+	.f = cmd_beacon_push_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = help_beacon_push,
+	.tokens = {        /* token list, NULL terminated */
+		(prog_void *)&cmd_beacon_push_arg0, 
+		(prog_void *)&cmd_beacon_push_arg1, 
+		(prog_void *)&cmd_beacon_push_period_ms, 
+		(prog_void *)&cmd_beacon_push_min_mm, 
+		NULL,
+	},
+};
+
+/**********************************************************/
+/* Beacon tracking statistics */
+
+/* this structure is filled when cmd_beacon_tracking is parsed successfully */
+struct cmd_beacon_tracking_result {
+	fixed_string_t arg0;
+	fixed_string_t arg1;
+	fixed_string_t arg2;
+};
+
+/* function called when cmd_beacon_tracking is parsed successfully */
+static void cmd_beacon_tracking_parsed(void *parsed_result, void *data)
+{
+#ifdef TWO_OPPONENTS
+	struct cmd_beacon_tracking_result *res = (struct cmd_beacon_tracking_result *) parsed_result;
+	struct beacon_track_stats stats;
+	uint8_t flags, i;
+
+	if (!strcmp_P(res->arg2, PSTR("reset"))) {
+		IRQ_LOCK(flags);
+		memset(&beacon.tracker.stats, 0, sizeof(beacon.tracker.stats));
+		IRQ_UNLOCK(flags);
+		printf_P(PSTR("Done\r\n"));
+		return;
+	}
+
+	IRQ_LOCK(flags);
+	memcpy(&stats, &beacon.tracker.stats, sizeof(stats));
+	IRQ_UNLOCK(flags);
+
+	printf_P(PSTR("fixes %lu, updates %lu, ambiguous %lu, outliers %lu\r\n"),
+		 stats.fixes, stats.updates, stats.ambiguous, stats.outliers);
+	printf_P(PSTR("inits %lu, replaces %lu, lost %lu\r\n"),
+		 stats.inits, stats.replaces, stats.lost);
+
+	for (i = 0; i < BEACON_TRACK_MAX; i++) {
+		printf_P(PSTR("opp%d: valid %d, miss %d, x %ld, y %ld, vx %ld, vy %ld\r\n"),
+			 i+1, beacon.tracker.track[i].valid, beacon.tracker.track[i].miss,
+			 beacon.tracker.track[i].x, beacon.tracker.track[i].y,
+			 beacon.tracker.track[i].vx, beacon.tracker.track[i].vy);
+	}
+#else
+	printf_P(PSTR("no tracking, one opponent\r\n"));
+#endif
+}
+
+prog_char str_beacon_tracking_arg0[] = "beacon";
+parse_pgm_token_string_t cmd_beacon_tracking_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_tracking_result, arg0, str_beacon_tracking_arg0);
+prog_char str_beacon_tracking_arg1[] = "tracking";
+parse_pgm_token_string_t cmd_beacon_tracking_arg1 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_tracking_result, arg1, str_beacon_tracking_arg1);
+prog_char str_beacon_tracking_arg2[] = "show#reset";
+parse_pgm_token_string_t cmd_beacon_tracking_arg2 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_tracking_result, arg2, str_beacon_tracking_arg2);
+
+prog_char help_beacon_tracking[] = "Show/reset opponents association statistics";
+parse_pgm_inst_t cmd_beacon_tracking = {
+	.f = cmd_beacon_tracking_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = help_beacon_tracking,
+	.tokens = {        /* token list, NULL terminated */
+		(prog_void *)&cmd_beacon_tracking_arg0, 
+		(prog_void *)&cmd_beacon_tracking_arg1, 
+		(prog_void *)&cmd_beacon_tracking_arg2, 
+		NULL,
+	},
+};
+
+/**********************************************************/
+/* Beacon pulse width filter */
+
+/* this structure is filled when cmd_beacon_filter is parsed successfully */
+struct cmd_beacon_filter_result {
+	fixed_string_t arg0;
+	fixed_string_t arg1;
+	uint8_t n;
+	uint8_t outlier_pct;
+};
+
+/* function called when cmd_beacon_filter is parsed successfully */
+static void cmd_beacon_filter_parsed(void *parsed_result, void *data)
+{
+	struct cmd_beacon_filter_result *res = (struct cmd_beacon_filter_result *) parsed_result;
+	uint8_t flags, i;
+
+	if (res->n < 1 || res->n > BEACON_FILTER_MAX) {
+		printf_P(PSTR("n must be 1 (no filter) to %d\r\n"), BEACON_FILTER_MAX);
+		return;
+	}
+
+	IRQ_LOCK(flags);
+	for (i = 0; i < IR_SENSOR_MAX; i++) {
+		beacon.filter[i].n = res->n;
+		beacon.filter[i].outlier_pct = res->outlier_pct;
+	}
+	IRQ_UNLOCK(flags);
+
+	printf_P(PSTR("Done\r\n"));
+}
+
+prog_char str_beacon_filter_arg0[] = "beacon";
+parse_pgm_token_string_t cmd_beacon_filter_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_filter_result, arg0, str_beacon_filter_arg0);
+prog_char str_beacon_filter_arg1[] = "filter";
+parse_pgm_token_string_t cmd_beacon_filter_arg1 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_filter_result, arg1, str_beacon_filter_arg1);
+parse_pgm_token_num_t cmd_beacon_filter_n = TOKEN_NUM_INITIALIZER(struct cmd_beacon_filter_result, n, UINT8);
+parse_pgm_token_num_t cmd_beacon_filter_outlier_pct = TOKEN_NUM_INITIALIZER(struct cmd_beacon_filter_result, outlier_pct, UINT8);
+
+prog_char help_beacon_filter[] = "Set pulse width filter, median of n pulses (1 is no filter) and outlier deviation (%)";
+parse_pgm_inst_t cmd_beacon_filter = {
+	.f = cmd_beacon_filter_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = help_beacon_filter,
+	.tokens = {        /* token list, NULL terminated */
+		(prog_void *)&cmd_beacon_filter_arg0, 
+		(prog_void *)&cmd_beacon_filter_arg1, 
+		(prog_void *)&cmd_beacon_filter_n, 
+		(prog_void *)&cmd_beacon_filter_outlier_pct, 
+		NULL,
+	},
+};
+
+/* show */
+/* this structure is filled when cmd_beacon_filter_show is parsed successfully */
+struct cmd_beacon_filter_show_result {
+	fixed_string_t arg0;
+	fixed_string_t arg1;
+	fixed_string_t arg2;
+};
+
+/* function called when cmd_beacon_filter_show is parsed successfully */
+static void cmd_beacon_filter_show_parsed(void *parsed_result, void *data)
+{
+	struct cmd_beacon_filter_show_result *res = (struct cmd_beacon_filter_show_result *) parsed_result;
+	struct beacon_filter_stats stats;
+	uint8_t flags, i;
+
+	if (!strcmp_P(res->arg2, PSTR("reset"))) {
+		IRQ_LOCK(flags);
+		for (i = 0; i < IR_SENSOR_MAX; i++)
+			memset(&beacon.filter[i].stats, 0, sizeof(beacon.filter[i].stats));
+		IRQ_UNLOCK(flags);
+		printf_P(PSTR("Done\r\n"));
+		return;
+	}
+
+	printf_P(PSTR("n %d, outlier %d%%, window %d (0.1 deg)\r\n"),
+		 beacon.filter[0].n, beacon.filter[0].outlier_pct, beacon.filter[0].window);
+
+	for (i = 0; i < IR_SENSOR_MAX; i++) {
+		IRQ_LOCK(flags);
+		memcpy(&stats, &beacon.filter[i].stats, sizeof(stats));
+		IRQ_UNLOCK(flags);
+
+		printf_P(PSTR("s%d: pulses %lu, rejects: range %lu, isolated %lu, outliers %lu\r\n"),
+			 i == IR_SENSOR_180_DEG? 180: 0, stats.pulses,
+			 stats.range, stats.isolated, stats.outliers);
+	}
+}
+
+prog_char str_beacon_filter_show_arg2[] = "show#reset";
+parse_pgm_token_string_t cmd_beacon_filter_show_arg2 = TOKEN_STRING_INITIALIZER(struct cmd_beacon_filter_show_result, arg2, str_beacon_filter_show_arg2);
+
+prog_char help_beacon_filter_show[] = "Show/reset pulse width filter config and rejects of each sensor";
+parse_pgm_inst_t cmd_beacon_filter_show = {
+	.f = cmd_beacon_filter_show_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = help_beacon_filter_show,
+	.tokens = {        /* token list, NULL terminated */
+		(prog_void *)&cmd_beacon_filter_arg0, 
+		(prog_void *)&cmd_beacon_filter_arg1, 
+		(prog_void *)&cmd_beacon_filter_show_arg2, 
+		NULL,
+	},
+};
+
 /**********************************************************/
 /* Test */
 
@@ -54,6 +54,7 @@
 #include "main.h"
 #include "cmdline.h"
 #include "sensor.h"
+#include "../common/log_ring.h"
 
 /**********************************************************/
 /* Reset */
@@ -312,6 +313,7 @@ static void cmd_log_do_show(void)
 {
 	uint8_t i, empty=1;
 	const prog_char * name;
+	struct log_ring_stats st;
 
 	printf_P(PSTR("log level is %d\r\n"), beaconboard.log_level);
 	for (i=0; i<NB_LOGS; i++) {
@@ -323,6 +325,12 @@ static void cmd_log_do_show(void)
 	}
 	if (empty)
 		printf_P(PSTR("no log configured\r\n"));
+
+	log_ring_get_stats(&st);
+	printf_P(PSTR("log mode is %s, %ld logs, %ld dropped, max %d bytes\r\n"),
+		 log_ring_get_mode() == LOG_MODE_SYNC? "sync":
+		 log_ring_get_mode() == LOG_MODE_TEXT? "text": "binary",
+		 (long)st.logs, (long)st.drops, st.used_max);
 }
 
 /* function called when cmd_log is parsed successfully */
@@ -447,5 +455,43 @@ parse_pgm_inst_t cmd_log_type = {
 	},
 };
 
+/* this structure is filled when cmd_log_mode is parsed successfully */
+struct cmd_log_mode_result {
+	fixed_string_t arg0;
+	fixed_string_t arg1;
+	fixed_string_t arg2;
+};
+
+/* function called when cmd_log_mode is parsed successfully */
+static void cmd_log_mode_parsed(void * parsed_result, void * data)
+{
+	struct cmd_log_mode_result *res = (struct cmd_log_mode_result *) parsed_result;
+
+	if (!strcmp_P(res->arg2, PSTR("sync")))
+		log_ring_set_mode(LOG_MODE_SYNC);
+	else if (!strcmp_P(res->arg2, PSTR("text")))
+		log_ring_set_mode(LOG_MODE_TEXT);
+	else if (!strcmp_P(res->arg2, PSTR("binary")))
+		log_ring_set_mode(LOG_MODE_BINARY);
+}
+
+prog_char str_log_arg1_mode[] = "mode";
+parse_pgm_token_string_t cmd_log_arg1_mode = TOKEN_STRING_INITIALIZER(struct cmd_log_mode_result, arg1, str_log_arg1_mode);
+prog_char str_log_arg2_mode[] = "sync#text#binary";
+parse_pgm_token_string_t cmd_log_arg2_mode = TOKEN_STRING_INITIALIZER(struct cmd_log_mode_result, arg2, str_log_arg2_mode);
+
+prog_char help_log_mode[] = "Set log mode: sync (printed in mylog), text or binary (deferred)";
+parse_pgm_inst_t cmd_log_mode = {
+	.f = cmd_log_mode_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = help_log_mode,
+	.tokens = {        /* token list, NULL terminated */
+		(prog_void *)&cmd_log_arg0,
+		(prog_void *)&cmd_log_arg1_mode,
+		(prog_void *)&cmd_log_arg2_mode,
+		NULL,
+	},
+};
+
 
 
@@ -174,6 +174,7 @@ int main(void)
 	error_register_warning(mylog);
 	error_register_notice(mylog);
 	error_register_debug(mylog);
+	mylog_init();
 
 	/* ENCODERS */
 	encoders_dspic_init();
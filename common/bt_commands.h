@@ -28,17 +28,53 @@ struct bt_beacon_status_ans
 	int16_t opponent1_y;
 	int16_t opponent1_a;
 	int16_t opponent1_d;
+	uint16_t opponent1_age;		/* ms from capture to frame sent */
 
 #ifdef TWO_OPPONENTS
 	int16_t opponent2_x;
 	int16_t opponent2_y;
 	int16_t opponent2_a;
 	int16_t opponent2_d;
+	uint16_t opponent2_age;
 #endif
 
+	/* status frame sequence number */
+	uint8_t seq;
+	uint8_t reserved;
+
   	uint16_t checksum;
 } __attribute__ ((aligned (2)));
 
+/************************************************************
+ * STATUS PUSH MODE
+ ***********************************************************/
+
+/* In pulling mode the mainboard requests the status of the devices
+ * every cycle. In push mode the devices send their status when it
+ * changes more than min_mm, at least every period_ms and never faster
+ * than BT_STATUS_PUSH_MIN_MS. The mainboard keeps sending its position
+ * but the devices do not answer to it. A period_ms of 0 is pulling mode.
+ */
+#define BT_STATUS_PUSH_MIN_MS	20
+
+/* age of a capture in ms, saturated to the frame field */
+#define BT_AGE_MAX	0xFFFF
+static inline uint16_t bt_age_ms(uint32_t elapsed_us)
+{
+	elapsed_us /= 1000L;
+	return (elapsed_us > BT_AGE_MAX ? BT_AGE_MAX : (uint16_t)elapsed_us);
+}
+
+/* return 1 if a status has to be pushed */
+static inline uint8_t bt_status_push_test(uint32_t elapsed_ms, uint16_t period_ms,
+                                          uint16_t moved_mm, uint16_t min_mm)
+{
+	if (period_ms == 0 || elapsed_ms < BT_STATUS_PUSH_MIN_MS)
+		return 0;
+
+	return (elapsed_ms >= period_ms || moved_mm >= min_mm);
+}
+
 /************************************************************
  * ROBOT_2ND COMMANDS 
  ***********************************************************/
@@ -64,6 +100,11 @@ struct bt_robot_2nd_status_ans
 #define BT_OPP_FIRES_DONE	2
 #define BT_FRESCO_DONE		4
 
+	/* status frame sequence number and sequence number of
+	   the last binary command received, for the ack of cmd_ret */
+	uint8_t seq;
+	uint8_t cmd_seq;
+
 	/* robot position */
 	int16_t x;
 	int16_t y;
@@ -92,6 +133,146 @@ inline uint16_t bt_checksum(uint8_t *data, uint16_t length) {
   return sum;
 }
 
+/************************************************************
+ * ROBOT_2ND BINARY COMMANDS (mainboard --> robot_2nd)
+ ***********************************************************/
+
+/* command ids */
+#define BT_SET_COLOR					1	/* arg0 color */
+#define BT_AUTOPOS						2
+#define BT_GOTO_XY_ABS					3	/* arg0 x, arg1 y */
+#define BT_GOTO_XY_REL					4	/* arg0 x, arg1 y */
+#define BT_GOTO_AVOID					5
+#define BT_GOTO_AVOID_FW				6
+#define BT_GOTO_AVOID_BW				7
+#define BT_FRESCO						8
+#define BT_PATROL						9 	/* x1, y1, x2, y2 */
+#define BT_PATROL_FRESCO_MAMOOTH		10 	/* balls mamooth 1 and 2 */
+#define BT_MAMOOTH						11 	/* balls mamooth 1 and 2 */
+#define BT_NET							12
+#define BT_PROTECT_HEART				14 	/* arg0 heart */
+#define BT_GOTO_FW_XY_ABS				15
+#define BT_GOTO_BW_XY_ABS				16
+#define BT_STATUS_PUSH					17	/* arg0 period_ms, arg1 min_mm */
+
+/* sync header starts with ESC, so the cmdline of robot_2nd can hold
+ * the bytes of a frame and pass the rest to rdline */
+#define BT_ROBOT_2ND_CMD_SYNC_HEADER	"\x1b" "cmd"
+#define BT_ROBOT_2ND_CMD				0x03
+#define BT_ROBOT_2ND_CMD_ARGS_MAX		4
+struct bt_robot_2nd_cmd
+{
+	struct bt_cmd_hdr hdr;
+
+	uint8_t cmd_id;
+	uint8_t seq;		/* echoed in the status as cmd_seq */
+	int16_t arg[BT_ROBOT_2ND_CMD_ARGS_MAX];
+
+	uint16_t checksum;
+} __attribute__ ((aligned (2)));
+
+/* size of the sync header plus command */
+#define BT_ROBOT_2ND_CMD_FRAME_SIZE	\
+	(sizeof(BT_ROBOT_2ND_CMD_SYNC_HEADER) + sizeof(struct bt_robot_2nd_cmd))
+
+/* fill buf with the frame of a command, return the frame size */
+static inline uint8_t bt_robot_2nd_cmd_encode(uint8_t *buf, uint8_t cmd_id,
+                                              uint8_t seq, int16_t arg0, int16_t arg1,
+                                              int16_t arg2, int16_t arg3)
+{
+	uint8_t sync_header[] = BT_ROBOT_2ND_CMD_SYNC_HEADER;
+	struct bt_robot_2nd_cmd cmd;
+	uint8_t *data = (uint8_t *)&cmd;
+	uint8_t i, n = 0;
+
+	cmd.hdr.cmd = BT_ROBOT_2ND_CMD;
+	cmd.cmd_id = cmd_id;
+	cmd.seq = seq;
+	cmd.arg[0] = arg0;
+	cmd.arg[1] = arg1;
+	cmd.arg[2] = arg2;
+	cmd.arg[3] = arg3;
+	cmd.checksum = bt_checksum(data, sizeof(cmd)-sizeof(cmd.checksum));
+
+	for (i=0; i<sizeof(sync_header); i++)
+		buf[n++] = sync_header[i];
+	for (i=0; i<sizeof(cmd); i++)
+		buf[n++] = data[i];
+
+	return n;
+}
+
+struct bt_robot_2nd_cmd_parser
+{
+	uint8_t state;
+	uint8_t i;
+	uint8_t lost;	/* sync header bytes held that were not a frame */
+	struct bt_robot_2nd_cmd cmd;
+};
+
+/* parse a command frame byte by byte. Return BT_CMD_PARSE_NONE if c is
+ * not part of a frame, BT_CMD_PARSE_HOLD if it is, BT_CMD_PARSE_DONE when
+ * p->cmd is a valid command and BT_CMD_PARSE_ERROR on checksum error.
+ * When p->lost is not 0, the first p->lost bytes of the sync header
+ * were held but are not a frame, they are given back to the caller
+ * before c. */
+#define BT_CMD_PARSE_NONE	0
+#define BT_CMD_PARSE_HOLD	1
+#define BT_CMD_PARSE_DONE	2
+#define BT_CMD_PARSE_ERROR	3
+
+static inline uint8_t bt_robot_2nd_cmd_parse(struct bt_robot_2nd_cmd_parser *p,
+                                             uint8_t c)
+{
+	uint8_t sync_header[] = BT_ROBOT_2ND_CMD_SYNC_HEADER;
+	uint8_t *data = (uint8_t *)&p->cmd;
+
+	p->lost = 0;
+
+	switch (p->state)
+	{
+		case 0:
+			/* sync header */
+			if (c != sync_header[p->i]) {
+				p->lost = p->i;
+				p->i = 0;
+				if (c != sync_header[0])
+					return BT_CMD_PARSE_NONE;
+			}
+
+			p->i++;
+			if (p->i == sizeof(sync_header)) {
+				p->i = 0;
+				p->state ++;
+			}
+			return BT_CMD_PARSE_HOLD;
+
+		case 1:
+			data[p->i++] = c;
+			if (p->i < sizeof(p->cmd))
+				return BT_CMD_PARSE_HOLD;
+
+			p->i = 0;
+			p->state = 0;
+
+			if (p->cmd.hdr.cmd != BT_ROBOT_2ND_CMD ||
+			    p->cmd.checksum != bt_checksum(data, sizeof(p->cmd)-sizeof(p->cmd.checksum)))
+				return BT_CMD_PARSE_ERROR;
+
+			return BT_CMD_PARSE_DONE;
+
+		default:
+			p->i = 0;
+			p->state = 0;
+			return BT_CMD_PARSE_NONE;
+	}
+}
+
+/* wait loops let the host virtual clock go, see maindspic/main.h */
+#ifndef HOST_IDLE
+#define HOST_IDLE()			do { } while (0)
+#endif
+
 #define BT_WAIT_COND_OR_TIMEOUT(cond, timeout)                   \
 ({                                                            \
         microseconds __us = time_get_us2();                   \
@@ -101,6 +282,7 @@ inline uint16_t bt_checksum(uint8_t *data, uint16_t length) {
                         __ret = 0;                            \
                         break;                                \
                 }                                             \
+                HOST_IDLE();                                  \
         }                                                     \
 							      \
         __ret;                                                \
@@ -0,0 +1,466 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#ifndef HOST_VERSION_LOG_TEST
+#include <aversive.h>
+#include <aversive/pgmspace.h>
+#else
+#include "log_host.h"
+#endif
+
+#include "log_ring.h"
+
+#define LOG_SPEC_MAX	12		/* "%-08.3" + "ll" + conversion */
+
+/* length modifiers */
+#define LOG_LEN_INT		0
+#define LOG_LEN_LONG	1
+#define LOG_LEN_LLONG	2
+
+static uint8_t ring[LOG_RING_SIZE];
+static uint16_t ring_head, ring_tail, ring_used;
+
+static const char *fmts[LOG_RING_FMT_MAX];
+static uint8_t nb_fmts;
+static uint8_t fmt_sent[(LOG_RING_FMT_MAX + 7) / 8];
+
+static void (*log_send)(char c);
+static uint8_t log_mode;
+
+static struct log_ring_stats stats;
+static uint32_t drops_sent;
+
+void log_ring_init(void (*send)(char c))
+{
+	log_send = send;
+	log_mode = LOG_MODE_TEXT;
+}
+
+void log_ring_set_mode(uint8_t mode)
+{
+	log_mode = mode;
+
+	/* a new decoder needs all the format strings */
+	memset(fmt_sent, 0, sizeof(fmt_sent));
+}
+
+uint8_t log_ring_get_mode(void)
+{
+	return log_mode;
+}
+
+void log_ring_get_stats(struct log_ring_stats *st)
+{
+	uint8_t flags;
+
+	IRQ_LOCK(flags);
+	memcpy(st, &stats, sizeof(*st));
+	IRQ_UNLOCK(flags);
+}
+
+/* id of a format string, -1 if the table is full */
+static int16_t log_ring_fmt_id(const char *fmt)
+{
+	uint8_t flags, i;
+	int16_t id = -1;
+
+	IRQ_LOCK(flags);
+	for (i = 0; i < nb_fmts; i++) {
+		if (fmts[i] == fmt) {
+			id = i;
+			break;
+		}
+	}
+	if (id < 0 && nb_fmts < LOG_RING_FMT_MAX) {
+		id = nb_fmts;
+		fmts[nb_fmts++] = fmt;
+	}
+	IRQ_UNLOCK(flags);
+
+	return id;
+}
+
+/* next conversion from *p, spec is the conversion without its length
+ * modifier and conversion char ("%-5.2"). Return the conversion char,
+ * or 0 at the end of the format. Literal chars are skipped, see
+ * log_ring_print() */
+static char log_ring_next_spec(const char **p, char *spec, uint8_t *len)
+{
+	const char *s = *p;
+	uint8_t n;
+
+	while (1) {
+		while (*s && *s != '%')
+			s++;
+		if (*s == '\0') {
+			*p = s;
+			return 0;
+		}
+		if (s[1] == '%') {
+			s += 2;
+			continue;
+		}
+		break;
+	}
+
+	n = 0;
+	spec[n++] = *s++;
+	while (*s && strchr("-+ #0123456789.", *s)) {
+		if (n < LOG_SPEC_MAX - 4)
+			spec[n++] = *s;
+		s++;
+	}
+	spec[n] = '\0';
+
+	*len = LOG_LEN_INT;
+	while (*s == 'h' || *s == 'l' || *s == 'z') {
+		if (*s == 'l' && *len < LOG_LEN_LLONG)
+			(*len)++;
+		s++;
+	}
+
+	*p = (*s)? s + 1: s;
+	return *s;
+}
+
+static uint8_t log_ring_put32(uint8_t *buf, uint32_t v)
+{
+	buf[0] = v;
+	buf[1] = v >> 8;
+	buf[2] = v >> 16;
+	buf[3] = v >> 24;
+	return 4;
+}
+
+static uint32_t log_ring_get32(const uint8_t *buf)
+{
+	return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+		((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+int8_t log_ring_vpush(uint8_t err_num, uint8_t severity, const char *fmt,
+		      uint32_t time_us, const int16_t *ctx, uint8_t nb_ctx,
+		      va_list ap)
+{
+	uint8_t rec[LOG_RING_REC_MAX];
+	char spec[LOG_SPEC_MAX];
+	const char *p = fmt, *str;
+	uint8_t flags, len, n, i;
+	int16_t id;
+	uint32_t v;
+	uint64_t v64;
+	float f;
+	char c;
+
+	id = log_ring_fmt_id(fmt);
+	if (id < 0)
+		goto drop;
+
+	if (nb_ctx > LOG_RING_CTX_MAX)
+		nb_ctx = LOG_RING_CTX_MAX;
+
+	rec[0] = id;
+	rec[1] = err_num;
+	rec[2] = severity;
+	rec[3] = nb_ctx;
+	n = 4 + log_ring_put32(&rec[4], time_us);
+	for (i = 0; i < nb_ctx; i++) {
+		rec[n++] = ctx[i];
+		rec[n++] = ctx[i] >> 8;
+	}
+
+	/* raw arguments, the last ones are lost if the record is full */
+	while ((c = log_ring_next_spec(&p, spec, &len)) != 0) {
+
+		if (c == 's') {
+			str = va_arg(ap, const char *);
+			for (i = 0; i < LOG_RING_STR_MAX && str && str[i]; i++);
+			if (n + 1 + i > LOG_RING_REC_MAX)
+				break;
+			rec[n++] = i;
+			if (i)
+				memcpy(&rec[n], str, i);
+			n += i;
+			continue;
+		}
+
+		if (n + (len == LOG_LEN_LLONG? 8: 4) > LOG_RING_REC_MAX)
+			break;
+
+		switch (c) {
+		case 'd': case 'i':
+			if (len == LOG_LEN_LLONG) {
+				v64 = va_arg(ap, long long);
+				n += log_ring_put32(&rec[n], v64);
+				n += log_ring_put32(&rec[n], v64 >> 32);
+				continue;
+			}
+			v = (len == LOG_LEN_LONG)? (uint32_t)va_arg(ap, long):
+				(uint32_t)va_arg(ap, int);
+			break;
+		case 'u': case 'x': case 'X': case 'o': case 'c':
+			if (len == LOG_LEN_LLONG) {
+				v64 = va_arg(ap, unsigned long long);
+				n += log_ring_put32(&rec[n], v64);
+				n += log_ring_put32(&rec[n], v64 >> 32);
+				continue;
+			}
+			v = (len == LOG_LEN_LONG)? (uint32_t)va_arg(ap, unsigned long):
+				(uint32_t)va_arg(ap, unsigned int);
+			break;
+		case 'f': case 'e': case 'g': case 'E': case 'G':
+			f = va_arg(ap, double);
+			memcpy(&v, &f, sizeof(v));
+			break;
+		case 'p':
+			v = (uint32_t)(unsigned long)va_arg(ap, void *);
+			break;
+		default:
+			/* unknown conversion, no argument */
+			continue;
+		}
+		n += log_ring_put32(&rec[n], v);
+	}
+
+	IRQ_LOCK(flags);
+	if (ring_used + n + 1 > LOG_RING_SIZE) {
+		IRQ_UNLOCK(flags);
+		goto drop;
+	}
+
+	ring[ring_head] = n;
+	ring_head = (ring_head + 1) % LOG_RING_SIZE;
+	for (i = 0; i < n; i++) {
+		ring[ring_head] = rec[i];
+		ring_head = (ring_head + 1) % LOG_RING_SIZE;
+	}
+	ring_used += n + 1;
+
+	stats.logs++;
+	if (ring_used > stats.used_max)
+		stats.used_max = ring_used;
+	IRQ_UNLOCK(flags);
+	return 0;
+
+ drop:
+	IRQ_LOCK(flags);
+	stats.drops++;
+	IRQ_UNLOCK(flags);
+	return -1;
+}
+
+static void log_ring_send_frame(uint8_t type, const uint8_t *buf, uint8_t n,
+				const char *str, uint8_t n_str)
+{
+	uint8_t i, sum = 0;
+
+	if (log_send == NULL)
+		return;
+
+	log_send(LOG_FRAME_SYNC);
+	log_send(n + n_str);
+	log_send(type);
+	for (i = 0; i < n; i++) {
+		log_send(buf[i]);
+		sum += buf[i];
+	}
+	for (i = 0; i < n_str; i++) {
+		log_send(str[i]);
+		sum += (uint8_t)str[i];
+	}
+	log_send(sum);
+}
+
+static void log_ring_send_msg(const uint8_t *rec, uint8_t n)
+{
+	uint8_t id = rec[0];
+	size_t len;
+
+	if (!(fmt_sent[id / 8] & (1 << (id % 8)))) {
+		len = strlen(fmts[id]);
+		if (len > 254)
+			len = 254;
+		log_ring_send_frame(LOG_FRAME_FMT, &id, 1, fmts[id], len);
+		fmt_sent[id / 8] |= 1 << (id % 8);
+	}
+	log_ring_send_frame(LOG_FRAME_MSG, rec, n, NULL, 0);
+}
+
+/* expand a stored log, as the former mylog() */
+static void log_ring_print(const uint8_t *rec, uint8_t n)
+{
+	char spec[LOG_SPEC_MAX], str[LOG_RING_STR_MAX + 1];
+	const char *fmt = fmts[rec[0]], *p, *spec_start;
+	uint8_t nb_ctx = rec[3], pos, len, i;
+	uint32_t t_us, v;
+	uint64_t v64;
+	float f;
+	char c;
+
+	t_us = log_ring_get32(&rec[4]);
+	printf_P(PSTR("%ld.%.3ld: "), (long)(t_us / 1000000L), (long)((t_us / 1000L) % 1000L));
+
+	pos = 8;
+	if (nb_ctx) {
+		printf_P(PSTR("("));
+		for (i = 0; i < nb_ctx; i++, pos += 2)
+			printf_P(PSTR("%s%d"), i? ",": "",
+				 (int16_t)(rec[pos] | (rec[pos + 1] << 8)));
+		printf_P(PSTR(") "));
+	}
+
+	p = fmt;
+	while (*p) {
+		/* literal chars up to the next conversion */
+		if (*p != '%' || p[1] == '%') {
+			putchar(*p);
+			p += (*p == '%')? 2: 1;
+			continue;
+		}
+
+		spec_start = p;
+		c = log_ring_next_spec(&p, spec, &len);
+		if (c == 0)
+			break;
+		i = strlen(spec);
+
+		if (c == 's') {
+			if (pos >= n || pos + 1 + rec[pos] > n) {
+				p = spec_start;
+				break;
+			}
+			memcpy(str, &rec[pos + 1], rec[pos]);
+			str[rec[pos]] = '\0';
+			pos += 1 + rec[pos];
+			spec[i] = 's';
+			spec[i + 1] = '\0';
+			printf(spec, str);
+			continue;
+		}
+
+		if (strchr("diuxXocfeEgGp", c) == NULL)
+			continue;
+		if (pos + (len == LOG_LEN_LLONG? 8: 4) > n) {
+			p = spec_start;
+			break;
+		}
+
+		if (len == LOG_LEN_LLONG) {
+			v64 = log_ring_get32(&rec[pos]) |
+				((uint64_t)log_ring_get32(&rec[pos + 4]) << 32);
+			pos += 8;
+			spec[i] = 'l';
+			spec[i + 1] = 'l';
+			spec[i + 2] = c;
+			spec[i + 3] = '\0';
+			printf(spec, v64);
+			continue;
+		}
+
+		v = log_ring_get32(&rec[pos]);
+		pos += 4;
+
+		switch (c) {
+		case 'f': case 'e': case 'g': case 'E': case 'G':
+			memcpy(&f, &v, sizeof(f));
+			spec[i] = c;
+			spec[i + 1] = '\0';
+			printf(spec, (double)f);
+			break;
+		case 'c':
+			spec[i] = c;
+			spec[i + 1] = '\0';
+			printf(spec, (int)v);
+			break;
+		case 'p':
+			printf_P(PSTR("0x%lx"), (unsigned long)v);
+			break;
+		case 'd': case 'i':
+			spec[i] = 'l';
+			spec[i + 1] = c;
+			spec[i + 2] = '\0';
+			printf(spec, (long)(int32_t)v);
+			break;
+		default:
+			spec[i] = 'l';
+			spec[i + 1] = c;
+			spec[i + 2] = '\0';
+			printf(spec, (unsigned long)v);
+			break;
+		}
+	}
+
+	/* arguments lost, the rest of the format as is */
+	if (*p)
+		printf_P(PSTR("%s"), p);
+	printf_P(PSTR("\r\n"));
+}
+
+void log_ring_drain(void)
+{
+	uint8_t rec[LOG_RING_REC_MAX];
+	uint8_t flags, n, i, j;
+	uint32_t drops;
+	uint8_t buf[2];
+
+	for (i = 0; i < LOG_RING_DRAIN_MAX; i++) {
+		IRQ_LOCK(flags);
+		if (ring_used == 0) {
+			IRQ_UNLOCK(flags);
+			break;
+		}
+		n = ring[ring_tail];
+		ring_tail = (ring_tail + 1) % LOG_RING_SIZE;
+		for (j = 0; j < n; j++) {
+			rec[j] = ring[ring_tail];
+			ring_tail = (ring_tail + 1) % LOG_RING_SIZE;
+		}
+		ring_used -= n + 1;
+		IRQ_UNLOCK(flags);
+
+		if (log_mode == LOG_MODE_BINARY)
+			log_ring_send_msg(rec, n);
+		else
+			log_ring_print(rec, n);
+	}
+
+	IRQ_LOCK(flags);
+	drops = stats.drops - drops_sent;
+	drops_sent = stats.drops;
+	IRQ_UNLOCK(flags);
+
+	if (drops == 0)
+		return;
+
+	if (log_mode == LOG_MODE_BINARY) {
+		if (drops > 0xFFFF)
+			drops = 0xFFFF;
+		buf[0] = drops;
+		buf[1] = drops >> 8;
+		log_ring_send_frame(LOG_FRAME_DROP, buf, 2, NULL, 0);
+	}
+	else
+		printf_P(PSTR("%ld logs dropped\r\n"), (long)drops);
+}
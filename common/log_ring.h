@@ -0,0 +1,91 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Deferred logs. mylog() stores the format string id, the raw arguments
+ * and the time of each log in a ring buffer, without formatting. A low
+ * priority event drains it with log_ring_drain(), as text or as binary
+ * frames for maindspic/log_decode.py. Conversions are those of the
+ * aversive logs: d i u x X o c s f e g p, with flags, width, precision
+ * and h l ll modifiers ('*' is not supported). Strings are copied up to
+ * LOG_RING_STR_MAX chars, floats are stored as float.
+ *
+ * Binary frame, little endian:
+ *   LOG_FRAME_SYNC, len, type, payload[len], sum of payload (8 bits)
+ * LOG_FRAME_FMT:  id, format string
+ * LOG_FRAME_MSG:  id, err_num, severity, nb_ctx, time_us (32),
+ *                 ctx (int16 x nb_ctx), arguments
+ * LOG_FRAME_DROP: logs dropped since last frame (16)
+ * LOG_FRAME_TELEM: maindspic telemetry, see maindspic/telemetry.h
+ * Arguments are int32 (or int64 with ll), float, or a length byte and
+ * the chars of a string. The FMT frame of an id is sent before its first
+ * MSG frame, and again after log_ring_set_mode().
+ */
+
+#ifndef _LOG_RING_H_
+#define _LOG_RING_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#define LOG_RING_SIZE		512		/* bytes */
+#define LOG_RING_FMT_MAX	64		/* different format strings */
+#define LOG_RING_REC_MAX	80		/* max bytes of a log */
+#define LOG_RING_STR_MAX	16		/* max chars of a string argument */
+#define LOG_RING_CTX_MAX	3		/* context values, e.g. robot x,y,a */
+#define LOG_RING_DRAIN_MAX	4		/* logs per log_ring_drain() */
+
+#define LOG_FRAME_SYNC		0xA5
+#define LOG_FRAME_FMT		1
+#define LOG_FRAME_MSG		2
+#define LOG_FRAME_DROP		3
+#define LOG_FRAME_TELEM		4
+
+/* modes */
+#define LOG_MODE_SYNC		0		/* not deferred, caller prints */
+#define LOG_MODE_TEXT		1
+#define LOG_MODE_BINARY		2
+
+struct log_ring_stats {
+	uint32_t logs;				/* logs stored */
+	uint32_t drops;				/* ring full */
+	uint16_t used_max;			/* max bytes used */
+};
+
+/* write function of the binary frames, e.g. uart_send() */
+void log_ring_init(void (*send)(char c));
+
+void log_ring_set_mode(uint8_t mode);
+uint8_t log_ring_get_mode(void);
+
+/* store a log, any context. ctx are printed between parenthesis before
+ * the message, nb_ctx up to LOG_RING_CTX_MAX. Return -1 if dropped */
+int8_t log_ring_vpush(uint8_t err_num, uint8_t severity, const char *fmt,
+		      uint32_t time_us, const int16_t *ctx, uint8_t nb_ctx,
+		      va_list ap);
+
+/* send the stored logs, LOG_RING_DRAIN_MAX at most, from a low priority
+ * event or from the main loop */
+void log_ring_drain(void);
+
+void log_ring_get_stats(struct log_ring_stats *st);
+
+#endif
@@ -53,6 +53,41 @@ static uint8_t cmd_data[BT_PROTO_NUM_DEVICES][WT11_MUX_LENGTH_MAX];
 static uint8_t cmd_size[BT_PROTO_NUM_DEVICES] = {0, 0};
 static uint8_t bt_errors_checksum = 0;
 
+/* estimated time from a status frame sent by the beacon to the frame
+   parsed here, it's added to the age of the captures */
+#define BT_LINK_LATENCY_US	10000L
+
+
+/* update the status frames info of a device */
+static void bt_status_update (struct bt_status_info *status, uint8_t seq)
+{
+	uint8_t flags;
+
+	IRQ_LOCK(flags);
+	if (status->count)
+		status->lost += (uint8_t)(seq - status->seq - 1);
+	status->seq = seq;
+	status->count ++;
+	status->time_us = time_get_us2();
+	IRQ_UNLOCK(flags);
+}
+
+/* return the age in ms of the last status frame of a device */
+uint32_t bt_status_age_ms (struct bt_status_info *status)
+{
+	microseconds time_us;
+	uint8_t flags;
+
+	IRQ_LOCK(flags);
+	time_us = status->time_us;
+	IRQ_UNLOCK(flags);
+
+	if (status->count == 0)
+		return BT_STATUS_AGE_NONE;
+
+	return (uint32_t)((time_get_us2() - time_us) / 1000L);
+}
+
 
 /* fill a link id buffer which has to be send */
 uint8_t bt_send_cmd (uint8_t link_id, uint8_t *data, uint16_t size) 
@@ -144,6 +179,17 @@ void bt_beacon_set_off (void) {
   	bt_send_ascii_cmd (beaconboard.link_id, "beacon off");
 }
 
+/* beacon status push mode, period_ms 0 is pulling mode */
+void bt_beacon_set_push (uint16_t period_ms, uint16_t min_mm) {
+	bt_send_ascii_cmd (beaconboard.link_id, "beacon push %u %u", period_ms, min_mm);
+	beaconboard.bt_status.push_period_ms = period_ms;
+}
+
+/* age in ms of the last opponent position received */
+uint32_t bt_beacon_status_age_ms (void) {
+	return bt_status_age_ms (&beaconboard.bt_status);
+}
+
 
 /* request opponent position */
 void bt_beacon_req_status(void)
@@ -220,10 +266,14 @@ void bt_beacon_status_parser (int16_t c)
 		case 2:
 		{
 		   double x, y, a, d;
+			microseconds now;
 
 			if (ans.checksum != bt_checksum(data, sizeof(ans)-sizeof(ans.checksum)))
 				goto error_checksum;
 
+			bt_status_update (&beaconboard.bt_status, ans.seq);
+			now = time_get_us2() - BT_LINK_LATENCY_US;
+
 			/* beacon correction */
 			x = ans.opponent1_x;
 			y = ans.opponent1_y;
@@ -238,6 +288,7 @@ void bt_beacon_status_parser (int16_t c)
 			beaconboard.opponent1_y = (int16_t)y;
 			beaconboard.opponent1_a = (int16_t)(DEG(a) < 0? DEG(a)+360: DEG(a));
 			beaconboard.opponent1_d = (int16_t)d;       
+			beaconboard.opponent1_time_us = now - ans.opponent1_age * 1000L;
 			IRQ_UNLOCK(flags);
 
 
@@ -255,6 +306,7 @@ void bt_beacon_status_parser (int16_t c)
 			beaconboard.opponent2_y = (int16_t)y;
 			beaconboard.opponent2_a = (int16_t)(DEG(a) < 0? DEG(a)+360: DEG(a));
 			beaconboard.opponent2_d = (int16_t)d;       
+			beaconboard.opponent2_time_us = now - ans.opponent2_age * 1000L;
 			IRQ_UNLOCK(flags);
 			#endif
 
@@ -291,87 +343,32 @@ error_checksum:
 
 
 /* send command, and return after received ack */
-void bt_robot_2nd_cmd_no_wait_ack (uint8_t cmd_id, int16_t arg0, int16_t arg1)
+void bt_robot_2nd_cmd_no_wait_ack (uint8_t cmd_id, int16_t arg0, int16_t arg1,
+                                   int16_t arg2, int16_t arg3)
 {
-#define BT_SET_COLOR		1
-#define BT_AUTOPOS			2
-#define BT_GOTO_XY_ABS		3
-#define BT_GOTO_XY_REL		4
-#define BT_GOTO_AVOID		5
-#define BT_GOTO_AVOID_FW	6
-#define BT_GOTO_AVOID_BW	7
-#define BT_FRESCO						8	
-#define BT_PATROL						9 	//4 args (int)
-#define BT_PATROL_FRESCO_MAMOOTH		10 	
-#define BT_MAMOOTH						11 	
-#define BT_NET							12	
-#define BT_DO_OPP_FIRES					13
-#define BT_PROTECT_HEART				14 	
-#define BT_GOTO_FW_XY_ABS				15
-#define BT_GOTO_BW_XY_ABS				16
-
+	uint8_t buff[BT_ROBOT_2ND_CMD_FRAME_SIZE];
+	uint8_t size;
     uint8_t flags;
 	//DEBUG (E_USER_BT_PROTO, "TX cmd: id %d arg0 %d arg1 %d", cmd_id, arg0, arg1);
 
-	/* command id parsing */
-	if (cmd_id == BT_SET_COLOR) {
+	/* command arguments */
+	if (cmd_id == BT_SET_COLOR)
 		arg0 = mainboard.our_color;
 
-		if(arg0 == I2C_COLOR_YELLOW)
-			bt_send_ascii_cmd (robot_2nd.link_id, "color yellow");
-	  	else
-			bt_send_ascii_cmd (robot_2nd.link_id, "color red");
-	}
-
-	else if (cmd_id == BT_AUTOPOS) 
-		bt_send_ascii_cmd (robot_2nd.link_id, "position autoset");
-
-	else if (cmd_id == BT_GOTO_XY_ABS)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_goto xy_abs %d %d %d", arg0, arg1, (arg0 + arg1));
-	else if (cmd_id == BT_GOTO_FW_XY_ABS)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_goto xy_abs_fow %d %d %d", arg0, arg1, (arg0 + arg1));
-	else if (cmd_id == BT_GOTO_BW_XY_ABS)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_goto xy_abs_back %d %d %d", arg0, arg1, (arg0 + arg1));
-	else if (cmd_id == BT_GOTO_XY_REL)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_goto xy_rel %d %d %d", arg0, arg1, (arg0 + arg1));
-
-	else if (cmd_id == BT_FRESCO)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_task fresco");
-
-	else if (cmd_id == BT_PROTECT_HEART)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_task protect_h");
-
-	else if (cmd_id == BT_NET)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_task net");
-
-	else if (cmd_id == BT_MAMOOTH)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_task mamooth %d %d %d", arg0, arg1, (arg0 + arg1));
-
-	else if (cmd_id == BT_PATROL_FRESCO_MAMOOTH){
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_task patrol_fr_mam %d %d %d", arg0, arg1, (arg0 + arg1));
-	}
-	else if (cmd_id == BT_GOTO_AVOID)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_goto avoid %d %d %d", arg0, arg1, (arg0 + arg1));
-	else if (cmd_id == BT_GOTO_AVOID_FW)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_goto avoid_fw %d %d %d", arg0, arg1, (arg0 + arg1)); 
-	else if (cmd_id == BT_GOTO_AVOID_BW)
-		bt_send_ascii_cmd (robot_2nd.link_id, "bt_goto avoid_bw %d %d %d", arg0, arg1, (arg0 + arg1));
-	else if (cmd_id == BT_PATROL)
-	{
-		//bt_send_ascii_cmd (robot_2nd.link_id, "subtraj patrol %d %d %d %d", arg0, arg1, arg2, arg3);
-		//it needs four commands
-	}
-
-
-	/* ACK mechanism */
+	/* ACK mechanism, cmd_ret is taken from the status frames
+	   with the sequence number of this command */
 	IRQ_LOCK (flags);
 	//robot_2nd.cmd_id = cmd_id;
 	//robot_2nd.cmd_args_checksum_send = (uint8_t) (cmd_id + arg0 + arg1);
 	//robot_2nd.cmd_args_checksum_recv = 0;
 	robot_2nd.cmd_ret = 0xFF;
-	robot_2nd.valid_status = 0;
+	robot_2nd.cmd_seq ++;
 	IRQ_UNLOCK (flags);
 
+	/* binary command frame, see bt_commands.h */
+	size = bt_robot_2nd_cmd_encode (buff, cmd_id, robot_2nd.cmd_seq,
+	                                arg0, arg1, arg2, arg3);
+	bt_send_cmd (robot_2nd.link_id, buff, size);
 }
 
 /* return 1 if cmd arguments checksum matches */
@@ -386,14 +383,15 @@ uint8_t bt_robot_2nd_test_ack (void) {
 
 
 /* send command, and return after received ack */
-uint8_t bt_robot_2nd_cmd (uint8_t cmd_id, int16_t arg0, int16_t arg1)
+uint8_t bt_robot_2nd_cmd (uint8_t cmd_id, int16_t arg0, int16_t arg1,
+                          int16_t arg2, int16_t arg3)
 {
 //	uint8_t nb_tries = 3;
 	int8_t ret;
 
 //retry:
 
-	bt_robot_2nd_cmd_no_wait_ack (cmd_id, arg0, arg1);
+	bt_robot_2nd_cmd_no_wait_ack (cmd_id, arg0, arg1, arg2, arg3);
 	DEBUG (E_USER_STRAT, "cmd send");
 
 	/* XXX wait ack */
@@ -428,53 +426,73 @@ uint8_t bt_robot_2nd_wait_end (void)
 
 /* set color */
 inline uint8_t bt_robot_2nd_set_color (void) {
-	return bt_robot_2nd_cmd (BT_SET_COLOR, 0, 0);
+	return bt_robot_2nd_cmd (BT_SET_COLOR, 0, 0, 0, 0);
 }
 
 /* auto set possition */
 inline uint8_t bt_robot_2nd_autopos (void) {
-	return bt_robot_2nd_cmd (BT_AUTOPOS, 0, 0);
+	return bt_robot_2nd_cmd (BT_AUTOPOS, 0, 0, 0, 0);
 }
 
 /* goto xy_abs */
 inline uint8_t bt_robot_2nd_goto_xy_abs (int16_t x, int16_t y) {
-	return bt_robot_2nd_cmd (BT_GOTO_XY_ABS, x, y);
+	return bt_robot_2nd_cmd (BT_GOTO_XY_ABS, x, y, 0, 0);
 }
 /* goto xy_rel */
 inline uint8_t bt_robot_2nd_goto_xy_rel (int16_t x, int16_t y) {
-	return bt_robot_2nd_cmd (BT_GOTO_XY_REL, x, y);
+	return bt_robot_2nd_cmd (BT_GOTO_XY_REL, x, y, 0, 0);
 }
 inline uint8_t bt_robot_2nd_goto_forward_xy_abs (int16_t x, int16_t y) {
-	return bt_robot_2nd_cmd (BT_GOTO_FW_XY_ABS, x, y); 
+	return bt_robot_2nd_cmd (BT_GOTO_FW_XY_ABS, x, y, 0, 0); 
 }
 inline uint8_t bt_robot_2nd_goto_backward_xy_abs (int16_t x, int16_t y) {
-	return bt_robot_2nd_cmd (BT_GOTO_BW_XY_ABS, x, y);
+	return bt_robot_2nd_cmd (BT_GOTO_BW_XY_ABS, x, y, 0, 0);
 }
 
 inline uint8_t bt_robot_2nd_goto_and_avoid (int16_t x, int16_t y) {
-	return bt_robot_2nd_cmd (BT_GOTO_AVOID, x, y);
+	return bt_robot_2nd_cmd (BT_GOTO_AVOID, x, y, 0, 0);
 }
 inline uint8_t bt_robot_2nd_goto_and_avoid_forward (int16_t x, int16_t y) {
-	return bt_robot_2nd_cmd (BT_GOTO_AVOID_FW, x, y);
+	return bt_robot_2nd_cmd (BT_GOTO_AVOID_FW, x, y, 0, 0);
 }
 inline uint8_t bt_robot_2nd_goto_and_avoid_backward(int16_t x, int16_t y) {
-	return bt_robot_2nd_cmd (BT_GOTO_AVOID_BW, x, y);
+	return bt_robot_2nd_cmd (BT_GOTO_AVOID_BW, x, y, 0, 0);
 }
 
 inline uint8_t bt_robot_2nd_bt_task_mamooth (int16_t arg1, int16_t arg2) {
-	return bt_robot_2nd_cmd (BT_MAMOOTH, arg1, arg2);
+	return bt_robot_2nd_cmd (BT_MAMOOTH, arg1, arg2, 0, 0);
 }
 inline uint8_t bt_robot_2nd_bt_patrol_fr_mam(int16_t arg1, int16_t arg2) {
-	return bt_robot_2nd_cmd (BT_PATROL_FRESCO_MAMOOTH, arg1, arg2);
+	return bt_robot_2nd_cmd (BT_PATROL_FRESCO_MAMOOTH, arg1, arg2, 0, 0);
 }
 inline uint8_t bt_robot_2nd_bt_protect_h(uint8_t heart) {
-	return bt_robot_2nd_cmd (BT_PROTECT_HEART, heart,0);
+	return bt_robot_2nd_cmd (BT_PROTECT_HEART, heart, 0, 0, 0);
 }
 inline uint8_t bt_robot_2nd_bt_net() {
-	return bt_robot_2nd_cmd (BT_NET, 0,0);
+	return bt_robot_2nd_cmd (BT_NET, 0, 0, 0, 0);
 }
 inline uint8_t bt_robot_2nd_bt_fresco() {
-	return bt_robot_2nd_cmd (BT_FRESCO, 0,0);
+	return bt_robot_2nd_cmd (BT_FRESCO, 0, 0, 0, 0);
+}
+inline uint8_t bt_robot_2nd_bt_patrol (int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+	return bt_robot_2nd_cmd (BT_PATROL, x1, y1, x2, y2);
+}
+
+/* status push mode, period_ms 0 is pulling mode */
+uint8_t bt_robot_2nd_set_push (uint16_t period_ms, uint16_t min_mm)
+{
+	uint8_t ret;
+
+	ret = bt_robot_2nd_cmd (BT_STATUS_PUSH, period_ms, min_mm, 0, 0);
+	if (ret == 0)
+		robot_2nd.bt_status.push_period_ms = period_ms;
+
+	return ret;
+}
+
+/* age in ms of the last status received */
+uint32_t bt_robot_2nd_status_age_ms (void) {
+	return bt_status_age_ms (&robot_2nd.bt_status);
 }
 
 /* request opponent position */
@@ -515,9 +533,6 @@ void bt_robot_2nd_req_status(void)
 						opp2_x, opp2_y,
 						checksum);
 	wt11_send_mux (robot_2nd.link_id, buff, size);
-
-	if (robot_2nd.valid_status == 0)
-		robot_2nd.valid_status = 1;
 #endif
 
 }
@@ -569,11 +584,10 @@ void bt_robot_2nd_status_parser (int16_t c)
 			//DEBUG (E_USER_BEACON, "RX cmd id %d, args %d, ret %d", 
 			//		ans.cmd_id, ans.cmd_args_checksum, get_err(ans.cmd_ret));
 
-			/* be sure that an status cycle is complete */
-			if (robot_2nd.valid_status == 1)
-				robot_2nd.valid_status = 2;
+			bt_status_update (&robot_2nd.bt_status, ans.seq);
 
-			if (robot_2nd.valid_status == 2) {
+			/* be sure that the status is of the last command sent */
+			if (ans.cmd_seq == robot_2nd.cmd_seq) {
 				IRQ_LOCK(flags);
 				robot_2nd.cmd_ret = ans.cmd_ret;
 				IRQ_UNLOCK(flags);
@@ -726,8 +740,10 @@ void bt_protocol (void * dummy)
 	if (cmd_sent) {
 
 		/* mainly a robot 2nd cmd has been sent right now */
-		/* request status inmediately */
-		bt_robot_2nd_req_status ();
+		/* request status inmediately, in push mode robot 2nd
+		   sends it when the command return value changes */
+		if (robot_2nd.bt_status.push_period_ms == 0)
+			bt_robot_2nd_req_status ();
 
 		/* force beacon pulling next cycle */
 		toggle = 0; 
@@ -736,7 +752,8 @@ void bt_protocol (void * dummy)
 		return;
 	}
 
-  	/* pulling of status */
+  	/* pulling of status, in push mode the devices only
+	   receive our position and send their status by themselves */
 	if((time_get_us2() - pull_time_us > 60000UL)) {
 
 		toggle ^= 1;
@@ -29,6 +29,11 @@
 /* send and receive commands to/from bt devices, periodic dev status pulling */
 void bt_protocol (void * dummy);
 
+/* return the age in ms of the last status frame of a device,
+   BT_STATUS_AGE_NONE if nothing has been received */
+#define BT_STATUS_AGE_NONE	0xFFFFFFFFUL
+uint32_t bt_status_age_ms (struct bt_status_info *status);
+
 
 /************************************************************
  * BEACON COMMANDS 
@@ -46,6 +51,12 @@ void bt_beacon_set_on_watchdog (void);
 /* beacon off*/
 void bt_beacon_set_off (void);
 
+/* beacon status push mode, period_ms 0 is pulling mode */
+void bt_beacon_set_push (uint16_t period_ms, uint16_t min_mm);
+
+/* age in ms of the last opponent position received */
+uint32_t bt_beacon_status_age_ms (void);
+
 /* request opponent position */
 void bt_beacon_req_status(void);
 
@@ -54,10 +65,12 @@ void bt_beacon_req_status(void);
  ***********************************************************/
 
 /* send command, and return after received ack */
-void bt_robot_2nd_cmd_no_wait_ack (uint8_t cmd_id, int16_t arg0, int16_t arg1);
+void bt_robot_2nd_cmd_no_wait_ack (uint8_t cmd_id, int16_t arg0, int16_t arg1,
+                                   int16_t arg2, int16_t arg3);
 
 /* send command, and return after received ack */
-uint8_t bt_robot_2nd_cmd (uint8_t cmd_id, int16_t arg0, int16_t arg1);
+uint8_t bt_robot_2nd_cmd (uint8_t cmd_id, int16_t arg0, int16_t arg1,
+                          int16_t arg2, int16_t arg3);
 
 /* auto set possition */
 uint8_t bt_robot_2nd_autopos (void);
@@ -79,12 +92,19 @@ uint8_t bt_robot_2nd_wait_end (void);
 /* request opponent position */
 void bt_robot_2nd_req_status(void);
 
+/* status push mode, period_ms 0 is pulling mode */
+uint8_t bt_robot_2nd_set_push (uint16_t period_ms, uint16_t min_mm);
+
+/* age in ms of the last status received */
+uint32_t bt_robot_2nd_status_age_ms (void);
+
 
 uint8_t bt_robot_2nd_bt_task_mamooth (int16_t arg1, int16_t arg2);
 uint8_t bt_robot_2nd_bt_patrol_fr_mam(int16_t arg1, int16_t arg2);
 uint8_t bt_robot_2nd_bt_protect_h(uint8_t heart);
 uint8_t bt_robot_2nd_bt_net();
 uint8_t bt_robot_2nd_bt_fresco();
+uint8_t bt_robot_2nd_bt_patrol (int16_t x1, int16_t y1, int16_t x2, int16_t y2);
 uint8_t bt_robot_2nd_autopos (void);
 
 uint8_t bt_robot_2nd_goto_and_avoid (int16_t x, int16_t y);
@@ -49,6 +49,7 @@
 #include "beacon.h"
 #include "cmdline.h"
 #include "strat_base.h"
+#include "../common/log_ring.h"
 
 
 /* see in commands.c for the list of commands. */
@@ -122,6 +123,7 @@ void mylog(struct error * e, ...)
 #endif
 	uint8_t i;
 	time_h tv;
+	int16_t pos[3];
 
 	if (e->severity > ERROR_SEVERITY_ERROR) {
 		if (gen.log_level < e->severity)
@@ -135,6 +137,19 @@ void mylog(struct error * e, ...)
 	}
 
 	va_start(ap, e);
+
+	/* deferred, see mylog_event(). Errors are printed now */
+	if (log_ring_get_mode() != LOG_MODE_SYNC &&
+	    e->severity > ERROR_SEVERITY_ERROR) {
+		pos[0] = position_get_x_s16(&mainboard.pos);
+		pos[1] = position_get_y_s16(&mainboard.pos);
+		pos[2] = position_get_a_deg_s16(&mainboard.pos);
+		log_ring_vpush(e->err_num, e->severity, e->text,
+			       time_get_us2(), pos, 3, ap);
+		va_end(ap);
+		return;
+	}
+
 	tv = time_get_time();
 	printf_P(PSTR("%ld.%.3ld: "), (long int)tv.s, (tv.us/1000UL));
 	
@@ -155,6 +170,17 @@ void mylog(struct error * e, ...)
 #endif
 }
 
+void mylog_init(void)
+{
+	log_ring_init(write_char);
+}
+
+/* send the deferred logs, low priority event */
+void mylog_event(void *dummy)
+{
+	log_ring_drain();
+}
+
 /* user interact */
 int cmdline_interact(void)
 {
@@ -37,6 +37,10 @@ void emergency(char c);
 /* log function */
 void mylog(struct error * e, ...);
 
+/* deferred logs, see ../common/log_ring.h */
+void mylog_init(void);
+void mylog_event(void *dummy);
+
 /* launch cmdline */
 int cmdline_interact(void);
 
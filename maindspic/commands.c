@@ -79,7 +79,9 @@ extern parse_pgm_inst_t cmd_wt11;
 extern parse_pgm_inst_t cmd_log;
 extern parse_pgm_inst_t cmd_log_show;
 extern parse_pgm_inst_t cmd_log_type;
+extern parse_pgm_inst_t cmd_log_mode;
 extern parse_pgm_inst_t cmd_scheduler;
+extern parse_pgm_inst_t cmd_scheduler_profile;
 
 #endif /* COMPILE_COMMANDS_GEN */
 
@@ -123,6 +125,9 @@ extern parse_pgm_inst_t cmd_start;
 extern parse_pgm_inst_t cmd_color;
 extern parse_pgm_inst_t cmd_beacon;
 extern parse_pgm_inst_t cmd_robot_2nd;
+extern parse_pgm_inst_t cmd_bt_push;
+extern parse_pgm_inst_t cmd_telemetry;
+extern parse_pgm_inst_t cmd_telemetry_show;
 extern parse_pgm_inst_t cmd_robot_2nd_goto1;
 extern parse_pgm_inst_t cmd_robot_2nd_goto2;
 extern parse_pgm_inst_t cmd_robot_2nd_bt_task;
@@ -229,7 +234,9 @@ parse_pgm_ctx_t main_ctx[] = {
     (parse_pgm_inst_t *) & cmd_log,
     (parse_pgm_inst_t *) & cmd_log_show,
     (parse_pgm_inst_t *) & cmd_log_type,
+    (parse_pgm_inst_t *) & cmd_log_mode,
     (parse_pgm_inst_t *) & cmd_scheduler,
+    (parse_pgm_inst_t *) & cmd_scheduler_profile,
 
 #endif /* COMPILE_COMMANDS_GEN */
 
@@ -264,6 +271,9 @@ parse_pgm_ctx_t main_ctx[] = {
     (parse_pgm_inst_t *) & cmd_color,
     (parse_pgm_inst_t *) & cmd_beacon,
     (parse_pgm_inst_t *) & cmd_robot_2nd,
+    (parse_pgm_inst_t *) & cmd_bt_push,
+    (parse_pgm_inst_t *) & cmd_telemetry,
+    (parse_pgm_inst_t *) & cmd_telemetry_show,
     (parse_pgm_inst_t *) & cmd_robot_2nd_goto1,
     (parse_pgm_inst_t *) & cmd_robot_2nd_goto2,
 	(parse_pgm_inst_t *) & cmd_robot_2nd_bt_task,
@@ -64,6 +64,8 @@
 #include "cmdline.h"
 #include "sensor.h"
 #include "wt11.h"
+#include "sched_prof.h"
+#include "../common/log_ring.h"
 
 #ifdef HOST_VERSION
 #define COMPILE_COMMANDS_GEN
@@ -215,6 +217,48 @@ parse_pgm_inst_t cmd_scheduler = {
 	},
 };
 
+/**********************************************************/
+/* Scheduler profile */
+
+/* this structure is filled when cmd_scheduler_profile is parsed successfully */
+struct cmd_scheduler_profile_result {
+	fixed_string_t arg0;
+	fixed_string_t arg1;
+	fixed_string_t arg2;
+};
+
+/* function called when cmd_scheduler_profile is parsed successfully */
+static void cmd_scheduler_profile_parsed(void *parsed_result, void *data)
+{
+	struct cmd_scheduler_profile_result *res = parsed_result;
+
+	if (!strcmp_P(res->arg2, PSTR("reset"))) {
+		sched_prof_reset();
+		return;
+	}
+	sched_prof_dump();
+}
+
+prog_char str_scheduler_profile_arg0[] = "scheduler";
+parse_pgm_token_string_t cmd_scheduler_profile_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_scheduler_profile_result, arg0, str_scheduler_profile_arg0);
+prog_char str_scheduler_profile_arg1[] = "profile";
+parse_pgm_token_string_t cmd_scheduler_profile_arg1 = TOKEN_STRING_INITIALIZER(struct cmd_scheduler_profile_result, arg1, str_scheduler_profile_arg1);
+prog_char str_scheduler_profile_arg2[] = "show#reset";
+parse_pgm_token_string_t cmd_scheduler_profile_arg2 = TOKEN_STRING_INITIALIZER(struct cmd_scheduler_profile_result, arg2, str_scheduler_profile_arg2);
+
+prog_char help_scheduler_profile[] = "Show/reset execution times (us) of scheduler events";
+parse_pgm_inst_t cmd_scheduler_profile = {
+	.f = cmd_scheduler_profile_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = help_scheduler_profile,
+	.tokens = {        /* token list, NULL terminated */
+		(prog_void *)&cmd_scheduler_profile_arg0, 
+		(prog_void *)&cmd_scheduler_profile_arg1, 
+		(prog_void *)&cmd_scheduler_profile_arg2, 
+		NULL,
+	},
+};
+
 /**********************************************************/
 /* pwm_servo tests */
 
@@ -639,6 +683,7 @@ static void cmd_log_do_show(void)
 {
 	uint8_t i, empty=1;
 	const prog_char * name;
+	struct log_ring_stats st;
 
 	printf_P(PSTR("log level is %d\r\n"), gen.log_level);
 	for (i=0; i<NB_LOGS; i++) {
@@ -651,6 +696,12 @@ static void cmd_log_do_show(void)
 	if (empty)
 		//printf_P(PSTR("no log configured\r\n"), gen.logs[i]);
 		printf_P(PSTR("no log configured\r\n"));
+
+	log_ring_get_stats(&st);
+	printf_P(PSTR("log mode is %s, %ld logs, %ld dropped, max %d bytes\r\n"),
+		 log_ring_get_mode() == LOG_MODE_SYNC? "sync":
+		 log_ring_get_mode() == LOG_MODE_TEXT? "text": "binary",
+		 (long)st.logs, (long)st.drops, st.used_max);
 }
 
 /* function called when cmd_log is parsed successfully */
@@ -774,4 +825,42 @@ parse_pgm_inst_t cmd_log_type = {
 	},
 };
 
+/* this structure is filled when cmd_log_mode is parsed successfully */
+struct cmd_log_mode_result {
+	fixed_string_t arg0;
+	fixed_string_t arg1;
+	fixed_string_t arg2;
+};
+
+/* function called when cmd_log_mode is parsed successfully */
+static void cmd_log_mode_parsed(void * parsed_result, void * data)
+{
+	struct cmd_log_mode_result *res = (struct cmd_log_mode_result *) parsed_result;
+
+	if (!strcmp_P(res->arg2, PSTR("sync")))
+		log_ring_set_mode(LOG_MODE_SYNC);
+	else if (!strcmp_P(res->arg2, PSTR("text")))
+		log_ring_set_mode(LOG_MODE_TEXT);
+	else if (!strcmp_P(res->arg2, PSTR("binary")))
+		log_ring_set_mode(LOG_MODE_BINARY);
+}
+
+prog_char str_log_arg1_mode[] = "mode";
+parse_pgm_token_string_t cmd_log_arg1_mode = TOKEN_STRING_INITIALIZER(struct cmd_log_mode_result, arg1, str_log_arg1_mode);
+prog_char str_log_arg2_mode[] = "sync#text#binary";
+parse_pgm_token_string_t cmd_log_arg2_mode = TOKEN_STRING_INITIALIZER(struct cmd_log_mode_result, arg2, str_log_arg2_mode);
+
+prog_char help_log_mode[] = "Set log mode: sync (printed in mylog), text or binary (deferred, see log_decode.py)";
+parse_pgm_inst_t cmd_log_mode = {
+	.f = cmd_log_mode_parsed,  /* function to call */
+	.data = NULL,      /* 2nd arg of func */
+	.help_str = help_log_mode,
+	.tokens = {        /* token list, NULL terminated */
+		(prog_void *)&cmd_log_arg0,
+		(prog_void *)&cmd_log_arg1_mode,
+		(prog_void *)&cmd_log_arg2_mode,
+		NULL,
+	},
+};
+
 
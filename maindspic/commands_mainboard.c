@@ -76,6 +76,7 @@
 #include "actuator.h"
 //#include "beacon.h"
 #include "bt_protocol.h"
+#include "telemetry.h"
 #include "robotsim.h"
 #include "strat_base.h"
 #include "strat_avoid.h"
@@ -862,7 +863,11 @@ static void cmd_robot_2nd_parsed(void * parsed_result, void * data)
 				printf ("cmd %d %d %d %d %d\n\r", robot_2nd.cmd_id, robot_2nd.cmd_ret,
 													robot_2nd.cmd_args_checksum_send, 
 													robot_2nd.cmd_args_checksum_recv,
-													robot_2nd.valid_status);
+													robot_2nd.cmd_seq);
+				printf ("status seq %d count %u lost %u age %lu ms%s\n\r",
+						robot_2nd.bt_status.seq, robot_2nd.bt_status.count,
+						robot_2nd.bt_status.lost, bt_robot_2nd_status_age_ms(),
+						robot_2nd.bt_status.push_period_ms? " (push)":"");
 				printf ("color %s\n\r", robot_2nd.color == I2C_COLOR_YELLOW? "yellow":"red");
 				printf ("done_flags 0x%.4X\n\r", robot_2nd.done_flags);
 				printf ("pos abs(%d %d %d) rel(%d %d)\n\r",
@@ -901,6 +906,121 @@ parse_pgm_inst_t cmd_robot_2nd = {
 };
 
 
+/**********************************************************/
+/* BT status push */
+
+/* this structure is filled when cmd_bt_push is parsed successfully */
+struct cmd_bt_push_result
+{
+    fixed_string_t arg0;
+    fixed_string_t arg1;
+    uint16_t period_ms;
+    uint16_t min_mm;
+};
+
+/* function called when cmd_bt_push is parsed successfully */
+static void cmd_bt_push_parsed(void * parsed_result, void * data)
+{
+    struct cmd_bt_push_result *res = parsed_result;
+    struct bt_status_info *status;
+
+    if (!strcmp_P(res->arg0, PSTR("beacon"))) {
+        bt_beacon_set_push(res->period_ms, res->min_mm);
+        status = &beaconboard.bt_status;
+    }
+    else {
+        if (bt_robot_2nd_set_push(res->period_ms, res->min_mm))
+            printf_P(PSTR("bt cmd ERROR\r\n"));
+        status = &robot_2nd.bt_status;
+    }
+
+    printf_P(PSTR("%s mode, seq %d count %u lost %u\r\n"),
+             status->push_period_ms? "push":"pulling",
+             status->seq, status->count, status->lost);
+}
+
+prog_char str_bt_push_arg0[] = "beacon#robot_2nd";
+parse_pgm_token_string_t cmd_bt_push_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_bt_push_result, arg0, str_bt_push_arg0);
+prog_char str_bt_push_arg1[] = "push";
+parse_pgm_token_string_t cmd_bt_push_arg1 = TOKEN_STRING_INITIALIZER(struct cmd_bt_push_result, arg1, str_bt_push_arg1);
+parse_pgm_token_num_t cmd_bt_push_period_ms = TOKEN_NUM_INITIALIZER(struct cmd_bt_push_result, period_ms, UINT16);
+parse_pgm_token_num_t cmd_bt_push_min_mm = TOKEN_NUM_INITIALIZER(struct cmd_bt_push_result, min_mm, UINT16);
+
+prog_char help_bt_push[] = "Status push mode of bt device (period_ms, min_mm), period_ms 0 is pulling mode";
+parse_pgm_inst_t cmd_bt_push = {
+    .f = cmd_bt_push_parsed, /* function to call */
+    .data = NULL, /* 2nd arg of func */
+    .help_str = help_bt_push,
+    .tokens =
+    { /* token list, NULL terminated */
+        (prog_void *) & cmd_bt_push_arg0,
+        (prog_void *) & cmd_bt_push_arg1,
+        (prog_void *) & cmd_bt_push_period_ms,
+        (prog_void *) & cmd_bt_push_min_mm,
+        NULL,
+    },
+};
+
+/**********************************************************/
+/* Telemetry */
+
+/* this structure is filled when cmd_telemetry is parsed successfully */
+struct cmd_telemetry_result
+{
+    fixed_string_t arg0;
+    fixed_string_t arg1;
+    uint16_t period_ms;
+};
+
+/* function called when cmd_telemetry is parsed successfully */
+static void cmd_telemetry_parsed(void * parsed_result, void * data)
+{
+    struct cmd_telemetry_result *res = parsed_result;
+
+    if (data == NULL)
+        telemetry_set_period(res->period_ms);
+
+    printf_P(PSTR("telemetry period %u ms, %lu frames\r\n"),
+             telemetry_get_period(), (unsigned long)telemetry_get_count());
+}
+
+prog_char str_telemetry_arg0[] = "telemetry";
+parse_pgm_token_string_t cmd_telemetry_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_telemetry_result, arg0, str_telemetry_arg0);
+prog_char str_telemetry_arg1[] = "period";
+parse_pgm_token_string_t cmd_telemetry_arg1 = TOKEN_STRING_INITIALIZER(struct cmd_telemetry_result, arg1, str_telemetry_arg1);
+parse_pgm_token_num_t cmd_telemetry_period_ms = TOKEN_NUM_INITIALIZER(struct cmd_telemetry_result, period_ms, UINT16);
+
+prog_char help_telemetry[] = "Telemetry frames period (period_ms), 0 is off, see telemetry.py";
+parse_pgm_inst_t cmd_telemetry = {
+    .f = cmd_telemetry_parsed, /* function to call */
+    .data = NULL, /* 2nd arg of func */
+    .help_str = help_telemetry,
+    .tokens =
+    { /* token list, NULL terminated */
+        (prog_void *) & cmd_telemetry_arg0,
+        (prog_void *) & cmd_telemetry_arg1,
+        (prog_void *) & cmd_telemetry_period_ms,
+        NULL,
+    },
+};
+
+prog_char str_telemetry_arg1_show[] = "show";
+parse_pgm_token_string_t cmd_telemetry_arg1_show = TOKEN_STRING_INITIALIZER(struct cmd_telemetry_result, arg1, str_telemetry_arg1_show);
+
+prog_char help_telemetry_show[] = "Show telemetry period and frames sent";
+parse_pgm_inst_t cmd_telemetry_show = {
+    .f = cmd_telemetry_parsed, /* function to call */
+    .data = (void *)1, /* 2nd arg of func */
+    .help_str = help_telemetry_show,
+    .tokens =
+    { /* token list, NULL terminated */
+        (prog_void *) & cmd_telemetry_arg0,
+        (prog_void *) & cmd_telemetry_arg1_show,
+        NULL,
+    },
+};
+
+
 /**********************************************************/
 /* Robot 2nd goto function */
 
@@ -945,7 +1065,7 @@ static void cmd_robot_2nd_goto_parsed(void * parsed_result, void * data)
     }
     else if (!strcmp_P(res->arg1, PSTR("xy_rel")))
     {
-        //err = bt_robot_2nd_goto_xy_rel(res->arg2, res->arg3);
+        err = bt_robot_2nd_goto_xy_rel(res->arg2, res->arg3);
     }
     else if (!strcmp_P(res->arg1, PSTR("xy_abs")))
     {
@@ -1119,6 +1119,8 @@ static void cmd_strat_conf2_parsed(void *parsed_result, void *data)
         on = 0;
 
     /* contruct here the bit mask */
+    if (!strcmp_P(res->arg1, PSTR("opp_prediction")))
+        bit = CONF_FLAG_OPP_PREDICTION;
 
     if (on)
         strat_infos.conf.flags |= bit;
@@ -1131,7 +1133,7 @@ static void cmd_strat_conf2_parsed(void *parsed_result, void *data)
 
 prog_char str_strat_conf2_arg0[] = "strat_conf";
 parse_pgm_token_string_t cmd_strat_conf2_arg0 = TOKEN_STRING_INITIALIZER(struct cmd_strat_conf2_result, arg0, str_strat_conf2_arg0);
-prog_char str_strat_conf2_arg1[] = "opp_tracking";
+prog_char str_strat_conf2_arg1[] = "opp_tracking#opp_prediction";
 parse_pgm_token_string_t cmd_strat_conf2_arg1 = TOKEN_STRING_INITIALIZER(struct cmd_strat_conf2_result, arg1, str_strat_conf2_arg1);
 prog_char str_strat_conf2_arg2[] = "on#off";
 parse_pgm_token_string_t cmd_strat_conf2_arg2 = TOKEN_STRING_INITIALIZER(struct cmd_strat_conf2_result, arg2, str_strat_conf2_arg2);
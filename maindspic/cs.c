@@ -62,9 +62,46 @@
 #include "strat.h"
 #include "actuator.h"
 #include "i2c_protocol.h"
+#include "sched_prof.h"
+#include "odometry.h"
 
 void dump_cs(const char *name, struct cs *cs);
 
+/* distance imp per mm of the position manager */
+#define POS_IMP_MM	(DIST_IMP_MM * 0.9875567845) //0.983765112); // 0.986923267);
+
+#ifdef POSITION_FIXED
+static struct odometry odo;
+static int16_t odo_x, odo_y, odo_a;		/* last position set */
+
+/* fixed point position_manage(), takes the position_set() of the strat
+ * and gives the result to the position manager for its getters.
+ * The odometry keeps the sub-mm part, but position_set() takes whole mm,
+ * so the double getters are rounded to 1 mm every cycle. It also still
+ * does the soft float conversions of position_set() (double x, y and
+ * angle in rad) each cycle, the gain is the position_manage()
+ * trigonometry only. */
+static void position_manage_fixed(void)
+{
+	struct robot_position *pos = &mainboard.pos;
+
+	if (position_get_x_s16(pos) != odo_x ||
+	    position_get_y_s16(pos) != odo_y ||
+	    position_get_a_deg_s16(pos) != odo_a)
+		odometry_set(&odo, position_get_x_double(pos),
+			     position_get_y_double(pos),
+			     position_get_a_rad_double(pos));
+
+	odometry_update(&odo, rs_get_ext_distance(&mainboard.rs),
+			rs_get_ext_angle(&mainboard.rs));
+
+	odo_x = odometry_get_x_s16(&odo);
+	odo_y = odometry_get_y_s16(&odo);
+	position_set(pos, odo_x, odo_y, odometry_get_a_deg(&odo));
+	odo_a = position_get_a_deg_s16(pos);
+}
+#endif
+
 /* called periodically */
 static void do_cs(void *dummy) 
 {
@@ -111,12 +148,17 @@ static void do_cs(void *dummy)
 	}
 
 	/* position calculus */
+#ifdef POSITION_FIXED
+	if (mainboard.flags & DO_POS)
+		position_manage_fixed();
+#else
 	if ((cpt & 1) && (mainboard.flags & DO_POS)) {
 
 		/* about 1.5ms 
        		 * (worst case without centrifugal force compensation) */
 		position_manage(&mainboard.pos);
 	}
+#endif
 
 	/* blocking detection */
 	if (mainboard.flags & DO_BD) {
@@ -227,10 +269,13 @@ void maindspic_cs_init(void)
 
 	/* POSITION MANAGER */
 	position_init(&mainboard.pos);
-	position_set_physical_params(&mainboard.pos, VIRTUAL_TRACK_MM, DIST_IMP_MM * 0.9875567845); //0.983765112); // 0.986923267);
+	position_set_physical_params(&mainboard.pos, VIRTUAL_TRACK_MM, POS_IMP_MM);
 	position_set_related_robot_system(&mainboard.pos, &mainboard.rs);
 	position_set_centrifugal_coef(&mainboard.pos, 0.0); // 0.000016
 	position_use_ext(&mainboard.pos);
+#ifdef POSITION_FIXED
+	odometry_init(&odo, VIRTUAL_TRACK_MM, POS_IMP_MM);
+#endif
 
 	/* TRAJECTORY MANAGER */
 	trajectory_init(&mainboard.traj, CS_HZ);
@@ -299,7 +344,7 @@ void maindspic_cs_init(void)
 	mainboard.distance.on = 1;
 
 	/* EVENT CS */
-	scheduler_add_periodical_event_priority(do_cs, NULL,
-						EVENT_PERIOD_CS / SCHEDULER_UNIT, EVENT_PRIORITY_CS);
+	sched_prof_add_event("cs", do_cs, NULL,
+			     EVENT_PERIOD_CS / SCHEDULER_UNIT, EVENT_PRIORITY_CS);
 }
 
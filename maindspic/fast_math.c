@@ -0,0 +1,131 @@
+/*  
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ * 
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "fast_math.h"
+
+/* sin() of 0 to 90 deg in 16 steps, Q15 */
+static const int16_t sin_table[] = {
+	0,
+	3211,
+	6392,
+	9512,
+	12539,
+	15446,
+	18204,
+	20787,
+	23170,
+	25330,
+	27245,
+	28898,
+	30273,
+	31357,
+	32138,
+	32610,
+	32767,
+};
+
+/* sin() between 0 and 90 deg */
+static int16_t fast_sin_0_90(int16_t deg)
+{
+	int16_t i, rem;
+
+	i = (deg*16)/90;
+	rem = (deg*16) - (i*90);
+
+	if (rem == 0)
+		return sin_table[i];
+
+	return sin_table[i] + ((int32_t)(sin_table[i+1] - sin_table[i]) * rem) / 90;
+}
+
+int16_t fast_sin(int16_t deg)
+{
+	deg %= 360;
+	
+	if (deg < 0)
+		deg += 360;
+
+	if (deg < 90) 
+		return fast_sin_0_90(deg);
+	else if (deg < 180) 
+		return fast_sin_0_90(180-deg);
+	else if (deg < 270) 
+		return -fast_sin_0_90(deg-180);
+	else
+		return -fast_sin_0_90(360-deg);
+}
+
+int16_t fast_cos(int16_t deg)
+{
+	return fast_sin(90+deg);
+}
+
+int16_t fast_atan2(int16_t y, int16_t x)
+{
+	int32_t ax, ay, z, a;
+
+	ax = labs((int32_t)x);
+	ay = labs((int32_t)y);
+
+	if (ax == 0 && ay == 0)
+		return 0;
+
+	/* first octant, z = tan(a) in Q15 */
+	if (ay <= ax)
+		z = (ay << 15) / ax;
+	else
+		z = (ax << 15) / ay;
+
+	/* atan(z) ~= 45*z + z*(1-z)*(14.02 + 3.80*z) deg, max error
+	 * 0.09 deg. Result in 1/64 deg */
+	a = ((z * (32768 - z)) >> 15) * (897 + ((243 * z) >> 15));
+	a = ((2880 * z) >> 15) + (a >> 15);
+
+	/* back to the right octant */
+	if (ay > ax)
+		a = 90*64 - a;
+	if (x < 0)
+		a = 180*64 - a;
+
+	a = (a + 32) >> 6;
+
+	if (y < 0)
+		a = -a;
+
+	return a;
+}
+
+void fast_rotate(int16_t *x, int16_t *y, int16_t deg)
+{
+	int32_t c, s, tmp_x, tmp_y;
+
+	c = fast_cos(deg);
+	s = fast_sin(deg);
+
+	tmp_x = (*x) * c - (*y) * s;
+	tmp_y = (*x) * s + (*y) * c;
+
+	*x = (tmp_x + 16384) >> 15;
+	*y = (tmp_y + 16384) >> 15;
+}
@@ -0,0 +1,43 @@
+/*  
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ * 
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Integer trigonometry, the dsPIC has no FPU. Angles are in degrees,
+ * sin and cos are in Q15 (32767 = 1.0).
+ */
+
+#ifndef _FAST_MATH_H_
+#define _FAST_MATH_H_
+
+#include <stdint.h>
+
+/* sin and cos in Q15, from a 16 entries table with linear interpolation */
+int16_t fast_sin(int16_t deg);
+int16_t fast_cos(int16_t deg);
+
+/* angle of the vector (x,y) in degrees, between -180 and 180.
+ * Max error is 0.65 deg, most of it from the integer result */
+int16_t fast_atan2(int16_t y, int16_t x);
+
+/* rotate the vector (x,y) by deg degrees */
+void fast_rotate(int16_t *x, int16_t *y, int16_t deg);
+
+#endif
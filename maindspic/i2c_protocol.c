@@ -167,6 +167,7 @@ static void i2cproto_next_state(uint8_t inc)
                         __ret = 0;                            \
                         break;                                \
                 }                                             \
+                HOST_IDLE();                                  \
         }                                                     \
 	if (!__ret)					      					      \
 		DEBUG(E_USER_I2C_PROTO, "%s timeout",     \
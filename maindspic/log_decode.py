@@ -0,0 +1,130 @@
+# Decoder of the binary deferred logs (../common/log_ring.h).
+#
+# With "log mode binary" the boards send their logs as binary frames on
+# the cmdline uart. This expands them back into the text of "log mode
+# text", other bytes (prompt, commands output) are written as they are.
+#
+#   cat /dev/ttyUSB0 > capture.bin
+#   python log_decode.py capture.bin -o match.log
+#
+# Without file reads stdin.
+
+import re, sys, struct, optparse
+
+FRAME_SYNC = 0xA5
+FRAME_FMT = 1
+FRAME_MSG = 2
+FRAME_DROP = 3
+FRAME_TELEM = 4   # telemetry.py, skipped here
+
+# conversion of the C format: flags, width, precision, length, conversion
+SPEC = re.compile(r"%([-+ #0]*)([0-9]*)(\.[0-9]*)?(hh|h|ll|l|z)?([a-zA-Z%])")
+
+def expand(fmt, args):
+    """ text of a C format with the raw arguments of a MSG frame """
+    out = []
+    pos = 0
+    last = 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        prec = prec or ""
+        if conv == "%":
+            out.append("%")
+            continue
+        if conv not in "diuxXocsfeEgGp":
+            continue
+
+        if conv == "s":
+            if pos >= len(args) or pos + 1 + args[pos] > len(args):
+                last = m.start()
+                break
+            n = args[pos]
+            val = args[pos + 1:pos + 1 + n].decode("latin-1")
+            pos += 1 + n
+            out.append(("%" + flags + width + prec + "s") % val)
+            continue
+
+        size = 8 if length == "ll" else 4
+        if pos + size > len(args):
+            last = m.start()
+            break
+        raw = args[pos:pos + size]
+        pos += size
+
+        if conv in "feEgG":
+            val = struct.unpack("<f", raw)[0]
+        elif conv in "di":
+            val = struct.unpack("<q" if size == 8 else "<i", raw)[0]
+        else:
+            val = struct.unpack("<Q" if size == 8 else "<I", raw)[0]
+
+        if conv == "p":
+            out.append("0x%x" % val)
+        elif conv == "u":
+            out.append(("%" + flags + width + prec + "d") % val)
+        else:
+            out.append(("%" + flags + width + prec + conv) % val)
+
+    # all done, or arguments lost and the rest of the format as is
+    out.append(fmt[last:])
+    return "".join(out)
+
+def message(fmts, payload):
+    fmt_id, err_num, severity, nb_ctx, t_us = struct.unpack("<BBBBI", payload[:8])
+    pos = 8
+    ctx = struct.unpack("<%dh" % nb_ctx, payload[pos:pos + 2 * nb_ctx])
+    pos += 2 * nb_ctx
+
+    text = "%d.%.3d: " % (t_us // 1000000, (t_us // 1000) % 1000)
+    if nb_ctx:
+        text += "(" + ",".join("%d" % v for v in ctx) + ") "
+    if fmt_id not in fmts:
+        return text + "<unknown format %d, err %d>" % (fmt_id, err_num)
+    return text + expand(fmts[fmt_id], payload[pos:])
+
+def decode(data, write):
+    """ expand all the frames of data, return the logs decoded """
+    fmts = {}
+    i = 0
+    n = 0
+    text = bytearray()
+    while i < len(data):
+        if data[i] == FRAME_SYNC and i + 3 < len(data):
+            length, ftype = data[i + 1], data[i + 2]
+            end = i + 3 + length
+            if ftype in (FRAME_FMT, FRAME_MSG, FRAME_DROP, FRAME_TELEM) and end < len(data) \
+               and sum(data[i + 3:end]) & 0xFF == data[end]:
+                payload = bytes(data[i + 3:end])
+                if text:
+                    write(text.decode("latin-1"))
+                    text = bytearray()
+                if ftype == FRAME_FMT:
+                    fmts[payload[0]] = payload[1:].decode("latin-1")
+                elif ftype == FRAME_MSG:
+                    write(message(fmts, payload) + "\r\n")
+                    n += 1
+                elif ftype == FRAME_DROP:
+                    write("%d logs dropped\r\n" % struct.unpack("<H", payload)[0])
+                i = end + 1
+                continue
+        text.append(data[i])
+        i += 1
+    if text:
+        write(text.decode("latin-1"))
+    return n
+
+def main():
+    parser = optparse.OptionParser(usage="%prog [options] [file]")
+    parser.add_option("-o", "--output", dest="output",
+                      help="text output file (default stdout)")
+    opts, args = parser.parse_args()
+
+    f = open(args[0], "rb") if args else getattr(sys.stdin, "buffer", sys.stdin)
+    data = bytearray(f.read())
+    out = open(opts.output, "w", newline="") if opts.output else sys.stdout
+    decode(data, out.write)
+
+if __name__ == "__main__":
+    main()
@@ -72,6 +72,8 @@
 #include "bt_protocol.h"
 #include "robotsim.h"
 #include "strat_base.h"
+#include "sched_prof.h"
+#include "telemetry.h"
 
 
 struct genboard gen;
@@ -257,6 +259,7 @@ int main(void)
 	error_register_warning(mylog);
 	error_register_notice(mylog);
 	error_register_debug(mylog);
+	mylog_init();
 
 #ifndef HOST_VERSION
 	/* ENCODERS */
@@ -289,8 +292,14 @@ int main(void)
 	/* SCHEDULER */
 	scheduler_init();
 #ifdef HOST_VERSION
+#ifdef HOST_HEADLESS
+	/* before the clock, that depends on inputs record or replay */
+	robotsim_init();
+	robotsim_clock_init();
+#else
 	hostsim_init();
 	robotsim_init();
+#endif
 #endif
 
 	/* EVENTS OR INIT MODULES THAT INCLUDE EVENTS */
@@ -310,20 +319,29 @@ int main(void)
 
 #ifndef HOST_VERSION
 	/* i2c slaves polling (gpios and slavedspic) */
-	scheduler_add_periodical_event_priority(i2c_poll_slaves, NULL,
-						EVENT_PERIOD_I2C_POLL / SCHEDULER_UNIT, EVENT_PRIORITY_I2C_POLL);
+	sched_prof_add_event("i2c_poll", i2c_poll_slaves, NULL,
+			     EVENT_PERIOD_I2C_POLL / SCHEDULER_UNIT, EVENT_PRIORITY_I2C_POLL);
 
 	/* beacon commnads and polling */
 	//scheduler_add_periodical_event_priority(beacon_protocol, NULL,
 	//				EVENT_PERIOD_BEACON_PULL / SCHEDULER_UNIT, EVENT_PRIORITY_BEACON_POLL);
 #endif
 	/* beacon and robot 2nd commnads and polling */
-	scheduler_add_periodical_event_priority(bt_protocol, NULL,
-					EVENT_PERIOD_BEACON_PULL / SCHEDULER_UNIT, EVENT_PRIORITY_BEACON_POLL);
+	sched_prof_add_event("bt_protocol", bt_protocol, NULL,
+			     EVENT_PERIOD_BEACON_PULL / SCHEDULER_UNIT, EVENT_PRIORITY_BEACON_POLL);
 
 	/* strat-related event */
-	scheduler_add_periodical_event_priority(strat_event, NULL,
-						EVENT_PERIOD_STRAT / SCHEDULER_UNIT, EVENT_PRIORITY_STRAT);
+	sched_prof_add_event("strat", strat_event, NULL,
+			     EVENT_PERIOD_STRAT / SCHEDULER_UNIT, EVENT_PRIORITY_STRAT);
+
+	/* deferred logs */
+	sched_prof_add_event("log", mylog_event, NULL,
+			     EVENT_PERIOD_LOG / SCHEDULER_UNIT, EVENT_PRIORITY_LOG);
+
+	/* match telemetry, same priority as the logs to not mix frames */
+	telemetry_init();
+	sched_prof_add_event("telemetry", telemetry_event, NULL,
+			     EVENT_PERIOD_TELEMETRY / SCHEDULER_UNIT, EVENT_PRIORITY_LOG);
 
 	/* log setup */
  	gen.logs[0] = E_USER_STRAT;
@@ -340,8 +358,10 @@ int main(void)
 	/* enable interrupts */
 	sei();
 
+#ifndef HOST_HEADLESS
 	/* wait to init of slavedspic */
 	wait_ms(2000);
+#endif
 	
 	/* say hello */
 	printf("\r\n");
@@ -353,6 +373,14 @@ int main(void)
 	//strat_event_enable();
 #endif
 
+#ifdef HOST_HEADLESS
+	/* play a match on virtual time and exit */
+	strat_start();
+	robotsim_match_record();
+	sched_prof_dump();
+	return 0;
+#endif
+
 	/* program WT-11 */
 #if 0
 	time_wait_ms (1000);
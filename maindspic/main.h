@@ -50,6 +50,10 @@
 #define TWO_OPPONENTS
 #define ROBOT_2ND
 
+/* position in fixed point each cs cycle, see odometry.h.
+ * Comment it to use position_manage() every other cycle */
+#define POSITION_FIXED
+
 /* uart 0 is for cmds and uart 1 is 
  * multiplexed between beacon and slavedspic */
 #define CMDLINE_UART 	0
@@ -182,6 +186,7 @@
 #define EVENT_PRIORITY_CS             100
 #define EVENT_PRIORITY_STRAT          30
 #define EVENT_PRIORITY_BEACON_POLL    20
+#define EVENT_PRIORITY_LOG            10
 
 #endif
 
@@ -192,6 +197,8 @@
 #define EVENT_PERIOD_SENSORS		10000L
 #define EVENT_PERIOD_I2C_POLL		8000L
 #define EVENT_PERIOD_CS 			5000L
+#define EVENT_PERIOD_LOG			20000L
+#define EVENT_PERIOD_TELEMETRY		10000L
 
 #define CS_PERIOD   ((EVENT_PERIOD_CS/SCHEDULER_UNIT)*SCHEDULER_UNIT) /* in microsecond */
 #define CS_HZ       (1000000. / CS_PERIOD)
@@ -285,6 +292,16 @@ struct slavedspic
 
 };
 
+/* status frames received from a bt device */
+struct bt_status_info
+{
+	uint8_t seq;				/* sequence number of last frame */
+	uint16_t count;				/* frames received */
+	uint16_t lost;				/* frames lost, from sequence gaps */
+	microseconds time_us;		/* reception time of last frame */
+	uint16_t push_period_ms;	/* push mode period, 0 in pulling mode */
+};
+
 /* state of beaconboard, synchronized through i2c */
 struct beaconboard 
 {
@@ -295,18 +312,23 @@ struct beaconboard
 	uint8_t status;
 	uint8_t color;
 	uint8_t link_id;
+
+	/* status frames */
+	struct bt_status_info bt_status;
 	
 	/* opponent pos */
 	int16_t opponent1_x;
 	int16_t opponent1_y;
 	int16_t opponent1_a;
 	int16_t opponent1_d;
+	microseconds opponent1_time_us;	/* capture time */
 
 #ifdef TWO_OPPONENTS
 	int16_t opponent2_x;
 	int16_t opponent2_y;
 	int16_t opponent2_a;
 	int16_t opponent2_d;
+	microseconds opponent2_time_us;
 #endif
 
 };
@@ -325,7 +347,10 @@ struct robot_2nd
 	uint8_t cmd_args_checksum_send;	/* checksum of arguments sent */
 	uint8_t cmd_args_checksum_recv;	/* checksum received */
 
-	uint8_t valid_status;
+	uint8_t cmd_seq;					/* sequence number of last command */
+
+	/* status frames */
+	struct bt_status_info bt_status;
 
 	/* strat info */
 	uint8_t color;
@@ -398,6 +423,16 @@ static inline void set_uart_mux(uint8_t channel)
 }
 #endif
 
+#ifdef HOST_HEADLESS
+/* wait loops of the main thread let the virtual clock go, see robotsim.c */
+void robotsim_idle(void);
+void robotsim_wait_ms(uint16_t ms);
+#define HOST_IDLE()			robotsim_idle()
+#define time_wait_ms(ms)	robotsim_wait_ms(ms)
+#else
+#define HOST_IDLE()			do { } while (0)
+#endif
+
 #define WAIT_COND_OR_TIMEOUT(cond, timeout)                   \
 ({                                                            \
         microseconds __us = time_get_us2();                   \
@@ -407,6 +442,7 @@ static inline void set_uart_mux(uint8_t channel)
                         __ret = 0;                            \
                         break;                                \
                 }                                             \
+                HOST_IDLE();                                  \
         }                                                     \
 	if (__ret)					      \
 		DEBUG(E_USER_STRAT, "cond is true at line %d",\
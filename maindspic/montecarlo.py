@@ -0,0 +1,134 @@
+# Batch Monte-Carlo match runner.
+#
+# Runs N matches of the headless host simulator (make HL=1) in
+# parallel worker processes, each one with a different ROBOTSIM_SEED,
+# so opponents follow different random trajectories. The MATCH record
+# printed by each simulator at the end of the match is written as one
+# csv line.
+#
+#   python montecarlo.py -n 1000 -j 8 -o results.csv
+#
+# Use the same seeds with and without -P to A/B test the avoidance
+# with opponent motion prediction.
+#
+# The simulator runs on its lockstep virtual clock, so a seed always
+# plays the same match. Before the batch the first seed is played twice
+# and the runner stops if the outputs differ, the results would be noise.
+
+import os, re, sys, subprocess, optparse
+from multiprocessing import Pool
+
+FIELDS = ["seed", "points", "zones", "obstacle", "blocking",
+          "avoid_ms", "time_ms"]
+
+RECORD = re.compile("^MATCH " + " ".join(["%s=([0-9]+)" % f for f in FIELDS]))
+LOCKSTEP = re.compile("^lockstep: ([0-9]+) ticks")
+
+def run_sim(args):
+    binary, seed, opp_nb, predict, timeout = args
+    env = dict(os.environ)
+    env.pop("ROBOTSIM_FREE_CLOCK", None)
+    env["ROBOTSIM_SEED"] = str(seed)
+    env["ROBOTSIM_OPP_NB"] = str(opp_nb)
+    env["ROBOTSIM_OPP_PREDICT"] = str(int(predict))
+
+    cmd = [binary]
+    if timeout:
+        cmd = ["timeout", str(timeout)] + cmd
+
+    p = subprocess.Popen(cmd, env=env, stdout=subprocess.PIPE,
+                         stderr=subprocess.STDOUT, stdin=open(os.devnull))
+    out = p.communicate()[0]
+    if not isinstance(out, str):
+        out = out.decode("latin-1")
+    return out
+
+def sim_output(out):
+    # without the scheduler profile, it's host cpu time
+    lines = []
+    prof = False
+    for line in out.splitlines():
+        if line.startswith("event ") and line.rstrip().endswith("overruns"):
+            prof = True
+        if not prof or LOCKSTEP.match(line):
+            lines.append(line)
+    return lines
+
+def run_match(args):
+    rec = None
+    free = 0
+    for line in run_sim(args).splitlines():
+        m = LOCKSTEP.match(line)
+        if m:
+            free = int(m.group(1))
+        m = RECORD.match(line)
+        if m:
+            rec = [int(v) for v in m.groups()]
+    if rec is None:
+        return None
+    return rec, free
+
+def main():
+    parser = optparse.OptionParser()
+    parser.add_option("-n", dest="matches", type="int", default=100,
+                      help="number of matches")
+    parser.add_option("-j", dest="jobs", type="int", default=4,
+                      help="number of worker processes")
+    parser.add_option("-s", dest="seed", type="int", default=1,
+                      help="seed of the first match")
+    parser.add_option("-p", dest="opp_nb", type="int", default=2,
+                      help="number of opponents")
+    parser.add_option("-P", dest="predict", action="store_true",
+                      default=False,
+                      help="enable opponent motion prediction")
+    parser.add_option("-t", dest="timeout", type="int", default=600,
+                      help="wall clock timeout per match, in seconds")
+    parser.add_option("-b", dest="binary", default="./main",
+                      help="headless simulator binary")
+    parser.add_option("-o", dest="output", default=None,
+                      help="csv output file (default stdout)")
+    (opts, args) = parser.parse_args()
+
+    jobs = [(opts.binary, opts.seed + i, opts.opp_nb, opts.predict,
+             opts.timeout)
+            for i in range(opts.matches)]
+
+    # same seed twice, same output
+    if sim_output(run_sim(jobs[0])) != sim_output(run_sim(jobs[0])):
+        sys.stderr.write("seed %d is not reproducible, check the lockstep "
+                         "line of the simulator\n" % opts.seed)
+        sys.exit(1)
+
+    out = sys.stdout
+    if opts.output:
+        out = open(opts.output, "w")
+    out.write(",".join(FIELDS) + "\n")
+
+    pool = Pool(opts.jobs)
+    done = []
+    failed = 0
+    free = 0
+    for res in pool.imap_unordered(run_match, jobs):
+        if res is None:
+            failed += 1
+            continue
+        rec, ticks = res
+        if ticks:
+            free += 1
+        done.append(rec)
+        out.write(",".join([str(v) for v in rec]) + "\n")
+        out.flush()
+
+    # summary
+    if done:
+        n = float(len(done))
+        sys.stderr.write("%d matches, %d failed\n" % (len(done), failed))
+        if free:
+            sys.stderr.write("  %d matches with ticks out of the strat "
+                             "waits, not reproducible\n" % free)
+        for i, f in enumerate(FIELDS[1:]):
+            sys.stderr.write("  %-10s mean %.1f\n" %
+                             (f, sum([r[i + 1] for r in done]) / n))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,132 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "odometry.h"
+
+/* sin() of 0 to 90 deg in 128 steps, Q15 */
+static const uint16_t odo_sin_table[] = {
+	0, 402, 804, 1206, 1608, 2009, 2411, 2811,
+	3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998,
+	6393, 6787, 7180, 7571, 7962, 8351, 8740, 9127,
+	9512, 9896, 10279, 10660, 11039, 11417, 11793, 12167,
+	12540, 12910, 13279, 13646, 14010, 14373, 14733, 15091,
+	15447, 15800, 16151, 16500, 16846, 17190, 17531, 17869,
+	18205, 18538, 18868, 19195, 19520, 19841, 20160, 20475,
+	20788, 21097, 21403, 21706, 22006, 22302, 22595, 22884,
+	23170, 23453, 23732, 24008, 24279, 24548, 24812, 25073,
+	25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020,
+	27246, 27467, 27684, 27897, 28106, 28311, 28511, 28707,
+	28899, 29086, 29269, 29448, 29622, 29792, 29957, 30118,
+	30274, 30425, 30572, 30715, 30853, 30986, 31114, 31238,
+	31357, 31471, 31581, 31686, 31786, 31881, 31972, 32058,
+	32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568,
+	32610, 32647, 32679, 32706, 32729, 32746, 32758, 32766,
+	32768,
+};
+
+#define ODO_QUARTER		0x40000000UL
+
+/* sin() inside a quarter, r from 0 to ODO_QUARTER */
+static int32_t odometry_sin_0_90(uint32_t r)
+{
+	uint16_t i = r >> 23;
+	int32_t frac = (r >> 7) & 0xFFFF;
+	int32_t s = odo_sin_table[i];
+
+	if (frac == 0)
+		return s;
+	return s + (((odo_sin_table[i + 1] - s) * frac + 0x8000) >> 16);
+}
+
+int32_t odometry_sin(uint32_t a)
+{
+	uint32_t r = a & (ODO_QUARTER - 1);
+
+	switch (a >> 30) {
+	case 0:
+		return odometry_sin_0_90(r);
+	case 1:
+		return odometry_sin_0_90(ODO_QUARTER - r);
+	case 2:
+		return -odometry_sin_0_90(r);
+	default:
+		return -odometry_sin_0_90(ODO_QUARTER - r);
+	}
+}
+
+void odometry_init(struct odometry *odo, double track_mm, double imp_per_mm)
+{
+	double track_imp = track_mm * imp_per_mm;
+
+	memset(odo, 0, sizeof(*odo));
+
+	/* the robot system angle is (right - left) / 2, then the heading
+	 * turns 2 * angle / track_imp rad */
+	odo->angle_k = (int32_t)(4294967296. * (1 << ODO_ANGLE_SHIFT) /
+				 (M_PI * track_imp) + 0.5);
+	odo->dist_k = (int32_t)(8589934592. / imp_per_mm + 0.5);
+}
+
+void odometry_set(struct odometry *odo, double x, double y, double a_rad)
+{
+	double a_turns = a_rad / (2. * M_PI);
+
+	a_turns -= floor(a_turns);
+
+	odo->x = (int32_t)floor(x * 65536. + 0.5);
+	odo->y = (int32_t)floor(y * 65536. + 0.5);
+	odo->a = (uint32_t)(int64_t)(a_turns * 4294967296.);
+	odo->ref_a = odo->a;
+	odo->ref_enc_a = odo->prev_a;
+}
+
+void odometry_update(struct odometry *odo, int32_t enc_d, int32_t enc_a)
+{
+	int32_t delta_d, cos_a, sin_a;
+	int64_t k;
+	uint32_t a, a_mid;
+
+	delta_d = enc_d - odo->prev_d;
+	odo->prev_d = enc_d;
+	odo->prev_a = enc_a;
+
+	a = odo->ref_a + (uint32_t)(((int64_t)(enc_a - odo->ref_enc_a) * odo->angle_k +
+				     (1 << (ODO_ANGLE_SHIFT - 1))) >> ODO_ANGLE_SHIFT);
+
+	/* heading at the middle of the step */
+	a_mid = odo->a + (int32_t)(a - odo->a) / 2;
+	odo->a = a;
+
+	if (delta_d == 0)
+		return;
+
+	cos_a = odometry_sin(a_mid + ODO_QUARTER);
+	sin_a = odometry_sin(a_mid);
+
+	/* imp * Q15 * (2^33 / imp_per_mm) >> 32 is Q16 mm */
+	k = (int64_t)delta_d * odo->dist_k;
+	odo->x += (int32_t)((k * cos_a + 0x80000000LL) >> 32);
+	odo->y += (int32_t)((k * sin_a + 0x80000000LL) >> 32);
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Fixed point odometry, in place of position_manage() that takes about
+ * 1.5 ms in soft float. Inputs are the virtual encoders of the robot
+ * system (distance and angle, in imp), as position_manage() with
+ * position_use_ext(). Doubles are only used by odometry_init() and
+ * odometry_set().
+ *
+ * x, y are Q16 mm, the heading a binary angle (2^32 is a turn) that
+ * wraps by itself. Each step moves along the heading at the middle of
+ * the step, with a 128 steps per quarter sine table. The heading is
+ * computed from the total angle since the last odometry_set(), so it
+ * has no rounding drift.
+ */
+
+#ifndef _ODOMETRY_H_
+#define _ODOMETRY_H_
+
+#include <stdint.h>
+
+#define ODO_ANGLE_SHIFT		12		/* of angle_k, track_imp above 2600 */
+
+struct odometry {
+	/* physical parameters */
+	int32_t angle_k;		/* heading per angle imp, Q12 binary angle */
+	int32_t dist_k;			/* mm per distance imp, 2^33 / imp_per_mm */
+
+	/* virtual encoders at the last update */
+	int32_t prev_d;
+	int32_t prev_a;
+
+	/* heading reference, from odometry_set() */
+	int32_t ref_enc_a;
+	uint32_t ref_a;
+
+	/* position */
+	int32_t x;				/* Q16 mm */
+	int32_t y;
+	uint32_t a;				/* binary angle */
+};
+
+/* same parameters as position_set_physical_params() */
+void odometry_init(struct odometry *odo, double track_mm, double imp_per_mm);
+
+/* set the position, angle in rad, as position_set() */
+void odometry_set(struct odometry *odo, double x, double y, double a_rad);
+
+/* new values of the virtual encoders, once per control cycle */
+void odometry_update(struct odometry *odo, int32_t enc_d, int32_t enc_a);
+
+/* sin of a binary angle, Q15 (32768 is 1.0) */
+int32_t odometry_sin(uint32_t a);
+
+static inline int16_t odometry_get_x_s16(struct odometry *odo)
+{
+	return (odo->x + 0x8000) >> 16;
+}
+
+static inline int16_t odometry_get_y_s16(struct odometry *odo)
+{
+	return (odo->y + 0x8000) >> 16;
+}
+
+/* heading in degrees, between 0 and 360 */
+static inline double odometry_get_a_deg(struct odometry *odo)
+{
+	return odo->a * (360. / 4294967296.);
+}
+
+#endif
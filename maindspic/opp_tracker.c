@@ -0,0 +1,371 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "opp_tracker.h"
+
+/* measurement noise of each source, mm^2. robot 2nd has the error of
+ * its own position and the latency of the status frame */
+#define OPP_R_BEACON		(60L * 60L)
+#define OPP_R_ROBOT_2ND		(100L * 100L)
+
+/* process noise, spectral density of acceleration, mm^2/s^3 */
+#define OPP_Q				500000L
+
+/* initial velocity variance of a new track, (mm/s)^2 */
+#define OPP_P_VV_INIT		(1000L * 1000L)
+
+/* association gate, chi2 of 2 dof at 99% (9.21), Q8 */
+#define OPP_GATE			2358
+
+/* covariance limits, keep the products below in 32 bits */
+#define OPP_P_PP_MAX		(1000L * 1000L)
+#define OPP_P_VV_MAX		(2000L * 2000L)
+
+#define OPP_TRACK_TIMEOUT_US	500000L	/* no measurements, track lost */
+#define OPP_TRACK_MAX_LAG_US	300000L	/* too old measurement */
+#define OPP_TRACK_REPLACE_US	150000L	/* can be replaced by a new track */
+#define OPP_TRACK_DT_MAX_US		800000L	/* longer predictions are clamped */
+#define OPP_TRACK_V_MAX			(1500L << OPP_TRACK_SHIFT)	/* mm/s */
+
+static const int32_t opp_r[OPP_SRC_MAX] = { OPP_R_BEACON, OPP_R_ROBOT_2ND };
+
+static struct opp_track tracks[OPP_TRACK_MAX];
+
+void opp_tracker_init(void)
+{
+	memset(tracks, 0, sizeof(tracks));
+}
+
+/* time in us to Q16 s, up to OPP_TRACK_DT_MAX_US */
+static int32_t opp_dt(int32_t dt_us)
+{
+	if (dt_us > OPP_TRACK_DT_MAX_US)
+		dt_us = OPP_TRACK_DT_MAX_US;
+
+	/* 4295 / 2^16 is 2^16 / 10^6 */
+	return ((dt_us >> 2) * 4295L) >> 14;
+}
+
+/* Q4 mm moved at v (Q4 mm/s) during dt (Q16 s) */
+static int32_t opp_move(int32_t v, int32_t dt)
+{
+	return (v * dt + 0x8000) >> 16;
+}
+
+static uint16_t opp_sqrt(uint32_t v)
+{
+	uint32_t r = 0, b = 1UL << 30;
+
+	while (b > v)
+		b >>= 2;
+	while (b) {
+		if (v >= r + b) {
+			v -= r + b;
+			r = (r >> 1) + b;
+		}
+		else
+			r >>= 1;
+		b >>= 2;
+	}
+	return r;
+}
+
+/* prediction of the position and its variance dt (Q16 s) after the
+ * state, dt can't be negative */
+static void opp_track_predict(const struct opp_track *tr, int32_t dt,
+			      int32_t *x, int32_t *y, int32_t *p_pp)
+{
+	int64_t dt2 = ((int64_t)dt * dt) >> 16;
+	int64_t p;
+
+	*x = tr->x + opp_move(tr->vx, dt);
+	*y = tr->y + opp_move(tr->vy, dt);
+
+	p = tr->p_pp + ((dt * (2 * (int64_t)tr->p_pv +
+			       (((int64_t)tr->p_vv * dt) >> 16))) >> 16) +
+		((OPP_Q / 3 * ((dt2 * dt) >> 16)) >> 16);
+	*p_pp = p > OPP_P_PP_MAX? OPP_P_PP_MAX: (int32_t)p;
+}
+
+/* measurement (Q4 mm) moved to the time of the state when it is older,
+ * with the velocity variance added to the noise. Return -1 if too old */
+static int8_t opp_track_align(const struct opp_track *tr, int32_t dt_us,
+			      int32_t *zx, int32_t *zy, int32_t *r)
+{
+	int32_t dt;
+
+	if (dt_us >= 0)
+		return 0;
+	if (dt_us < -OPP_TRACK_MAX_LAG_US)
+		return -1;
+
+	dt = opp_dt(-dt_us);
+	*zx += opp_move(tr->vx, dt);
+	*zy += opp_move(tr->vy, dt);
+	*r += ((((int64_t)tr->p_vv * dt) >> 16) * dt) >> 16;
+	return 0;
+}
+
+/* normalized squared distance (Q8) from a measurement to a track, -1
+ * if out of the gate */
+static int16_t opp_track_distance(const struct opp_track *tr, uint8_t src,
+				  int16_t mx, int16_t my, uint32_t t_us)
+{
+	int32_t dt_us = (int32_t)(t_us - tr->time_us);
+	int32_t zx = (int32_t)mx << OPP_TRACK_SHIFT;
+	int32_t zy = (int32_t)my << OPP_TRACK_SHIFT;
+	int32_t r = opp_r[src];
+	int32_t x = tr->x, y = tr->y, p_pp = tr->p_pp;
+	int64_t e2;
+	uint32_t s;
+
+	if (!tr->valid || opp_track_align(tr, dt_us, &zx, &zy, &r) < 0)
+		return -1;
+
+	if (dt_us > 0)
+		opp_track_predict(tr, opp_dt(dt_us), &x, &y, &p_pp);
+
+	/* Q8 mm^2, the gate keeps it in 32 bits for the division */
+	e2 = (int64_t)(zx - x) * (zx - x) + (int64_t)(zy - y) * (zy - y);
+	s = p_pp + r;
+	if (e2 > (int64_t)s * OPP_GATE)
+		return -1;
+
+	return (uint32_t)e2 / s;
+}
+
+/* Kalman filter step of a track with a measurement */
+static void opp_track_correct(struct opp_track *tr, uint8_t src,
+			      int16_t mx, int16_t my, uint32_t t_us)
+{
+	int32_t dt_us = (int32_t)(t_us - tr->time_us);
+	int32_t zx = (int32_t)mx << OPP_TRACK_SHIFT;
+	int32_t zy = (int32_t)my << OPP_TRACK_SHIFT;
+	int32_t r = opp_r[src];
+	int32_t dt, k_p, k_v, ex, ey, p_pv;
+	int64_t dt2, p;
+	uint32_t s;
+
+	if (opp_track_align(tr, dt_us, &zx, &zy, &r) < 0)
+		return;
+
+	/* predict */
+	if (dt_us > 0) {
+		dt = opp_dt(dt_us);
+		dt2 = ((int64_t)dt * dt) >> 16;
+		opp_track_predict(tr, dt, &tr->x, &tr->y, &tr->p_pp);
+		tr->p_pv += (((int64_t)tr->p_vv * dt) >> 16) +
+			((OPP_Q / 2 * dt2) >> 16);
+		p = tr->p_vv + ((OPP_Q * (int64_t)dt) >> 16);
+		tr->p_vv = p > OPP_P_VV_MAX? OPP_P_VV_MAX: (int32_t)p;
+		tr->time_us = t_us;
+	}
+
+	/* correct, gains of position Q12 and of velocity Q8 1/s */
+	s = tr->p_pp + r;
+	k_p = ((uint32_t)tr->p_pp << 12) / s;
+	k_v = (tr->p_pv * 256L) / (int32_t)s;
+	ex = zx - tr->x;
+	ey = zy - tr->y;
+
+	tr->x += (k_p * ex + 0x800) >> 12;
+	tr->y += (k_p * ey + 0x800) >> 12;
+	tr->vx += (k_v * ex + 0x80) >> 8;
+	tr->vy += (k_v * ey + 0x80) >> 8;
+
+	p_pv = tr->p_pv;
+	tr->p_vv -= ((int64_t)k_v * p_pv) >> 8;
+	tr->p_pv -= ((int64_t)k_p * p_pv) >> 12;
+	tr->p_pp -= ((int64_t)k_p * tr->p_pp) >> 12;
+
+	if (tr->vx > OPP_TRACK_V_MAX) tr->vx = OPP_TRACK_V_MAX;
+	if (tr->vx < -OPP_TRACK_V_MAX) tr->vx = -OPP_TRACK_V_MAX;
+	if (tr->vy > OPP_TRACK_V_MAX) tr->vy = OPP_TRACK_V_MAX;
+	if (tr->vy < -OPP_TRACK_V_MAX) tr->vy = -OPP_TRACK_V_MAX;
+
+	tr->updates[src]++;
+}
+
+/* start a track from a measurement */
+static void opp_track_new(struct opp_track *tr, uint8_t src,
+			  int16_t mx, int16_t my, uint32_t t_us)
+{
+	memset(tr, 0, sizeof(*tr));
+	tr->valid = 1;
+	tr->x = (int32_t)mx << OPP_TRACK_SHIFT;
+	tr->y = (int32_t)my << OPP_TRACK_SHIFT;
+	tr->p_pp = opp_r[src];
+	tr->p_vv = OPP_P_VV_INIT;
+	tr->time_us = t_us;
+	tr->updates[src] = 1;
+}
+
+/* track lost or without measurements for OPP_TRACK_REPLACE_US, a new
+ * track can be started there */
+static uint8_t opp_track_is_free(const struct opp_track *tr, uint32_t t_us)
+{
+	return !tr->valid ||
+		(int32_t)(t_us - tr->time_us) > OPP_TRACK_REPLACE_US;
+}
+
+/*
+ * Each measurement goes to a track or starts a new one (option
+ * OPP_TRACK_MAX) in a free track, with a cost of OPP_GATE. All the
+ * combinations are tested, there are 9 at most.
+ */
+void opp_tracker_update(uint8_t src, const int16_t *x, const int16_t *y,
+			const uint32_t *t_us, uint8_t n, int8_t *num)
+{
+	int16_t d2[OPP_TRACK_MAX][OPP_TRACK_MAX];
+	int32_t cost, best_cost = -1;
+	uint8_t opt[OPP_TRACK_MAX], best[OPP_TRACK_MAX];
+	uint8_t i, j, nb_free, nb_new, free_tracks = 0, used, best_used = 0, ok;
+
+	if (src >= OPP_SRC_MAX || n == 0)
+		return;
+	if (n > OPP_TRACK_MAX)
+		n = OPP_TRACK_MAX;
+
+	if (num != NULL) {
+		for (i = 0; i < n; i++)
+			num[i] = -1;
+	}
+
+	for (j = 0; j < OPP_TRACK_MAX; j++) {
+		if (opp_track_is_free(&tracks[j], t_us[0]))
+			free_tracks |= (1 << j);
+		for (i = 0; i < n; i++)
+			d2[i][j] = opp_track_distance(&tracks[j], src, x[i], y[i], t_us[i]);
+	}
+
+	/* options of measurement 1 only iterate when there are two */
+	for (opt[0] = 0; opt[0] <= OPP_TRACK_MAX; opt[0]++) {
+		for (opt[1] = 0; opt[1] <= (n > 1? OPP_TRACK_MAX: 0); opt[1]++) {
+
+			cost = 0;
+			used = 0;
+			nb_new = 0;
+			ok = 1;
+
+			for (i = 0; i < n && ok; i++) {
+				if (opt[i] == OPP_TRACK_MAX) {
+					nb_new++;
+					cost += OPP_GATE;
+				}
+				else if (d2[i][opt[i]] < 0 || (used & (1 << opt[i])))
+					ok = 0;
+				else {
+					used |= (1 << opt[i]);
+					cost += d2[i][opt[i]];
+				}
+			}
+
+			if (!ok)
+				continue;
+
+			nb_free = 0;
+			for (j = 0; j < OPP_TRACK_MAX; j++) {
+				if ((free_tracks & ~used) & (1 << j))
+					nb_free++;
+			}
+			if (nb_new > nb_free)
+				continue;
+
+			if (best_cost < 0 || cost < best_cost) {
+				best_cost = cost;
+				best_used = used;
+				memcpy(best, opt, sizeof(best));
+			}
+		}
+	}
+
+	/* nothing possible, all tracks in use and out of the gates */
+	if (best_cost < 0)
+		return;
+
+	for (i = 0; i < n; i++) {
+		if (best[i] < OPP_TRACK_MAX) {
+			j = best[i];
+			opp_track_correct(&tracks[j], src, x[i], y[i], t_us[i]);
+		}
+		else {
+			for (j = 0; j < OPP_TRACK_MAX; j++) {
+				if ((free_tracks & ~best_used) & (1 << j))
+					break;
+			}
+			best_used |= (1 << j);
+			opp_track_new(&tracks[j], src, x[i], y[i], t_us[i]);
+		}
+
+		if (num != NULL)
+			num[i] = j;
+	}
+}
+
+void opp_tracker_manage(uint32_t now_us)
+{
+	uint8_t j;
+
+	for (j = 0; j < OPP_TRACK_MAX; j++) {
+		if (tracks[j].valid &&
+		    (int32_t)(now_us - tracks[j].time_us) > OPP_TRACK_TIMEOUT_US)
+			tracks[j].valid = 0;
+	}
+}
+
+int8_t opp_tracker_get(const struct opp_track *tr, uint32_t t_us,
+		       int16_t *x, int16_t *y, int16_t *vx, int16_t *vy,
+		       uint16_t *sigma)
+{
+	int32_t dt_us, px, py, p_pp;
+
+	if (tr == NULL || !tr->valid)
+		return -1;
+
+	dt_us = (int32_t)(t_us - tr->time_us);
+	if (dt_us < 0)
+		dt_us = 0;
+
+	opp_track_predict(tr, opp_dt(dt_us), &px, &py, &p_pp);
+
+	if (x != NULL)
+		*x = OPP_TRACK_MM(px);
+	if (y != NULL)
+		*y = OPP_TRACK_MM(py);
+	if (vx != NULL)
+		*vx = OPP_TRACK_MM(tr->vx);
+	if (vy != NULL)
+		*vy = OPP_TRACK_MM(tr->vy);
+	if (sigma != NULL)
+		*sigma = opp_sqrt(p_pp);
+
+	return 0;
+}
+
+const struct opp_track *opp_tracker_track(uint8_t num)
+{
+	if (num >= OPP_TRACK_MAX)
+		return NULL;
+	return &tracks[num];
+}
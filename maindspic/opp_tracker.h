@@ -0,0 +1,84 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Opponents tracker. Fuses the opponent positions of the beaconboard
+ * and of the robot 2nd with a constant velocity Kalman filter for each
+ * opponent. Both axes have the same covariance, the measurement noise
+ * is isotropic and depends on the source. Measurements of a source are
+ * associated to the tracks with the assignment of min normalized
+ * distance, so the opponent numbers of each source don't matter.
+ * Times are in us, as time_get_us2().
+ *
+ * It runs in the strat event, so it is all fixed point: positions and
+ * velocities are Q4 mm and mm/s, covariances are integers in mm and s.
+ * An update of two measurements takes 4 distances and 2 filter steps,
+ * with 8 divisions of 32 bits and no 64 bits division.
+ */
+
+#ifndef _OPP_TRACKER_H_
+#define _OPP_TRACKER_H_
+
+#include <stdint.h>
+
+#define OPP_TRACK_MAX		2
+
+#define OPP_TRACK_SHIFT		4		/* fractional bits of x, y, vx, vy */
+#define OPP_TRACK_MM(v)		((int16_t)(((v) + (1 << (OPP_TRACK_SHIFT - 1))) >> OPP_TRACK_SHIFT))
+
+/* sources */
+#define OPP_SRC_BEACON		0
+#define OPP_SRC_ROBOT_2ND	1
+#define OPP_SRC_MAX			2
+
+struct opp_track {
+	uint8_t valid;
+	int32_t x, y;				/* Q4 mm */
+	int32_t vx, vy;				/* Q4 mm/s */
+	int32_t p_pp, p_pv, p_vv;	/* covariance of each axis */
+	uint32_t time_us;			/* time of the state, last measurement */
+	uint16_t updates[OPP_SRC_MAX];	/* measurements of each source */
+};
+
+/* clear all tracks */
+void opp_tracker_init(void);
+
+/* measurements of a source, n up to OPP_TRACK_MAX. Opponents not
+ * there must not be given. The track of each measurement is returned
+ * in num (-1 if dropped), it can be NULL */
+void opp_tracker_update(uint8_t src, const int16_t *x, const int16_t *y,
+			const uint32_t *t_us, uint8_t n, int8_t *num);
+
+/* drop the tracks without measurements for OPP_TRACK_TIMEOUT_US */
+void opp_tracker_manage(uint32_t now_us);
+
+/* get a track predicted at t_us: position, velocity and standard
+ * deviation of position in mm. Any pointer can be NULL. Return -1
+ * if the track is not valid. The tracks are updated in the strat
+ * event, give a copy of the track read with the irqs locked */
+int8_t opp_tracker_get(const struct opp_track *tr, uint32_t t_us,
+		       int16_t *x, int16_t *y, int16_t *vx, int16_t *vy,
+		       uint16_t *sigma);
+
+/* raw track, copy it with the irqs locked out of the strat event */
+const struct opp_track *opp_tracker_track(uint8_t num);
+
+#endif
@@ -22,11 +22,17 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fcntl.h>
 #include <unistd.h>
+#ifdef HOST_HEADLESS
+#include <signal.h>
+#include <sched.h>
+#include <pthread.h>
+#endif
 
 #include <aversive.h>
 #include <aversive/error.h>
@@ -53,6 +59,8 @@
 #include "strat.h"
 #include "strat_utils.h"
 #include "main.h"
+#include "robotsim.h"
+#include "robotsim_rec.h"
 
 uint8_t robotsim_blocking = 0;
 
@@ -60,6 +68,47 @@ static int32_t l_pwm, r_pwm;
 static int32_t l_enc, r_enc;
 
 static int fdr, fdw, fd_btr, fd_btw;
+static int fd_telem = -1;
+
+#ifdef HOST_HEADLESS
+/* virtual clock, number of scheduler ticks served */
+static volatile uint32_t robotsim_ticks = 0;
+
+/* lockstep virtual clock, see robotsim_idle() */
+#define ROBOTSIM_IDLE_TIMEOUT_MS	20
+static uint8_t robotsim_lockstep;
+static volatile uint32_t robotsim_idle_seq;
+static volatile uint32_t robotsim_free_ticks;
+
+/* 
+ * Randomized opponents, replace the opp_1/opp_2 lines of display.py.
+ * Each opponent goes to random waypoints at random speed and stays
+ * there a random time. Environment:
+ *   ROBOTSIM_SEED   match seed (default 1)
+ *   ROBOTSIM_OPP_NB number of opponents, 0 to 2 (default 2)
+ */
+#define OPP_X_MIN		200
+#define OPP_X_MAX		2800
+#define OPP_Y_MIN		200
+#define OPP_Y_MAX		1800
+#define OPP_SPEED_MIN	200		/* mm/s */
+#define OPP_SPEED_MAX	800
+#define OPP_WAIT_MAX	3000	/* ms */
+
+struct robotsim_opp {
+	double x;
+	double y;
+	int16_t dst_x;
+	int16_t dst_y;
+	int16_t speed;
+	int16_t wait_ms;
+};
+
+static struct robotsim_opp robotsim_opp[2];
+static uint8_t robotsim_opp_nb = 2;
+static unsigned int robotsim_seed = 1;
+static unsigned int robotsim_rand_state;
+#endif
 
 /*
  * Debug with GDB:
@@ -87,6 +136,11 @@ void robotsim_dump(void)
 	int len;
 	int16_t x, y, a;
 
+#ifdef HOST_HEADLESS
+	/* nobody is listening */
+	return;
+#endif
+
 	x = position_get_x_s16(&mainboard.pos);
 	y = position_get_y_s16(&mainboard.pos);
 	a = position_get_a_deg_s16(&mainboard.pos);
@@ -257,6 +311,147 @@ static void beacon_update(void)
 #endif
 }
 
+/* set opponent position as seen by beacon, num is 1 or 2 */
+static void robotsim_set_opponent(uint8_t num, int oppx, int oppy)
+{
+	uint8_t flags;
+	double oppa, oppd;
+
+	robotsim_rec_opp(num, oppx, oppy);
+	abs_xy_to_rel_da(oppx, oppy, &oppd, &oppa);
+
+	/* limit to the real range.
+	   event flag and bt link simulation  */
+	if (oppd < 2300 
+		&& (mainboard.flags & DO_BEACON)
+		&& (beaconboard.link_id != 0xFF) ) {
+
+		IRQ_LOCK(flags);
+		if (num == 1) {
+			beaconboard.opponent1_x = oppx;
+			beaconboard.opponent1_y = oppy;
+			beaconboard.opponent1_a = DEG(oppa);
+			if (beaconboard.opponent1_a < 0)
+				beaconboard.opponent1_a += 360;
+			beaconboard.opponent1_d = oppd;
+			beaconboard.opponent1_time_us = time_get_us2();
+		}
+		else {
+			beaconboard.opponent2_x = oppx;
+			beaconboard.opponent2_y = oppy;
+			beaconboard.opponent2_a = DEG(oppa);
+			if (beaconboard.opponent2_a < 0)
+				beaconboard.opponent2_a += 360;
+			beaconboard.opponent2_d = oppd;
+			beaconboard.opponent2_time_us = time_get_us2();
+		}
+		IRQ_UNLOCK(flags);
+	}
+	else {
+		IRQ_LOCK(flags);
+		if (num == 1)
+			beaconboard.opponent1_x = I2C_OPPONENT_NOT_THERE;
+		else
+			beaconboard.opponent2_x = I2C_OPPONENT_NOT_THERE;
+		IRQ_UNLOCK(flags);
+	}
+}
+
+#ifdef HOST_HEADLESS
+/* return a random integer in [min, max] */
+static int robotsim_rand(int min, int max)
+{
+	return min + (rand_r(&robotsim_rand_state) % (max - min + 1));
+}
+
+/* init opponents from environment */
+static void robotsim_opp_init(void)
+{
+	char *env;
+	uint8_t i;
+	int n;
+
+	env = getenv("ROBOTSIM_SEED");
+	if (env)
+		robotsim_seed = strtoul(env, NULL, 0);
+	env = getenv("ROBOTSIM_OPP_NB");
+	if (env) {
+		n = atoi(env);
+		robotsim_opp_nb = n < 0? 0: (n > 2? 2: n);
+	}
+
+	/* A/B test of avoidance with opponent motion prediction */
+	env = getenv("ROBOTSIM_OPP_PREDICT");
+	if (env && atoi(env))
+		strat_infos.conf.flags |= CONF_FLAG_OPP_PREDICTION;
+
+	robotsim_rand_state = robotsim_seed;
+
+	/* start in the opposite start area */
+	for (i = 0; i < 2; i++) {
+		robotsim_opp[i].x = AREA_X - 200;
+		robotsim_opp[i].y = 400 + i * 300;
+		robotsim_opp[i].dst_x = robotsim_opp[i].x;
+		robotsim_opp[i].dst_y = robotsim_opp[i].y;
+		robotsim_opp[i].speed = OPP_SPEED_MIN;
+		robotsim_opp[i].wait_ms = robotsim_rand(0, OPP_WAIT_MAX);
+	}
+}
+
+/* move opponents, called each cs period */
+static void robotsim_opp_update(void)
+{
+	struct robotsim_opp *opp;
+	double dx, dy, d, step;
+	uint8_t i;
+
+	for (i = 0; i < robotsim_opp_nb; i++) {
+		opp = &robotsim_opp[i];
+
+		if (opp->wait_ms > 0) {
+			opp->wait_ms -= CS_PERIOD / 1000;
+		}
+		else {
+			dx = opp->dst_x - opp->x;
+			dy = opp->dst_y - opp->y;
+			d = norm(dx, dy);
+			step = opp->speed * (CS_PERIOD / 1000000.);
+
+			if (d <= step) {
+				/* waypoint reached, choose next one */
+				opp->x = opp->dst_x;
+				opp->y = opp->dst_y;
+				opp->dst_x = robotsim_rand(OPP_X_MIN, OPP_X_MAX);
+				opp->dst_y = robotsim_rand(OPP_Y_MIN, OPP_Y_MAX);
+				opp->speed = robotsim_rand(OPP_SPEED_MIN, OPP_SPEED_MAX);
+				opp->wait_ms = robotsim_rand(0, OPP_WAIT_MAX);
+			}
+			else {
+				opp->x += dx * step / d;
+				opp->y += dy * step / d;
+			}
+		}
+
+		robotsim_set_opponent(i + 1, (int)opp->x, (int)opp->y);
+	}
+}
+
+/* print the one line match record parsed by montecarlo.py */
+void robotsim_match_record(void)
+{
+	printf("MATCH seed=%u points=%u zones=%u obstacle=%u blocking=%u "
+	       "avoid_ms=%"PRIu32" time_ms=%"PRIu32"\n",
+	       robotsim_seed,
+	       strat_infos.stats.points,
+	       strat_infos.stats.zones_done,
+	       strat_infos.stats.end_obstacle,
+	       strat_infos.stats.end_blocking,
+	       (uint32_t)(strat_infos.stats.goto_avoid_us / 1000),
+	       (uint32_t)(robotsim_clock_get_us() / 1000));
+	fflush(stdout);
+}
+#endif /* HOST_HEADLESS */
+
 /* must be called periodically */
 void robotsim_update(void)
 {
@@ -280,7 +475,10 @@ void robotsim_update(void)
 
 	int oppx, oppy, oppa_abs;
 	double oppa, oppd;
+	uint8_t opp_num;
+	int16_t opp_x, opp_y;
 
+	robotsim_rec_cycle();
 	beacon_update();
 
 	/* time shift the command */
@@ -292,12 +490,16 @@ void robotsim_update(void)
 	local_r_pwm = r_pwm_shift[i];
 
 	/* read command */
-	if (((cpt ++) & 0x7) == 0) {
+	cmd[0] = 0;
+#ifndef HOST_HEADLESS
+	if (((cpt ++) & 0x7) == 0 &&
+	    robotsim_rec_mode() != ROBOTSIM_REC_REPLAY) {
 		n = read(fdr, &cmd, BUFSIZ - 1);
 		if (n < 1)
 			n = 0;
 		cmd[n] = 0;
 	}
+#endif
 
 	/* perturbation */
 /*	if (cmd[0] == 'l')
@@ -308,54 +510,21 @@ void robotsim_update(void)
 		robotsim_blocking = 1;
 */
 	if (cmd[0] == 'o') {
-		if (sscanf(cmd, "opp_1 %d %d", &oppx, &oppy) == 2) {
-			abs_xy_to_rel_da(oppx, oppy, &oppd, &oppa);
-
-			/* limit to the real range.
-			   event flag and bt link simulation  */
-			if (oppd < 2300 
-				&& (mainboard.flags & DO_BEACON)
-				&& (beaconboard.link_id != 0xFF) ) {
-
-				IRQ_LOCK(flags);
-				beaconboard.opponent1_x = oppx;
-				beaconboard.opponent1_y = oppy;
-				beaconboard.opponent1_a = DEG(oppa);
-				if (beaconboard.opponent1_a < 0)
-					beaconboard.opponent1_a += 360;
-				beaconboard.opponent1_d = oppd;
-				IRQ_UNLOCK(flags);
-			}
-			else {
-				IRQ_LOCK(flags);
-				beaconboard.opponent1_x = I2C_OPPONENT_NOT_THERE;
-				IRQ_UNLOCK(flags);
-			}
-		}
-		else if (sscanf(cmd, "opp_2 %d %d", &oppx, &oppy) == 2) {
-			abs_xy_to_rel_da(oppx, oppy, &oppd, &oppa);
+		if (sscanf(cmd, "opp_1 %d %d", &oppx, &oppy) == 2)
+			robotsim_set_opponent(1, oppx, oppy);
+		else if (sscanf(cmd, "opp_2 %d %d", &oppx, &oppy) == 2)
+			robotsim_set_opponent(2, oppx, oppy);
+	}
 
-			/* limit to the real range.
-			   event flag and bt link simulation  */		
-			if (oppd < 2300 
-				&& (mainboard.flags & DO_BEACON)
-				&& (beaconboard.link_id != 0xFF) ) {
-				IRQ_LOCK(flags);
-				beaconboard.opponent2_x = oppx;
-				beaconboard.opponent2_y = oppy;
-				beaconboard.opponent2_a = DEG(oppa);
-				if (beaconboard.opponent2_a < 0)
-					beaconboard.opponent2_a += 360;
-				beaconboard.opponent2_d = oppd;
-				IRQ_UNLOCK(flags);
-			}
-			else {
-				IRQ_LOCK(flags);
-				beaconboard.opponent1_x = I2C_OPPONENT_NOT_THERE;
-				IRQ_UNLOCK(flags);
-			}
-		}
+	/* recorded opponents replace the display.py ones */
+	if (robotsim_rec_mode() == ROBOTSIM_REC_REPLAY) {
+		while (robotsim_rec_opp_get(&opp_num, &opp_x, &opp_y) == 0)
+			robotsim_set_opponent(opp_num, opp_x, opp_y);
 	}
+#ifdef HOST_HEADLESS
+	else
+		robotsim_opp_update();
+#endif
 
   /* XXX HACK, pos from the robot mate */
 #if 0
@@ -418,6 +587,8 @@ void robotsim_update(void)
 	/* XXX should lock */
 	l_enc += (l_speed/1000);
 	r_enc += (r_speed/1000);
+
+	robotsim_rec_state(l_enc, r_enc, l_pwm, r_pwm);
 }
 
 void robotsim_pwm(void *arg, int32_t val)
@@ -444,12 +615,20 @@ int16_t robotsim_uart_recv_BT(void)
   char c = 0;
   int n;
 
+  if (robotsim_rec_mode() == ROBOTSIM_REC_REPLAY)
+    return robotsim_rec_bt(-1);
+
+#ifdef HOST_HEADLESS
+  /* no robot 2nd process in headless mode */
+  return -1;
+#endif
+
   n = read(fd_btr, &c, 1);
 
 	if (n < 1)
 	  return -1;
 
-  return (((int16_t)c) & 0x00FF); 
+  return robotsim_rec_bt(((int16_t)c) & 0x00FF); 
 }
 
 /* BT UART send char */
@@ -457,6 +636,10 @@ int16_t robotsim_uart_send_BT(char c)
 {
   int n;
 
+#ifdef HOST_HEADLESS
+  return c;
+#endif
+
   n = write(fd_btw, &c, 1);
 
 	if (n < 1)
@@ -465,8 +648,180 @@ int16_t robotsim_uart_send_BT(char c)
   return c;
 }
 
+#ifdef HOST_HEADLESS
+/* 
+ * Headless mode, faster than real time.
+ *
+ * hostsim_init() paces the scheduler with the wall clock. Here a
+ * thread sends the same SIGUSR1 tick but just after the previous one
+ * has been served, so the time module (and then time_get_us2(),
+ * time_wait_ms(), END_TIMER...) advances one SCHEDULER_UNIT per tick
+ * as fast as the cpu can do. Using the same signal keeps IRQ_LOCK()
+ * sections of the main thread safe.
+ */
+static void robotsim_clock_tick(int sig)
+{
+	scheduler_interrupt();
+	robotsim_ticks ++;
+}
+
+/* lockstep, wait a robotsim_idle() of the main thread. Loops of the
+ * strat without it get a tick after ROBOTSIM_IDLE_TIMEOUT_MS, these free
+ * ticks are not deterministic */
+static void robotsim_clock_wait_idle(uint32_t *seq)
+{
+	struct timespec t0, t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	while (robotsim_idle_seq == *seq) {
+		sched_yield();
+		clock_gettime(CLOCK_MONOTONIC, &t);
+		if ((t.tv_sec - t0.tv_sec) * 1000 +
+		    (t.tv_nsec - t0.tv_nsec) / 1000000 > ROBOTSIM_IDLE_TIMEOUT_MS) {
+			robotsim_free_ticks ++;
+			return;
+		}
+	}
+	*seq = robotsim_idle_seq;
+}
+
+static void *robotsim_clock_thread(void *arg)
+{
+	pid_t pid = getpid();
+	sigset_t set;
+	uint32_t t, seq = 0;
+
+	/* ticks are served by the main thread only */
+	sigemptyset(&set);
+	sigaddset(&set, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+	while (1) {
+		if (robotsim_lockstep)
+			robotsim_clock_wait_idle(&seq);
+
+		t = robotsim_ticks;
+		kill(pid, SIGUSR1);
+
+		/* wait ack, and let the strat run between ticks */
+		while (robotsim_ticks == t)
+			sched_yield();
+		sched_yield();
+	}
+	return NULL;
+}
+
+/* replace hostsim_init(), start the virtual clock. Time must not
+ * depend on the cpu, so a seed always plays the same match: the clock
+ * goes in lockstep with the strat thread. ROBOTSIM_FREE_CLOCK=1 lets it
+ * run freely against the strat, except when the inputs are recorded or
+ * replayed */
+int robotsim_clock_init(void)
+{
+	struct sigaction sigact;
+	pthread_t tid;
+	char *env;
+
+	env = getenv("ROBOTSIM_FREE_CLOCK");
+	robotsim_lockstep = (robotsim_rec_mode() != ROBOTSIM_REC_OFF) ||
+		!(env && atoi(env));
+
+	memset(&sigact, 0, sizeof(sigact));
+	sigact.sa_handler = robotsim_clock_tick;
+	sigact.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1, &sigact, NULL);
+
+	if (pthread_create(&tid, NULL, robotsim_clock_thread, NULL))
+		return -1;
+	return 0;
+}
+
+/* return virtual time in us */
+uint64_t robotsim_clock_get_us(void)
+{
+	return (uint64_t)robotsim_ticks * SCHEDULER_UNIT;
+}
+
+/* 
+ * Called by the wait loops of the main thread. In lockstep the virtual
+ * clock only advances here, one tick per call: the strat runs between
+ * ticks in no time and sees the cs always at the same points, whatever
+ * the cpu load.
+ */
+void robotsim_idle(void)
+{
+	uint32_t t = robotsim_ticks;
+
+	if (!robotsim_lockstep)
+		return;
+
+	robotsim_idle_seq ++;
+	while (robotsim_ticks == t)
+		sched_yield();
+}
+
+/* replace time_wait_ms(), see main.h */
+void robotsim_wait_ms(uint16_t ms)
+{
+	microseconds us = time_get_us2();
+
+	while (time_get_us2() - us < ms * 1000L)
+		robotsim_idle();
+}
+#endif /* HOST_HEADLESS */
+
+static void robotsim_rec_exit(void)
+{
+#ifdef HOST_HEADLESS
+	if (robotsim_lockstep)
+		printf("lockstep: %"PRIu32" ticks out of the strat waits\n",
+		       (uint32_t)robotsim_free_ticks);
+#endif
+	robotsim_rec_close();
+}
+
+/* telemetry frames, see telemetry.h */
+int8_t robotsim_telemetry_enabled(void)
+{
+	return fd_telem >= 0;
+}
+
+void robotsim_telemetry_write(const uint8_t *buf, uint8_t n)
+{
+	if (fd_telem >= 0)
+		write(fd_telem, buf, n);
+}
+
 int robotsim_init(void)
 {
+	const char *telem;
+
+	/* inputs record or replay */
+	if (robotsim_rec_init() < 0)
+		return -1;
+	atexit(robotsim_rec_exit);
+
+	/* match recording, a file or a fifo (blocks until it's read) */
+	telem = getenv("ROBOTSIM_TELEMETRY");
+	if (telem != NULL && telem[0] != '\0') {
+		fd_telem = open(telem, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd_telem < 0)
+			printf("cannot open %s\n", telem);
+	}
+
+#ifdef HOST_HEADLESS
+	/* no display.py nor robot 2nd fifos */
+	fdr = fdw = fd_btr = fd_btw = -1;
+
+	/* as "beacon open" and "robot_2nd open" commands, robot 2nd
+	 * commands are dropped and they will end on ack timeout */
+	beaconboard.link_id = 1;
+	robot_2nd.link_id = 0;
+
+	robotsim_opp_init();
+	return 0;
+#endif
+
 #if 1
 	mkfifo("/tmp/.robot_sim2dis", 0600);
 	mkfifo("/tmp/.robot_dis2sim", 0600);
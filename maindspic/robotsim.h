@@ -26,7 +26,23 @@ void robotsim_update(void);
 void robotsim_pwm(void *arg, int32_t val);
 int32_t robotsim_encoder_get(void *arg);
 int robotsim_init(void);
+
+#ifdef HOST_HEADLESS
+/* replace hostsim_init(), start the virtual clock */
+int robotsim_clock_init(void);
+
+/* return virtual time in us */
+uint64_t robotsim_clock_get_us(void);
+
+/* print the one line match record parsed by montecarlo.py */
+void robotsim_match_record(void);
+#endif
 void robotsim_dump(void);
+
+/* telemetry output, file or fifo of ROBOTSIM_TELEMETRY */
+int8_t robotsim_telemetry_enabled(void);
+void robotsim_telemetry_write(const uint8_t *buf, uint8_t n);
+
 int8_t robotsim_i2c_cobboard_set_mode(uint8_t mode);
 int8_t robotsim_i2c_cobboard_set_spickles(uint8_t side, uint8_t flags);
 
@@ -0,0 +1,289 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#ifndef HOST_VERSION_REC_TEST
+#include <aversive.h>
+#include <scheduler.h>
+#else
+#include "rec_host.h"
+#endif
+
+#include "robotsim_rec.h"
+
+#define REC_HDR_LEN		8
+#define REC_TYPE_MAX	4
+
+static uint8_t rec_mode = ROBOTSIM_REC_OFF;
+static uint32_t rec_cycle;
+
+/* record */
+static FILE *rec_file;
+
+/* replay, whole file in memory, next record of each type */
+static uint8_t *rep_buf;
+static uint32_t rep_len;
+static uint32_t rep_cur[REC_TYPE_MAX];
+static uint8_t rep_check = ROBOTSIM_REC_CHECK;
+static uint32_t rep_checks, rep_diffs, rep_first_diff;
+
+static void rec_put32(uint8_t *buf, uint32_t v)
+{
+	buf[0] = v;
+	buf[1] = v >> 8;
+	buf[2] = v >> 16;
+	buf[3] = v >> 24;
+}
+
+static uint32_t rec_get32(const uint8_t *buf)
+{
+	return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+		((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static void rec_write(uint8_t type, const uint8_t *data, uint8_t len)
+{
+	uint8_t hdr[6];
+
+	rec_put32(hdr, rec_cycle);
+	hdr[4] = type;
+	hdr[5] = len;
+	fwrite(hdr, 1, sizeof(hdr), rec_file);
+	fwrite(data, 1, len, rec_file);
+}
+
+/* next record of a type up to the current cycle, NULL if none */
+static const uint8_t *rep_next(uint8_t type, uint32_t *cycle)
+{
+	uint32_t pos = rep_cur[type];
+	uint8_t len;
+
+	while (pos + 6 <= rep_len) {
+		len = rep_buf[pos + 5];
+		if (pos + 6 + len > rep_len)
+			break;
+		if (rep_buf[pos + 4] == type) {
+			*cycle = rec_get32(&rep_buf[pos]);
+			if (*cycle > rec_cycle)
+				break;
+			rep_cur[type] = pos + 6 + len;
+			return &rep_buf[pos + 6];
+		}
+		pos += 6 + len;
+	}
+
+	/* other types skipped for good */
+	rep_cur[type] = pos;
+	return NULL;
+}
+
+static int rep_load(const char *name)
+{
+	FILE *f;
+	long len;
+	uint8_t i;
+
+	f = fopen(name, "rb");
+	if (f == NULL)
+		return -1;
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (len < REC_HDR_LEN)
+		goto fail;
+
+	rep_buf = malloc(len);
+	if (rep_buf == NULL || fread(rep_buf, 1, len, f) != (size_t)len)
+		goto fail;
+	fclose(f);
+
+	if (memcmp(rep_buf, "RSIM", 4) || rep_buf[4] != ROBOTSIM_REC_VERSION) {
+		printf("%s: not a robotsim record\n", name);
+		free(rep_buf);
+		rep_buf = NULL;
+		return -1;
+	}
+	if ((rep_buf[6] | (rep_buf[7] << 8)) != SCHEDULER_UNIT)
+		printf("%s: recorded with another SCHEDULER_UNIT\n", name);
+
+	rep_check = rep_buf[5];
+	rep_len = len;
+	for (i = 0; i < REC_TYPE_MAX; i++)
+		rep_cur[i] = REC_HDR_LEN;
+	return 0;
+
+ fail:
+	fclose(f);
+	return -1;
+}
+
+int robotsim_rec_init(void)
+{
+	uint8_t hdr[REC_HDR_LEN] = { 'R', 'S', 'I', 'M' };
+	const char *name;
+
+	name = getenv("ROBOTSIM_REPLAY");
+	if (name != NULL && name[0] != '\0') {
+		if (rep_load(name) < 0) {
+			printf("cannot replay %s\n", name);
+			return -1;
+		}
+		rec_mode = ROBOTSIM_REC_REPLAY;
+		return 0;
+	}
+
+	name = getenv("ROBOTSIM_RECORD");
+	if (name != NULL && name[0] != '\0') {
+		rec_file = fopen(name, "wb");
+		if (rec_file == NULL) {
+			printf("cannot record %s\n", name);
+			return -1;
+		}
+		hdr[4] = ROBOTSIM_REC_VERSION;
+		hdr[5] = ROBOTSIM_REC_CHECK;
+		hdr[6] = SCHEDULER_UNIT & 0xFF;
+		hdr[7] = SCHEDULER_UNIT >> 8;
+		fwrite(hdr, 1, sizeof(hdr), rec_file);
+		rec_mode = ROBOTSIM_REC_RECORD;
+	}
+	return 0;
+}
+
+uint8_t robotsim_rec_mode(void)
+{
+	return rec_mode;
+}
+
+void robotsim_rec_cycle(void)
+{
+	rec_cycle++;
+}
+
+void robotsim_rec_opp(uint8_t num, int16_t x, int16_t y)
+{
+	uint8_t data[5];
+
+	if (rec_mode != ROBOTSIM_REC_RECORD)
+		return;
+
+	data[0] = num;
+	data[1] = x;
+	data[2] = (uint16_t)x >> 8;
+	data[3] = y;
+	data[4] = (uint16_t)y >> 8;
+	rec_write(ROBOTSIM_REC_OPP, data, sizeof(data));
+}
+
+int8_t robotsim_rec_opp_get(uint8_t *num, int16_t *x, int16_t *y)
+{
+	const uint8_t *data;
+	uint32_t cycle;
+
+	data = rep_next(ROBOTSIM_REC_OPP, &cycle);
+	if (data == NULL)
+		return -1;
+
+	*num = data[0];
+	*x = (int16_t)(data[1] | (data[2] << 8));
+	*y = (int16_t)(data[3] | (data[4] << 8));
+	return 0;
+}
+
+int16_t robotsim_rec_bt(int16_t c)
+{
+	const uint8_t *data;
+	uint8_t ch;
+	uint32_t cycle;
+
+	if (rec_mode == ROBOTSIM_REC_REPLAY) {
+		data = rep_next(ROBOTSIM_REC_BT, &cycle);
+		return data? data[0]: -1;
+	}
+
+	if (rec_mode == ROBOTSIM_REC_RECORD && c >= 0) {
+		ch = c;
+		rec_write(ROBOTSIM_REC_BT, &ch, 1);
+	}
+	return c;
+}
+
+void robotsim_rec_state(int32_t l_enc, int32_t r_enc,
+			int32_t l_pwm, int32_t r_pwm)
+{
+	uint8_t data[16];
+	const uint8_t *rec;
+	uint32_t cycle;
+
+	if (rec_mode == ROBOTSIM_REC_OFF || (rec_cycle % rep_check) != 0)
+		return;
+
+	rec_put32(&data[0], l_enc);
+	rec_put32(&data[4], r_enc);
+	rec_put32(&data[8], l_pwm);
+	rec_put32(&data[12], r_pwm);
+
+	if (rec_mode == ROBOTSIM_REC_RECORD) {
+		rec_write(ROBOTSIM_REC_STATE, data, sizeof(data));
+		return;
+	}
+
+	/* a check of the current cycle, if the record is not over */
+	rec = rep_next(ROBOTSIM_REC_STATE, &cycle);
+	if (rec == NULL || cycle != rec_cycle)
+		return;
+
+	rep_checks++;
+	if (memcmp(rec, data, sizeof(data)) == 0)
+		return;
+
+	if (rep_diffs++ == 0) {
+		rep_first_diff = rec_cycle;
+		printf("replay differs at cycle %"PRIu32": enc %"PRId32",%"PRId32
+		       " pwm %"PRId32",%"PRId32", recorded %"PRId32",%"PRId32
+		       " pwm %"PRId32",%"PRId32"\n", rec_cycle,
+		       l_enc, r_enc, l_pwm, r_pwm,
+		       (int32_t)rec_get32(&rec[0]), (int32_t)rec_get32(&rec[4]),
+		       (int32_t)rec_get32(&rec[8]), (int32_t)rec_get32(&rec[12]));
+	}
+}
+
+void robotsim_rec_close(void)
+{
+	if (rec_mode == ROBOTSIM_REC_RECORD) {
+		fclose(rec_file);
+		rec_file = NULL;
+	}
+	else if (rec_mode == ROBOTSIM_REC_REPLAY) {
+		/* one line, as the match record */
+		printf("REPLAY cycles=%"PRIu32" checks=%"PRIu32" diffs=%"PRIu32
+		       " first_diff=%"PRIu32"\n",
+		       rec_cycle, rep_checks, rep_diffs, rep_first_diff);
+		fflush(stdout);
+		free(rep_buf);
+		rep_buf = NULL;
+	}
+	rec_mode = ROBOTSIM_REC_OFF;
+}
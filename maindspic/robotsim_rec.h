@@ -0,0 +1,88 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Record and replay of the host simulation inputs. Environment:
+ *   ROBOTSIM_RECORD  file where the inputs are recorded
+ *   ROBOTSIM_REPLAY  recorded file, inputs are read from it instead of
+ *                    the display.py fifo, the random opponents and the
+ *                    robot 2nd fifo
+ *
+ * Inputs are stamped with the cs cycle (robotsim_update() calls) they
+ * are received: the opponents positions (opp_1/opp_2 lines of display.py
+ * or the headless random opponents) and the chars of the BT uart. Time
+ * is not an input, the host time module counts scheduler ticks. Sensors
+ * and i2c slaves are not simulated and read as constants.
+ *
+ * Every ROBOTSIM_REC_CHECK cycles the encoders and motor commands are
+ * recorded too, replay compares them and reports the first cycle that
+ * differs. In headless mode the virtual clock goes in lockstep with the
+ * strat thread (see robotsim_idle()), so a headless recording replays
+ * bit exactly as long as the "lockstep" line at exit reports 0 ticks out
+ * of the strat waits.
+ *
+ * File: "RSIM", version (8), check period (8), SCHEDULER_UNIT (16),
+ * then records: cycle (32), type (8), len (8), data[len], little endian.
+ */
+
+#ifndef _ROBOTSIM_REC_H_
+#define _ROBOTSIM_REC_H_
+
+#include <stdint.h>
+
+#define ROBOTSIM_REC_VERSION	1
+#define ROBOTSIM_REC_CHECK		20		/* cs cycles between checks */
+
+/* record types */
+#define ROBOTSIM_REC_OPP		1		/* num (8), x, y (16) */
+#define ROBOTSIM_REC_BT			2		/* char (8) */
+#define ROBOTSIM_REC_STATE		3		/* l_enc, r_enc, l_pwm, r_pwm (32) */
+
+/* modes */
+#define ROBOTSIM_REC_OFF		0
+#define ROBOTSIM_REC_RECORD		1
+#define ROBOTSIM_REC_REPLAY		2
+
+/* open the file of the environment, return -1 on error */
+int robotsim_rec_init(void);
+
+uint8_t robotsim_rec_mode(void);
+
+/* start of a cs cycle, from robotsim_update() */
+void robotsim_rec_cycle(void);
+
+/* record an opponent position */
+void robotsim_rec_opp(uint8_t num, int16_t x, int16_t y);
+
+/* replay: next opponent position of the current cycle, -1 if none */
+int8_t robotsim_rec_opp_get(uint8_t *num, int16_t *x, int16_t *y);
+
+/* record the result of a BT uart read, or replay it */
+int16_t robotsim_rec_bt(int16_t c);
+
+/* record or compare the state, end of robotsim_update() */
+void robotsim_rec_state(int32_t l_enc, int32_t r_enc,
+			int32_t l_pwm, int32_t r_pwm);
+
+/* close the record, or print the replay result */
+void robotsim_rec_close(void);
+
+#endif
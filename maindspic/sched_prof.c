@@ -0,0 +1,156 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <aversive.h>
+#include <aversive/pgmspace.h>
+
+#include <scheduler.h>
+#include <clock_time.h>
+
+#ifdef HOST_VERSION
+#include <time.h>
+#endif
+
+#include "sched_prof.h"
+
+struct sched_prof_event {
+	void (*f)(void *);
+	void *data;
+	uint32_t last_start_us;
+	struct sched_prof_stats st;
+};
+
+static struct sched_prof_event prof_events[SCHED_PROF_MAX];
+static uint8_t prof_nb;
+
+static inline uint32_t sched_prof_now_us(void)
+{
+#ifdef HOST_VERSION
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+#else
+	return (uint32_t)time_get_us2();
+#endif
+}
+
+static void sched_prof_stats_clear(struct sched_prof_stats *st)
+{
+	st->count = 0;
+	st->min_us = 0xFFFFFFFF;
+	st->max_us = 0;
+	st->sum_us = 0;
+	st->interval_max_us = 0;
+	st->overruns = 0;
+}
+
+/* called by the scheduler instead of the event */
+static void sched_prof_call(void *arg)
+{
+	struct sched_prof_event *ev = arg;
+	struct sched_prof_stats *st = &ev->st;
+	uint32_t start, t;
+
+	start = sched_prof_now_us();
+	ev->f(ev->data);
+	t = sched_prof_now_us() - start;
+
+	if (st->count && (start - ev->last_start_us) > st->interval_max_us)
+		st->interval_max_us = start - ev->last_start_us;
+	ev->last_start_us = start;
+
+	st->count++;
+	st->sum_us += t;
+	if (t < st->min_us)
+		st->min_us = t;
+	if (t > st->max_us)
+		st->max_us = t;
+	if (t > st->period_us)
+		st->overruns++;
+}
+
+int8_t sched_prof_add_event(const char *name, void (*f)(void *), void *data,
+			    uint16_t period, uint8_t priority)
+{
+	struct sched_prof_event *ev;
+	int8_t ret;
+
+	if (prof_nb >= SCHED_PROF_MAX)
+		return scheduler_add_periodical_event_priority(f, data, period, priority);
+
+	ev = &prof_events[prof_nb];
+	memset(ev, 0, sizeof(*ev));
+	ev->f = f;
+	ev->data = data;
+	ev->st.name = name;
+	ev->st.period_us = (uint32_t)period * SCHEDULER_UNIT;
+	sched_prof_stats_clear(&ev->st);
+
+	ret = scheduler_add_periodical_event_priority(sched_prof_call, ev,
+						      period, priority);
+	if (ret >= 0)
+		prof_nb++;
+	return ret;
+}
+
+void sched_prof_reset(void)
+{
+	uint8_t flags, i;
+
+	for (i = 0; i < prof_nb; i++) {
+		IRQ_LOCK(flags);
+		sched_prof_stats_clear(&prof_events[i].st);
+		IRQ_UNLOCK(flags);
+	}
+}
+
+int8_t sched_prof_get(uint8_t num, struct sched_prof_stats *st)
+{
+	uint8_t flags;
+
+	if (num >= prof_nb)
+		return -1;
+
+	IRQ_LOCK(flags);
+	memcpy(st, &prof_events[num].st, sizeof(*st));
+	IRQ_UNLOCK(flags);
+	return 0;
+}
+
+void sched_prof_dump(void)
+{
+	struct sched_prof_stats st;
+	uint8_t i;
+
+	printf_P(PSTR("event          period     count   min   avg   max  interval overruns\r\n"));
+	for (i = 0; sched_prof_get(i, &st) == 0; i++) {
+		printf_P(PSTR("%-12s %8lu %9lu %5lu %5lu %5lu %9lu %8lu\r\n"),
+			 st.name, (unsigned long)st.period_us, (unsigned long)st.count,
+			 (unsigned long)(st.count? st.min_us: 0),
+			 (unsigned long)(st.count? st.sum_us / st.count: 0),
+			 (unsigned long)st.max_us, (unsigned long)st.interval_max_us,
+			 (unsigned long)st.overruns);
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Scheduler events profiler. The periodical events added with
+ * sched_prof_add_event() are called through a wrapper that measures
+ * each call with time_get_us2(): count, min/avg/max execution time,
+ * max time between calls and overruns (calls longer than the period).
+ * Times include the higher priority events that interrupt the event.
+ * In the host version times are taken from the host monotonic clock,
+ * the scheduler may run on a virtual clock.
+ */
+
+#ifndef _SCHED_PROF_H_
+#define _SCHED_PROF_H_
+
+#include <stdint.h>
+
+#define SCHED_PROF_MAX		8	/* profiled events, up to SCHEDULER_NB_MAX_EVENT */
+
+struct sched_prof_stats {
+	const char *name;
+	uint32_t period_us;
+	uint32_t count;				/* calls */
+	uint32_t min_us, max_us;	/* execution time */
+	uint32_t sum_us;			/* for the average, wraps after hours */
+	uint32_t interval_max_us;	/* max time between two calls */
+	uint32_t overruns;			/* calls longer than the period */
+};
+
+/* same as scheduler_add_periodical_event_priority(), period in scheduler
+ * units, with a name for the dump. Return the scheduler event id or -1 */
+int8_t sched_prof_add_event(const char *name, void (*f)(void *), void *data,
+			    uint16_t period, uint8_t priority);
+
+/* clear the stats of all events */
+void sched_prof_reset(void);
+
+/* copy of the stats of a profiled event, -1 if num is not used */
+int8_t sched_prof_get(uint8_t num, struct sched_prof_stats *st);
+
+/* print the stats of all events */
+void sched_prof_dump(void);
+
+#endif
@@ -38,6 +38,7 @@
 #include "sensor.h"
 #include "strat.h"
 #include "strat_utils.h"
+#include "sched_prof.h"
 
 #ifndef HOST_VERSION
 
@@ -394,7 +395,7 @@ void sensor_init(void)
 	adc_init();
 #endif	
 	/* CS EVENT */
-	scheduler_add_periodical_event_priority(do_sensors, NULL, 
-						EVENT_PERIOD_SENSORS / SCHEDULER_UNIT, EVENT_PRIORITY_SENSORS);
+	sched_prof_add_event("sensors", do_sensors, NULL,
+			     EVENT_PERIOD_SENSORS / SCHEDULER_UNIT, EVENT_PRIORITY_SENSORS);
 }
 
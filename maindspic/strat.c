@@ -60,6 +60,7 @@
 #include "strat_base.h"
 #include "strat_avoid.h"
 #include "strat_utils.h"
+#include "opp_tracker.h"
 #include "sensor.h"
 #include "actuator.h"
 #include "beacon.h"
@@ -226,6 +227,8 @@ void strat_dump_conf(void)
     //printf(" ENABLE_R2ND_POS is %s\n\r", strat_infos.conf.flags & ENABLE_R2ND_POS? "ON":"OFF");
     //printf(" ENABLE_DOWN_SIDE_ZONES is %s\n\r", strat_infos.conf.flags & ENABLE_DOWN_SIDE_ZONES? "ON":"OFF");
 
+    printf(" OPP_PREDICTION is %s\n\r", strat_infos.conf.flags & CONF_FLAG_OPP_PREDICTION? "ON":"OFF");
+
     /* add here configuration dump */
 }
 
@@ -285,10 +288,20 @@ void strat_reset_infos(void)
     /* bounding box */
     strat_set_bounding_box(mainboard.our_color);
 
+    /* static obstacle avoidance geometry */
+    strat_avoid_static_init();
+
     strat_infos.current_zone = ZONES_MAX;
     strat_infos.goto_zone = ZONES_MAX;
     strat_infos.last_zone = ZONES_MAX;
 
+    /* match statistics */
+    memset(&strat_infos.stats, 0, sizeof(strat_infos.stats));
+
+    /* opponents velocity */
+    memset(&strat_infos.opp_v, 0, sizeof(strat_infos.opp_v));
+    opp_tracker_init();
+
     /* add here other infos resets */
 }
 
@@ -308,6 +321,7 @@ void strat_init(void)
     strat_reset_infos();
 
     /* we consider that the color is correctly set */
+    strat_zone_cost_init();
 
     strat_set_speed(SPEED_DIST_FAST, SPEED_ANGLE_FAST);
     time_reset();
@@ -375,6 +389,12 @@ void strat_event(void *dummy)
     /* tracking of zones where opp has been working */
     strat_opp_tracking();
 
+    /* opponents velocity, for avoidance prediction */
+    opponents_velocity_update();
+
+    /* beacon and robot 2nd opponents fusion */
+    opponents_tracker_update();
+
 }
 
 /* dump state (every 5 s max) XXX */
@@ -274,7 +274,8 @@ struct conf {
 /* depends on flags the robot
  * will do different things */
 	uint8_t flags;
-#define CONF_FLAG_XXX   1
+#define CONF_FLAG_XXX   			1
+#define CONF_FLAG_OPP_PREDICTION	2	/* sweep opp polys along their motion */
 };
 
 
@@ -341,6 +342,25 @@ typedef struct {
 	
 } strat_zones_t;
 
+/* match statistics, see the headless host simulator */
+struct strat_stats {
+	uint16_t points;			/* points of the zones done */
+	uint8_t zones_done;			/* zones worked successfully */
+	uint16_t end_obstacle;		/* END_OBSTACLE returned by wait_traj_end() */
+	uint16_t end_blocking;		/* END_BLOCKING returned by wait_traj_end() */
+	microseconds goto_avoid_us;	/* time spent in goto_and_avoid() */
+};
+
+/* opponent velocity, see opponents_velocity_update() */
+struct opp_velocity {
+	int16_t x;					/* last sample */
+	int16_t y;
+	microseconds time_us;		/* time of the last sample */
+	int16_t vx;					/* filtered velocity, mm/s */
+	int16_t vy;
+	uint8_t valid;
+};
+
 /* information about strat stuff */
 struct strat_infos {
 	uint8_t dump_enabled;
@@ -370,7 +390,13 @@ struct strat_infos {
 	uint8_t opp_score;
 	uint8_t opp_harvested_trees;
 
+	/* opponents velocity */
+	struct opp_velocity opp_v[2];
+
     uint8_t tree_harvesting_interrumped;
+
+	/* match statistics */
+	struct strat_stats stats;
 };
 
 extern struct strat_infos strat_infos;
@@ -460,6 +486,21 @@ uint8_t strat_main_loop(void);
 /* return new work zone, -1 if any zone is found */
 int8_t strat_get_new_zone(void);
 
+/* travel time estimation from x,y to a zone */
+int32_t strat_zone_travel_ms(int16_t x, int16_t y, uint8_t zone_num);
+
+/* zone to zone travel costs matrix, built once per color */
+void strat_zone_cost_init(void);
+
+/* mark the cells occupied by the opponents, penalizes the costs crossing them */
+void strat_zone_cost_update(void);
+
+/* travel time estimation between two zones */
+int32_t strat_zone_cost_ms(uint8_t from, uint8_t to);
+
+/* first zone of the best plan of zones, -1 if there is no plan */
+int8_t strat_plan_zone(void);
+
 /* return END_TRAJ if zone is reached */
 uint8_t strat_goto_zone(uint8_t zone_num);
 
@@ -36,6 +36,8 @@
 #include <aversive/wait.h>
 #include <aversive/error.h>
 
+#include "fast_math.h"
+
 #ifndef HOST_VERSION_OA_TEST
 #include <uart.h>
 #include <dac_mc.h>
@@ -84,14 +86,18 @@
 
 #endif
 
+/* opponent polys have OPP_TRACK_MARGIN for the beacon error, it's
+ * reduced down to 2 sigmas when the opponent is tracked */
+#define OPP_TRACK_MARGIN 100
+
 #if defined(HOMOLOGATION)
 /* /!\ half size */
-#define O_WIDTH  400
-#define O_LENGTH 550
+#define O_WIDTH  (300 + OPP_TRACK_MARGIN)
+#define O_LENGTH (450 + OPP_TRACK_MARGIN)
 #else
 /* /!\ half size */
-#define O_WIDTH  330 //360
-#define O_LENGTH 500
+#define O_WIDTH  (230 + OPP_TRACK_MARGIN) //360
+#define O_LENGTH (400 + OPP_TRACK_MARGIN)
 #endif
 
 #ifdef IM_SECONDARY_ROBOT
@@ -139,6 +145,16 @@
 /* has to be longer than any poly */
 #define ESCAPE_VECT_LEN 3000
 
+/* on retry, only update polys of robots that moved more than this */
+#define REPLAN_MOVE_THRES 30
+
+/* opponent motion prediction (CONF_FLAG_OPP_PREDICTION): the poly is
+ * swept along the opponent velocity for the time we need to get to
+ * it at OPP_PREDICT_SPEED, up to OPP_PREDICT_MAX_MS */
+#define OPP_PREDICT_SPEED     1000	/* mm/s */
+#define OPP_PREDICT_MAX_MS    1000
+#define OPP_PREDICT_MIN_MM    20	/* less than this, no sweep */
+
 
 #ifdef HOST_VERSION_OA_TEST
 int16_t g_robot_x;
@@ -151,6 +167,11 @@ int16_t g_opp2_x;
 int16_t g_opp2_y;
 int16_t g_robot_2nd_x;
 int16_t g_robot_2nd_y;
+
+/* iterations of the poly reduction loop and corner arcs of the
+ * smoothed path, for benchmarks */
+uint16_t g_oa_loops;
+uint16_t g_oa_arcs;
 #endif
 
 #ifdef HOST_VERSION_OA_TEST
@@ -175,113 +196,62 @@ double norm(double x, double y)
 }
 #endif
 
-/* rotate point */
-#ifdef HOST_VERSION_OA_TEST
-void rotate(double *x, double *y, double rot)
+/* set a w*l rectangle centered in x,y, rotated a_deg degrees */
+static void set_rotated_rect(poly_t *pol, int16_t a_deg,
+			     int16_t w, int16_t l, int16_t x, int16_t y)
 {
-	double l, a;
-	
-	l = norm(*x, *y);
-	a = atan2(*y, *x);
-
-	a += rot;
-	*x = l * cos(a);
-	*y = l * sin(a);
-}
-#endif
-
-/* set rotated poly relative to robot coordinates */
-void set_rotated_poly(poly_t *pol, const point_t *robot_pt, 
-		      int16_t w, int16_t l, int16_t x, int16_t y)
-
-{
-	double tmp_x, tmp_y;
-	double a_rad = 0.0;
-
-	/* calcule relative angle to robot */
-	a_rad = atan2((double)(y - robot_pt->y), (double)(x - robot_pt->x));
-
-	DEBUG(E_USER_STRAT, "%s() x,y=%d,%d a_rad=%2.2f", 
-	      __FUNCTION__, x, y, a_rad);
+	int16_t tmp_x, tmp_y;
 
 	/* point 1 */
 	tmp_x = w;
 	tmp_y = l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 0);
+	fast_rotate(&tmp_x, &tmp_y, a_deg);
+	oa_poly_set_point(pol, x + tmp_x, y + tmp_y, 0);
 	
 	/* point 2 */
 	tmp_x = -w;
 	tmp_y = l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 1);
+	fast_rotate(&tmp_x, &tmp_y, a_deg);
+	oa_poly_set_point(pol, x + tmp_x, y + tmp_y, 1);
 	
 	/* point 3 */
 	tmp_x = -w;
 	tmp_y = -l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 2);
+	fast_rotate(&tmp_x, &tmp_y, a_deg);
+	oa_poly_set_point(pol, x + tmp_x, y + tmp_y, 2);
 	
 	/* point 4 */
 	tmp_x = w;
 	tmp_y = -l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 3);
+	fast_rotate(&tmp_x, &tmp_y, a_deg);
+	oa_poly_set_point(pol, x + tmp_x, y + tmp_y, 3);
 }
 
 /* set rotated poly relative to robot coordinates */
-void set_rotated_poly_abs(poly_t *pol, int16_t a_abs, 
+void set_rotated_poly(poly_t *pol, const point_t *robot_pt, 
 		      int16_t w, int16_t l, int16_t x, int16_t y)
 
 {
-	double tmp_x, tmp_y;
-	double a_rad = 0.0;
+	int16_t a_deg;
 
-	/* calcule absolute of poly */
-	a_rad = RAD(a_abs);
+	/* calcule relative angle to robot */
+	a_deg = fast_atan2(y - (int16_t)robot_pt->y, x - (int16_t)robot_pt->x);
 
-	DEBUG(E_USER_STRAT, "%s() x,y=%d,%d a_rad=%2.2f", 
-	      __FUNCTION__, x, y, a_rad);
+	DEBUG(E_USER_STRAT, "%s() x,y=%d,%d a_deg=%d", 
+	      __FUNCTION__, x, y, a_deg);
 
-	/* point 1 */
-	tmp_x = w;
-	tmp_y = l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 0);
-	
-	/* point 2 */
-	tmp_x = -w;
-	tmp_y = l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 1);
-	
-	/* point 3 */
-	tmp_x = -w;
-	tmp_y = -l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 2);
-	
-	/* point 4 */
-	tmp_x = w;
-	tmp_y = -l;
-	rotate(&tmp_x, &tmp_y, a_rad);
-	tmp_x += x;
-	tmp_y += y;
-	oa_poly_set_point(pol, tmp_x, tmp_y, 3);
+	set_rotated_rect(pol, a_deg, w, l, x, y);
+}
+
+/* set rotated poly relative to robot coordinates */
+void set_rotated_poly_abs(poly_t *pol, int16_t a_abs, 
+		      int16_t w, int16_t l, int16_t x, int16_t y)
+
+{
+	DEBUG(E_USER_STRAT, "%s() x,y=%d,%d a_deg=%d", 
+	      __FUNCTION__, x, y, a_abs);
+
+	set_rotated_rect(pol, a_abs, w, l, x, y);
 }
 
 
@@ -323,43 +293,148 @@ void set_rotated_pentagon_manual(poly_t *pol, const point_t *robot_pt,
 void set_rotated_pentagon(poly_t *pol, const point_t *robot_pt,
 			  int16_t radius, int16_t x, int16_t y)
 {
-
-	double c_a, s_a;
+	int16_t a_deg, px, py;
 	uint8_t i;
-	double px1, py1, px2, py2;
-	double a_rad;
 
-	a_rad = atan2(y - robot_pt->y, x - robot_pt->x);
+	a_deg = fast_atan2(y - (int16_t)robot_pt->y, x - (int16_t)robot_pt->x);
 
-	/* generate pentagon  */
-	c_a = cos(-2*M_PI/EDGE_NUMBER);
-	s_a = sin(-2*M_PI/EDGE_NUMBER);
+	/* generate pentagon, first point at a + 360/(2*EDGE_NUMBER) and
+	 * the others turning clockwise */
+	a_deg += 360/(2*EDGE_NUMBER);
 
-	/*
-	px1 = radius;
-	py1 = 0;
-	*/
-	px1 = radius * cos(a_rad + 2*M_PI/(2*EDGE_NUMBER));
-	py1 = radius * sin(a_rad + 2*M_PI/(2*EDGE_NUMBER));
+	for (i = 0; i < EDGE_NUMBER; i++){
+		px = ((int32_t)radius * fast_cos(a_deg)) >> 15;
+		py = ((int32_t)radius * fast_sin(a_deg)) >> 15;
+		oa_poly_set_point(pol, x + px, y + py, i);
 
+		a_deg -= 360/EDGE_NUMBER;
+	}
+}
 
-	for (i = 0; i < EDGE_NUMBER; i++){
-		oa_poly_set_point(pol, x + px1, y + py1, i);
-		
-		px2 = px1*c_a + py1*s_a;
-		py2 = -px1*s_a + py1*c_a;
+/*
+ * Static playground geometry, precomputed at boot by
+ * strat_avoid_static_init(). The heart of fire pentagon only depends
+ * on the robot position through its orientation, which is periodic
+ * every 2*pi/EDGE_NUMBER, so it is stored for HEARTFIRE_A_STEPS
+ * orientations of each radius.
+ */
+#define HEARTFIRE_A_STEPS 8
+#define HEARTFIRE_A_PERIOD (360/EDGE_NUMBER)
 
-		px1 = px2;
-  	py1 = py2;
+static const int16_t heartfire_rad[2] = { HEARTFIRE_RAD, HEARTFIRE_RAD2 };
+static int16_t heartfire_pts[2][HEARTFIRE_A_STEPS][EDGE_NUMBER][2];
+static uint8_t static_geometry_ready = 0;
+
+void strat_avoid_static_init(void)
+{
+	int16_t a_deg;
+	uint8_t r, k, i;
+
+	for (r = 0; r < 2; r++) {
+		for (k = 0; k < HEARTFIRE_A_STEPS; k++) {
+
+			/* same as set_rotated_pentagon() */
+			a_deg = (k * HEARTFIRE_A_PERIOD) / HEARTFIRE_A_STEPS;
+			a_deg += 360/(2*EDGE_NUMBER);
+
+			for (i = 0; i < EDGE_NUMBER; i++) {
+				heartfire_pts[r][k][i][0] = HEARTFIRE_X +
+					(((int32_t)heartfire_rad[r] * fast_cos(a_deg)) >> 15);
+				heartfire_pts[r][k][i][1] = HEARTFIRE_Y +
+					(((int32_t)heartfire_rad[r] * fast_sin(a_deg)) >> 15);
+
+				a_deg -= 360/EDGE_NUMBER;
+			}
+		}
 	}
+
+	static_geometry_ready = 1;
 }
 
 /* set totem islands polygon */
 void set_heartfire_poly(poly_t *pol, point_t *robot_pt, int16_t rad)
 {
-  set_rotated_pentagon(pol, robot_pt,
-	  rad, HEARTFIRE_X, HEARTFIRE_Y);
+	int16_t a_deg;
+	uint8_t r, k, i;
+
+	for (r = 0; r < 2; r++) {
+		if (heartfire_rad[r] == rad)
+			break;
+	}
+
+	/* not precomputed */
+	if (!static_geometry_ready || r == 2) {
+		set_rotated_pentagon(pol, robot_pt,
+				     rad, HEARTFIRE_X, HEARTFIRE_Y);
+		return;
+	}
+
+	/* nearest precomputed orientation */
+	a_deg = fast_atan2(HEARTFIRE_Y - (int16_t)robot_pt->y,
+			   HEARTFIRE_X - (int16_t)robot_pt->x);
+	a_deg = (a_deg + 360) % HEARTFIRE_A_PERIOD;
+	k = (a_deg * HEARTFIRE_A_STEPS + HEARTFIRE_A_PERIOD/2) / HEARTFIRE_A_PERIOD;
+	k %= HEARTFIRE_A_STEPS;
+
+	for (i = 0; i < EDGE_NUMBER; i++)
+		oa_poly_set_point(pol, heartfire_pts[r][k][i][0],
+				  heartfire_pts[r][k][i][1], i);
+}
+
+/*
+ * Return 1 if the segment between start and end points don't cross
+ * any poly, in that case the path is direct and there is no need to
+ * compute the visibility graph of all polys with oa_process().
+ * Both points are in the bounding box, that is convex.
+ */
+static uint8_t is_direct_path(point_t *start_pt, point_t *end_pt,
+			      poly_t *pol_opp1, poly_t *pol_opp2,
+			      poly_t *pol_heartfire, poly_t *pol_robot_2nd)
+{
+	point_t intersect_pt;
+
+	if (!is_in_boundingbox(start_pt) || !is_in_boundingbox(end_pt))
+		return 0;
+
+	if (is_crossing_poly(*start_pt, *end_pt, &intersect_pt, pol_heartfire))
+		return 0;
+	if (is_crossing_poly(*start_pt, *end_pt, &intersect_pt, pol_opp1))
+		return 0;
+	if (is_crossing_poly(*start_pt, *end_pt, &intersect_pt, pol_opp2))
+		return 0;
+	if (is_crossing_poly(*start_pt, *end_pt, &intersect_pt, pol_robot_2nd))
+		return 0;
+
+	return 1;
+}
+
+#ifndef HOST_VERSION_OA_TEST
+/* offset of the predicted opponent position for the time we need to
+ * get to it, return -1 if the poly is not swept */
+static int8_t get_opponent_sweep(uint8_t num, const point_t *robot_pt,
+				 int16_t x, int16_t y, int16_t *dx, int16_t *dy)
+{
+	int16_t vx, vy;
+	int32_t t_ms;
+
+	if (x == I2C_OPPONENT_NOT_THERE ||
+	    !(strat_infos.conf.flags & CONF_FLAG_OPP_PREDICTION) ||
+	    get_opponent_velocity(num, &vx, &vy) < 0)
+		return -1;
+
+	t_ms = (distance_between(robot_pt->x, robot_pt->y, x, y) * 1000L)
+		/ OPP_PREDICT_SPEED;
+	if (t_ms > OPP_PREDICT_MAX_MS)
+		t_ms = OPP_PREDICT_MAX_MS;
+
+	*dx = (vx * t_ms) / 1000L;
+	*dy = (vy * t_ms) / 1000L;
+
+	if (distance_between(0, 0, *dx, *dy) <= OPP_PREDICT_MIN_MM)
+		return -1;
+	return 0;
 }
+#endif
 
 /* set poly that represent the opponent */
 void set_opponent_poly(uint8_t type, poly_t *pol, const point_t *robot_pt, int16_t w, int16_t l)
@@ -373,24 +448,31 @@ void set_opponent_poly(uint8_t type, poly_t *pol, const point_t *robot_pt, int16
 	int8_t opp1[] = "opponent 1";
 	int8_t opp2[] = "opponent 2";
 	int8_t robot_2nd[] = "robot 2nd";
+#ifndef HOST_VERSION_OA_TEST
+	/* only the full size polys, not the reduced ones of the
+	 * goto_and_avoid() loop */
+	uint8_t margin = (type != ROBOT2ND && w == O_WIDTH && l == O_LENGTH);
+#endif
 
 #ifndef HOST_VERSION_OA_TEST
    if(type == OPP1) {
-	   get_opponent1_xy(&x, &y);
+	   get_opponent_xyda_now(0, &x, &y, NULL, NULL);
 	   name = opp1;
 
        if (y < 500) {
          w = ROBOT_2ND_WIDTH;
          l = ROBOT_2ND_LENGTH;
+         margin = 0;
        }
 	}
 	else if(type == OPP2) {
-	   get_opponent2_xy(&x, &y);
+	   get_opponent_xyda_now(1, &x, &y, NULL, NULL);
 	   name = opp2;
 
        if (y < 500) {
          w = ROBOT_2ND_WIDTH;
          l = ROBOT_2ND_LENGTH;
+         margin = 0;
        }
 	}
 	else if(type == ROBOT2ND) {
@@ -420,6 +502,36 @@ void set_opponent_poly(uint8_t type, poly_t *pol, const point_t *robot_pt, int16
 	   ERROR(E_USER_STRAT, "ERROR at %s", __FUNCTION__);
 
 	DEBUG(E_USER_STRAT, "%s at: %d %d", name, x, y);
+
+#ifndef HOST_VERSION_OA_TEST
+	/* smaller poly when the position is well known, O_WIDTH and
+	 * O_LENGTH have OPP_TRACK_MARGIN, robot 2nd and reduced sizes
+	 * don't */
+	if (margin) {
+		int16_t sigma = get_opponent_sigma(type);
+
+		if (sigma >= 0 && 2*sigma < OPP_TRACK_MARGIN) {
+			w -= OPP_TRACK_MARGIN - 2*sigma;
+			l -= OPP_TRACK_MARGIN - 2*sigma;
+		}
+	}
+
+	/* sweep the poly along the predicted opponent motion */
+	if (type != ROBOT2ND) {
+		int16_t dx, dy, d;
+
+		if (get_opponent_sweep(type, robot_pt, x, y, &dx, &dy) == 0) {
+			d = distance_between(0, 0, dx, dy);
+			DEBUG(E_USER_STRAT, "%s sweep: %d %d", name, dx, dy);
+
+			/* box from current to predicted position, w along
+			 * the motion */
+			set_rotated_poly_abs(pol, fast_atan2(dy, dx), w + d/2, l,
+					     x + dx/2, y + dy/2);
+			return;
+		}
+	}
+#endif
 	
 	/* place poly even if invalid, because it's -1000 */
   if(type == ROBOT2ND)
@@ -428,6 +540,35 @@ void set_opponent_poly(uint8_t type, poly_t *pol, const point_t *robot_pt, int16
   	set_rotated_poly(pol, robot_pt, w, l, x, y); 
 }
 
+/* on retry, tell if an opponent poly must be updated: the position and
+ * the end of the sweep it is built from are compared with the ones of
+ * the last update (last[4] = x, y, sweep x, sweep y) */
+static uint8_t opponent_poly_moved(uint8_t num, const point_t *robot_pt,
+				   int16_t x, int16_t y, int16_t *last,
+				   uint8_t force)
+{
+	int16_t end_x = x, end_y = y;
+#ifndef HOST_VERSION_OA_TEST
+	int16_t dx, dy;
+
+	if (get_opponent_sweep(num, robot_pt, x, y, &dx, &dy) == 0) {
+		end_x += dx;
+		end_y += dy;
+	}
+#endif
+
+	if (!force &&
+	    distance_between(x, y, last[0], last[1]) <= REPLAN_MOVE_THRES &&
+	    distance_between(end_x, end_y, last[2], last[3]) <= REPLAN_MOVE_THRES)
+		return 0;
+
+	last[0] = x;
+	last[1] = y;
+	last[2] = end_x;
+	last[3] = end_y;
+	return 1;
+}
+
 /* set point of a rhombus, used for slot polys */
 #if 0
 uint8_t set_rhombus_pts(point_t *pt,
@@ -898,6 +1039,132 @@ static int8_t escape_from_poly(point_t *robot_pt, int16_t robot_2nd_x, int16_t r
 	return -1;
 }
 
+/* 
+ * Path smoothing, oa_get_path() gives a polyline around the polys
+ * vertices. Points almost in line are merged, and corners are replaced
+ * by an arc tangent to both segments so the robot doesn't stop to
+ * turn. The arc cuts the corner at most SMOOTH_MAX_CUT mm.
+ *
+ * The path vertices are on the polys, so both reduce the clearance
+ * to the obstacles: up to SMOOTH_MAX_CUT (30 mm) at an arc and up to
+ * SMOOTH_COLLINEAR_MM (10 mm) at a merged point. The polys margins
+ * must cover them.
+ */
+#define SMOOTH_COLLINEAR_MM	10	/* merge points nearer to the line */
+#define SMOOTH_MAX_CUT		30	/* max distance from corner to arc */
+#define SMOOTH_RADIUS_MIN	50
+#define SMOOTH_RADIUS_MAX	300
+#define SMOOTH_ANGLE_MIN	10	/* deg, no arc for smaller turns */
+#define SMOOTH_ANGLE_MAX	120	/* deg, turn in place for bigger turns */
+#define SMOOTH_ARC_NEAR_DEG	5	/* arc done when heading is near */
+
+struct smooth_pt {
+	int16_t x;		/* go in line to this point */
+	int16_t y;
+	int16_t radius;	/* then arc if not 0 */
+	int16_t cx;		/* arc center */
+	int16_t cy;
+	int16_t a_deg;	/* arc angle, positive is trigo */
+	int16_t out_a;	/* heading at the end of the arc */
+};
+
+/* distance from point b to line (a, c) */
+static int16_t distance_to_line(point_t *a, point_t *b, point_t *c)
+{
+	int32_t cross;
+	int16_t len;
+
+	len = distance_between(a->x, a->y, c->x, c->y);
+	if (len == 0)
+		return distance_between(a->x, a->y, b->x, b->y);
+
+	cross = (int32_t)(c->x - a->x) * (b->y - a->y) -
+		(int32_t)(c->y - a->y) * (b->x - a->x);
+
+	return labs(cross) / len;
+}
+
+/* return the number of points of the smoothed path, set arcs to 0 to
+ * only merge points */
+static uint8_t oa_path_smooth(struct smooth_pt *out, point_t *robot_pt,
+			      point_t *path, uint8_t len, uint8_t arcs)
+{
+	point_t pts[MAX_CHKPOINTS + 1];
+	int16_t a_in, a_out, turn, c_half, s_half;
+	int16_t d_in, d_out, limit, t, r, n_x, n_y;
+	uint8_t n, i;
+
+	/* merge points almost in line */
+	pts[0] = *robot_pt;
+	n = 1;
+	for (i = 0; i < len; i++) {
+		if (i < len - 1 && 
+		    distance_to_line(&pts[n-1], &path[i], &path[i+1]) < SMOOTH_COLLINEAR_MM)
+			continue;
+		pts[n++] = path[i];
+	}
+
+	/* corners */
+	for (i = 1; i < n; i++) {
+		out[i-1].x = pts[i].x;
+		out[i-1].y = pts[i].y;
+		out[i-1].radius = 0;
+
+		if (!arcs || i == n - 1)
+			continue;
+
+		a_in = fast_atan2(pts[i].y - pts[i-1].y, pts[i].x - pts[i-1].x);
+		a_out = fast_atan2(pts[i+1].y - pts[i].y, pts[i+1].x - pts[i].x);
+		turn = a_out - a_in;
+		if (turn > 180)
+			turn -= 360;
+		else if (turn < -180)
+			turn += 360;
+
+		if (ABS(turn) < SMOOTH_ANGLE_MIN || ABS(turn) > SMOOTH_ANGLE_MAX)
+			continue;
+
+		/* radius for the max cut: r * (1/cos(turn/2) - 1) */
+		c_half = fast_cos(ABS(turn)/2);
+		s_half = fast_sin(ABS(turn)/2);
+		r = ((int32_t)SMOOTH_MAX_CUT * c_half) / (32768L - c_half);
+		if (r > SMOOTH_RADIUS_MAX)
+			r = SMOOTH_RADIUS_MAX;
+
+		/* tangent points in the half of the segments, shared with
+		 * the neighbour arcs */
+		d_in = distance_between(pts[i-1].x, pts[i-1].y, pts[i].x, pts[i].y);
+		d_out = distance_between(pts[i].x, pts[i].y, pts[i+1].x, pts[i+1].y);
+		limit = (d_in < d_out? d_in: d_out) / 2;
+		t = ((int32_t)r * s_half) / c_half;
+		if (t > limit) {
+			t = limit;
+			r = ((int32_t)t * c_half) / s_half;
+		}
+		if (r < SMOOTH_RADIUS_MIN)
+			continue;
+
+		/* tangent point on the incoming segment */
+		out[i-1].x = pts[i].x - (((int32_t)t * fast_cos(a_in)) >> 15);
+		out[i-1].y = pts[i].y - (((int32_t)t * fast_sin(a_in)) >> 15);
+
+		/* center on the left for trigo turns */
+		n_x = -(((int32_t)r * fast_sin(a_in)) >> 15);
+		n_y = ((int32_t)r * fast_cos(a_in)) >> 15;
+		if (turn < 0) {
+			n_x = -n_x;
+			n_y = -n_y;
+		}
+
+		out[i-1].radius = r;
+		out[i-1].cx = out[i-1].x + n_x;
+		out[i-1].cy = out[i-1].y + n_y;
+		out[i-1].a_deg = turn;
+		out[i-1].out_a = a_out;
+	}
+
+	return n - 1;
+}
 
 #define GO_AVOID_AUTO		0
 #define GO_AVOID_FORWARD	1
@@ -940,9 +1207,19 @@ int8_t goto_and_avoid(int16_t x, int16_t y,
 	int16_t opp1_x, opp1_y;
 	int16_t opp2_x, opp2_y;
 	int16_t robot_2nd_x, robot_2nd_y;
+	int16_t out_a;
 #endif	
 
 	point_t p_dst, robot_pt;
+	struct smooth_pt path[MAX_CHKPOINTS];
+
+	/* incremental replanning */
+	uint8_t oa_ready = 0, polys_reduced = 0, robot_moved;
+	uint8_t direct_path;
+	point_t last_robot_pt;
+	int16_t last_opp1[4] = {0, 0, 0, 0};
+	int16_t last_opp2[4] = {0, 0, 0, 0};
+	int16_t last_robot_2nd_x = 0, last_robot_2nd_y = 0;
 	
 	void * p_retry;
 	p_retry = &&retry;
@@ -961,6 +1238,8 @@ int8_t goto_and_avoid(int16_t x, int16_t y,
 	g_opp2_y = opp2_y;
 	g_robot_2nd_x = robot_2nd_x;
 	g_robot_2nd_y = robot_2nd_y;
+	g_oa_loops = 0;
+	g_oa_arcs = 0;
 #endif
 
 retry:
@@ -974,8 +1253,9 @@ retry:
 	
 	/* opponent info */
 #ifndef HOST_VERSION_OA_TEST	
-	get_opponent1_xy(&opp1_x, &opp1_y);
-  get_opponent2_xy(&opp2_x, &opp2_y);
+	/* same source as the polys, see set_opponent_poly() */
+	get_opponent_xyda_now(0, &opp1_x, &opp1_y, NULL, NULL);
+	get_opponent_xyda_now(1, &opp2_x, &opp2_y, NULL, NULL);
 	
 	/* get second robot */
 	//robot_2nd_x = I2C_OPPONENT_NOT_THERE;
@@ -990,6 +1270,7 @@ retry:
 	opp2_l = O_LENGTH;
 
   heartfire_r = HEARTFIRE_RAD;
+	direct_path = 0;
 
 	/* robot info */
 #ifndef HOST_VERSION_OA_TEST
@@ -1000,21 +1281,44 @@ retry:
 	robot_pt.y = robot_y;
 #endif
 
-	/* init oa */
-	oa_init();
+	/* init oa only the first time, on retry (END_OBSTACLE or
+	 * END_BLOCKING) polys are kept and only the ones of robots
+	 * that moved are updated. Polys are faced to the robot, so all of
+	 * them are updated if we moved or if they were reduced. */
+	if (!oa_ready) {
+		oa_init();
+		pol_opp1 = oa_new_poly(4);
+		pol_opp2 = oa_new_poly(4);
+		pol_robot_2nd = oa_new_poly(4);
+		pol_heartfire = oa_new_poly(5);
+	}
+
+	robot_moved = !oa_ready || polys_reduced ||
+		distance_between(robot_pt.x, robot_pt.y,
+				 last_robot_pt.x, last_robot_pt.y) > REPLAN_MOVE_THRES;
   
-	/* add opponent and 2nd robot polys */
-	pol_opp1 = oa_new_poly(4);
-	set_opponent_poly(OPP1, pol_opp1, &robot_pt, O_WIDTH, O_LENGTH);
-	pol_opp2 = oa_new_poly(4);
-	set_opponent_poly(OPP2, pol_opp2, &robot_pt, O_WIDTH, O_LENGTH);
-	
-	pol_robot_2nd = oa_new_poly(4);
-	set_opponent_poly(ROBOT2ND, pol_robot_2nd, &robot_pt, ROBOT_2ND_WIDTH, ROBOT_2ND_LENGTH);
+	/* opponent and 2nd robot polys */
+	if (opponent_poly_moved(OPP1, &robot_pt, opp1_x, opp1_y,
+				last_opp1, robot_moved))
+		set_opponent_poly(OPP1, pol_opp1, &robot_pt, O_WIDTH, O_LENGTH);
+
+	if (opponent_poly_moved(OPP2, &robot_pt, opp2_x, opp2_y,
+				last_opp2, robot_moved))
+		set_opponent_poly(OPP2, pol_opp2, &robot_pt, O_WIDTH, O_LENGTH);
+
+	if (robot_moved || distance_between(robot_2nd_x, robot_2nd_y,
+			last_robot_2nd_x, last_robot_2nd_y) > REPLAN_MOVE_THRES)
+		set_opponent_poly(ROBOT2ND, pol_robot_2nd, &robot_pt, ROBOT_2ND_WIDTH, ROBOT_2ND_LENGTH);
 
   /* static play elements poly */
-  pol_heartfire = oa_new_poly(5);
-  set_heartfire_poly(pol_heartfire, &robot_pt, heartfire_r);
+	if (robot_moved)
+		set_heartfire_poly(pol_heartfire, &robot_pt, heartfire_r);
+
+	oa_ready = 1;
+	polys_reduced = 0;
+	last_robot_pt = robot_pt;
+	last_robot_2nd_x = robot_2nd_x;
+	last_robot_2nd_y = robot_2nd_y;
 
 	/* if we are not in the limited area, try to go in it. */
 	ret = go_in_area(&robot_pt);
@@ -1058,6 +1362,10 @@ retry:
 	/* now start to avoid */
 	while (opp1_w && opp1_l && opp2_w && opp2_l) {
 
+#ifdef HOST_VERSION_OA_TEST
+		g_oa_loops ++;
+#endif
+
     /* escape from polys */
 		/* XXX robot_pt is not updated if it fails */		
 		ret = escape_from_poly(&robot_pt, robot_2nd_x, robot_2nd_y,
@@ -1071,6 +1379,14 @@ retry:
 
 		if (ret == 0) {
 
+			/* straight line to destination, skip oa */
+			if (is_direct_path(&robot_pt, &p_dst, pol_opp1, pol_opp2,
+					   pol_heartfire, pol_robot_2nd)) {
+				direct_path = 1;
+				len = 1;
+				break;
+			}
+
  			/* reset and set start and end points */
 			oa_reset();
 			oa_start_end_points(robot_pt.x, robot_pt.y, x, y);
@@ -1090,6 +1406,7 @@ retry:
 			opp1_w /= 2;
 
 			NOTICE(E_USER_STRAT, "reducing opponent 1 %d %d", opp1_w, opp1_l);
+			polys_reduced = 1;
 			set_opponent_poly(OPP1, pol_opp1, &robot_pt, opp1_w, opp1_l);
 		}
 
@@ -1099,6 +1416,7 @@ retry:
 			opp2_w /= 2;
 
 			NOTICE(E_USER_STRAT, "reducing opponent 2 %d %d", opp2_w, opp2_l);
+			polys_reduced = 1;
 			set_opponent_poly(OPP2, pol_opp2, &robot_pt, opp2_w, opp2_l);
 		}
 
@@ -1106,6 +1424,7 @@ retry:
       heartfire_r = HEARTFIRE_RAD2;
 
 			NOTICE(E_USER_STRAT, "reducing heart of fire r=%d", heartfire_r);
+			polys_reduced = 1;
 			set_heartfire_poly(pol_heartfire, &robot_pt, heartfire_r);
 		}
 
@@ -1128,27 +1447,34 @@ retry:
 	}
 
 	/* execute path */
-	p = oa_get_path();
+	if (direct_path)
+		p = &p_dst;
+	else
+		p = oa_get_path();
+
+	/* arcs only when the direction is known, in auto mode the
+	 * trajectory manager chooses it for each point */
+#ifndef HOST_VERSION_OA_TEST
+	len = oa_path_smooth(path, &robot_pt, p, len, direction != GO_AVOID_AUTO);
+#else
+	len = oa_path_smooth(path, &robot_pt, p, len, 1);
+#endif
+
 	for (i=0 ; i<len ; i++) {
 
 #ifndef HOST_VERSION_OA_TEST
-		
-//		if (d<20){
-//			p++;
-//			continue;
-//		}
 
 		if (direction == GO_AVOID_FORWARD){
-			DEBUG(E_USER_STRAT, "With avoidance %d: x=%"PRId32" y=%"PRId32" forward", i, (int32_t)p->x, (int32_t)p->y);
-			trajectory_goto_forward_xy_abs(&mainboard.traj, p->x, p->y);
+			DEBUG(E_USER_STRAT, "With avoidance %d: x=%d y=%d forward", i, path[i].x, path[i].y);
+			trajectory_goto_forward_xy_abs(&mainboard.traj, path[i].x, path[i].y);
 		}
 		else if(direction == GO_AVOID_BACKWARD){
-			DEBUG(E_USER_STRAT, "With avoidance %d: x=%"PRId32" y=%"PRId32" backward", i, (int32_t)p->x, (int32_t)p->y);
-			trajectory_goto_backward_xy_abs(&mainboard.traj, p->x, p->y);
+			DEBUG(E_USER_STRAT, "With avoidance %d: x=%d y=%d backward", i, path[i].x, path[i].y);
+			trajectory_goto_backward_xy_abs(&mainboard.traj, path[i].x, path[i].y);
 		}
 		else {
-			DEBUG(E_USER_STRAT, "With avoidance %d: x=%"PRId32" y=%"PRId32" forward", i, (int32_t)p->x, (int32_t)p->y);
-			trajectory_goto_xy_abs(&mainboard.traj, p->x, p->y);
+			DEBUG(E_USER_STRAT, "With avoidance %d: x=%d y=%d forward", i, path[i].x, path[i].y);
+			trajectory_goto_xy_abs(&mainboard.traj, path[i].x, path[i].y);
 		}
 		
 		/* no END_NEAR for the last point */
@@ -1157,6 +1483,30 @@ retry:
 		else
 			ret = wait_traj_end(flags_intermediate);
 
+		/* corner arc, done when we are heading to the next point.
+		 * Going backward the heading is the path one + 180 and it
+		 * turns the same way */
+		if (TRAJ_SUCCESS(ret) && path[i].radius) {
+			DEBUG(E_USER_STRAT, "With avoidance arc %d: cx=%d cy=%d r=%d a=%d",
+			      i, path[i].cx, path[i].cy, path[i].radius, path[i].a_deg);
+			out_a = path[i].out_a;
+			if (direction == GO_AVOID_BACKWARD)
+				out_a += 180;
+			trajectory_circle_rel(&mainboard.traj, path[i].cx, path[i].cy,
+					      path[i].radius, ABS(path[i].a_deg),
+					      (path[i].a_deg > 0? TRIGO: 0) |
+					      (direction == GO_AVOID_BACKWARD? 0: FORWARD));
+			ret = WAIT_COND_OR_TRAJ_END(
+				ABS(angle_abs_to_rel(out_a)) < SMOOTH_ARC_NEAR_DEG,
+				flags_intermediate & ~END_NEAR);
+			if (ret == 0)
+				ret = END_NEAR;
+			else if (ret == END_OBSTACLE)
+				strat_infos.stats.end_obstacle ++;
+			else if (ret == END_BLOCKING)
+				strat_infos.stats.end_blocking ++;
+		}
+
 		if (ret == END_BLOCKING) {
 			DEBUG(E_USER_STRAT, "Retry avoidance %s(%d,%d)",
 			      __FUNCTION__, x, y);
@@ -1173,12 +1523,14 @@ retry:
 			return ret;
 		}
 
+#else
+		DEBUG(E_USER_STRAT, "With avoidance %d: x=%d y=%d", i, path[i].x, path[i].y);
+		if (path[i].radius) {
+			g_oa_arcs ++;
+			DEBUG(E_USER_STRAT, "With avoidance arc %d: cx=%d cy=%d r=%d a=%d",
+			      i, path[i].cx, path[i].cy, path[i].radius, path[i].a_deg);
+		}
 #endif /* HOST_VERSION_OA_TEST */
-
-		DEBUG(E_USER_STRAT, "With avoidance %d: x=%"PRId32" y=%"PRId32"", i, (int32_t)p->x, (int32_t)p->y);		
-
-		/* next point */
-		p++;
 	}
 	
 	return END_TRAJ;
@@ -1186,6 +1538,20 @@ retry:
 
 #ifndef HOST_VERSION_OA_TEST
 
+/* account time spent in __goto_and_avoid(), see strat_infos.stats */
+static int8_t __goto_and_avoid_timed(int16_t x, int16_t y,
+			       uint8_t flags_intermediate,
+			       uint8_t flags_final, uint8_t direction)
+{
+	microseconds us = time_get_us2();
+	int8_t ret;
+
+	ret = __goto_and_avoid(x, y, flags_intermediate, flags_final, direction);
+	strat_infos.stats.goto_avoid_us += time_get_us2() - us;
+
+	return ret;
+}
+
 /* go to a x,y point. prefer backward but go forward if the point is
  * near and in front of us */
 uint8_t goto_and_avoid(int16_t x, int16_t y, uint8_t flags_intermediate,
@@ -1197,15 +1563,15 @@ uint8_t goto_and_avoid(int16_t x, int16_t y, uint8_t flags_intermediate,
 
   if(robots_are_near()) {
       DEBUG(E_USER_STRAT, "Robots near");
-		  return __goto_and_avoid(x, y, flags_intermediate,
+		  return __goto_and_avoid_timed(x, y, flags_intermediate,
 					  flags_final, GO_AVOID_AUTO);
   }
   else { /* XXX specific 2014 */
 	  if (d < 300 && a < RAD(90) && a > RAD(-90))
-		  return __goto_and_avoid(x, y, flags_intermediate,
+		  return __goto_and_avoid_timed(x, y, flags_intermediate,
 					  flags_final, GO_AVOID_FORWARD);
 	  else
-		  return __goto_and_avoid(x, y, flags_intermediate,
+		  return __goto_and_avoid_timed(x, y, flags_intermediate,
 					  flags_final, GO_AVOID_BACKWARD);
   }
 }
@@ -1216,7 +1582,7 @@ uint8_t goto_and_avoid(int16_t x, int16_t y, uint8_t flags_intermediate,
 uint8_t goto_and_avoid(int16_t x, int16_t y, uint8_t flags_intermediate,
 			       uint8_t flags_final)
 {
-	return __goto_and_avoid(x, y, flags_intermediate, flags_final, GO_AVOID_AUTO);
+	return __goto_and_avoid_timed(x, y, flags_intermediate, flags_final, GO_AVOID_AUTO);
 }
 #endif
 
@@ -1224,14 +1590,14 @@ uint8_t goto_and_avoid(int16_t x, int16_t y, uint8_t flags_intermediate,
 uint8_t goto_and_avoid_forward(int16_t x, int16_t y, uint8_t flags_intermediate,
 			       uint8_t flags_final)
 {
-	return __goto_and_avoid(x, y, flags_intermediate, flags_final, GO_AVOID_FORWARD);
+	return __goto_and_avoid_timed(x, y, flags_intermediate, flags_final, GO_AVOID_FORWARD);
 }
 
 /* go backward to a x,y point. use current speed for that */
 uint8_t goto_and_avoid_backward(int16_t x, int16_t y, uint8_t flags_intermediate,
 		       uint8_t flags_final)
 {
-	return __goto_and_avoid(x, y, flags_intermediate, flags_final, GO_AVOID_BACKWARD);
+	return __goto_and_avoid_timed(x, y, flags_intermediate, flags_final, GO_AVOID_BACKWARD);
 }
 
 
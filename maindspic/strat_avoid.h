@@ -27,6 +27,8 @@
  *  strat_avoid.h,v 1.4 2009/05/27 20:04:07 zer0 Exp.
  */
 
+/* precompute static playground polys, at boot */
+void strat_avoid_static_init(void);
 
 #ifndef HOST_VERSION_OA_TEST
 int8_t goto_and_avoid(int16_t x, int16_t y, uint8_t flags_intermediate,
@@ -355,6 +355,7 @@ void strat_limit_speed(void)
 	int16_t d[NB_OPPONENTS], a[NB_OPPONENTS];
 	int8_t ret[NB_OPPONENTS];
 	uint16_t lim_d_save = 0, lim_a_save = 0;
+	int16_t opp_x, opp_y;
 	uint8_t i;
 	#endif
 
@@ -363,8 +364,9 @@ void strat_limit_speed(void)
 
 
 #ifdef TWO_OPPONENTS
-	ret[0] = get_opponent1_da(&d[0], &a[0]);
-	ret[1] = get_opponent2_da(&d[1], &a[1]);
+	/* opponents position compensated with the age of the beacon fix */
+	ret[0] = get_opponent_xyda_now(0, &opp_x, &opp_y, &d[0], &a[0]);
+	ret[1] = get_opponent_xyda_now(1, &opp_x, &opp_y, &d[1], &a[1]);
 #ifdef ROBOT_2ND
 	ret[2] = get_robot_2nd_da(&d[2], &a[2]);
 #endif
@@ -573,10 +575,11 @@ uint8_t __strat_obstacle(uint8_t which)
 #endif
 
 #ifdef TWO_OPPONENTS
+	/* opponents position compensated with the age of the beacon fix */
 	if(which == OBSTACLE_OPP1)
-		ret = get_opponent1_xyda(&opp_x, &opp_y,&opp_d, &opp_a);
+		ret = get_opponent_xyda_now(0, &opp_x, &opp_y,&opp_d, &opp_a);
 	else if(which == OBSTACLE_OPP2)
-		ret = get_opponent2_xyda(&opp_x, &opp_y,&opp_d, &opp_a);
+		ret = get_opponent_xyda_now(1, &opp_x, &opp_y,&opp_d, &opp_a);
 #ifdef ROBOT_2ND
 	else if(which == OBSTACLE_R2ND)
 		ret = get_robot_2nd_xyda(&opp_x, &opp_y,&opp_d, &opp_a);
@@ -726,7 +729,16 @@ uint8_t __wait_traj_end_debug(uint8_t why, uint16_t line)
 
 	while (ret == 0){
 		ret = test_traj_end(why);
+		if (ret == 0)
+			HOST_IDLE();
 	}
+
+	/* match statistics */
+	if (ret == END_OBSTACLE)
+		strat_infos.stats.end_obstacle ++;
+	else if (ret == END_BLOCKING)
+		strat_infos.stats.end_blocking ++;
+
 	if (ret == END_OBSTACLE) {
 		if (get_opponent1_xyda(&opp_x, &opp_y,
 				      &opp_d, &opp_a) != -1)
@@ -93,7 +93,8 @@ uint8_t strat_begin(void)
 	//WAIT_COND_OR_TIMEOUT(robot_2nd_x_is_more_than(500),5000);
 
 
-	while(!robot_2nd_x_is_more_than(500));
+	while(!robot_2nd_x_is_more_than(500))
+		HOST_IDLE();
 
 	//trajectory_d_rel(&mainboard.traj,250);
 	//err = wait_traj_end(TRAJ_FLAGS_SMALL_DIST);
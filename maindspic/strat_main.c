@@ -60,6 +60,7 @@
 #include "strat_base.h"
 #include "strat_avoid.h"
 #include "strat_utils.h"
+#include "fast_math.h"
 #include "sensor.h"
 #include "actuator.h"
 #include "beacon.h"
@@ -116,12 +117,9 @@ uint8_t strat_is_valid_zone(uint8_t zone_num)
 		return 0;	
 	}
 
-	if(strat_infos.zones[zone_num].type==ZONE_TYPE_BASKET)
-	{
-		if(strat_infos.harvested_trees==0)
-			return 0;
-	}
-	else
+	/* baskets need harvested trees, the planner checks it along each
+	 * sequence and strat_get_new_zone() with the current ones */
+	if(strat_infos.zones[zone_num].type!=ZONE_TYPE_BASKET)
 	{
 		if(strat_infos.zones[zone_num].flags & ZONE_CHECKED)
 		{
@@ -139,6 +137,341 @@ uint8_t strat_is_valid_zone(uint8_t zone_num)
 	return 1;
 }
 
+/*
+ * Zone planner. Sequences of up to PLAN_DEPTH zones are scored by
+ * value per second, value is points*PLAN_POINTS_WEIGHT + prio and time
+ * is travel plus work. The search is iterative deepening and every
+ * prefix is a plan, so when the CPU budget is over we have the best
+ * plan of the zones evaluated so far.
+ */
+#define PLAN_DEPTH			3
+#define PLAN_BUDGET_US		20000L
+#define PLAN_SPEED			500		/* mm/s, average with accelerations */
+#define PLAN_GOTO_MS		500		/* turn and accelerate */
+#define PLAN_POINTS_WEIGHT	10
+
+/* time to work on a zone, by type */
+static const uint16_t plan_work_ms[ZONE_TYPE_MAX] = {
+	[ZONE_TYPE_TREE] = 5000,
+	[ZONE_TYPE_FIRE] = 2000,
+	[ZONE_TYPE_HEART] = 3000,
+	[ZONE_TYPE_TORCH] = 4000,
+	[ZONE_TYPE_M_TORCH] = 4000,
+	[ZONE_TYPE_FRESCO] = 3000,
+	[ZONE_TYPE_MAMOOTH] = 3000,
+	[ZONE_TYPE_BASKET] = 3000,
+	[ZONE_TYPE_HOME] = 0,
+};
+
+struct plan_state {
+	int16_t x;					/* robot position */
+	int16_t y;
+	int32_t time_ms;			/* time of the sequence */
+	int32_t value;
+	uint8_t harvested_trees;
+	uint32_t done;				/* zones in the sequence */
+	uint8_t first;				/* first zone of the sequence */
+	int8_t last;				/* last zone, -1 at robot position */
+};
+
+static struct {
+	microseconds start_us;
+	uint8_t timeout;
+	int32_t time_left_ms;
+	uint32_t valid;				/* strat_is_valid_zone(), baskets even
+								 * without harvested trees */
+	int32_t best_rate;
+	int8_t best_zone;
+	uint16_t nodes;
+} plan;
+
+/*
+ * Zone to zone travel cost matrix. Costs are the shortest path length
+ * around the heartfire disc, computed once per color at strat_init()
+ * for every pair of zone entry points (triangular storage, i < j).
+ *
+ * Each pair also keeps the mask of CELLS_X*CELLS_Y area cells crossed by
+ * its straight line. The opponents are not in the matrix, the cells they
+ * occupy are updated once per planning and a pair crossing one of them is
+ * penalized at lookup, so the matrix is invalidated lazily and never
+ * recomputed during the match.
+ */
+#define COST_HEART_X		1500
+#define COST_HEART_Y		1050
+#define COST_HEART_R		470		/* heartfire poly external radius */
+
+#define CELLS_X				4
+#define CELLS_Y				4
+#define CELL_SIZE_X			(AREA_X/CELLS_X)
+#define CELL_SIZE_Y			(AREA_Y/CELLS_Y)
+#define CELLS_STEP			100		/* mm, sampling of the line */
+
+#define COST_BLOCKED_MS		3000	/* path crossing an opponent cell */
+
+#define COST_PAIRS			((ZONES_MAX * (ZONES_MAX - 1)) / 2)
+#define COST_INDEX(i, j)	(((j) * ((j) - 1)) / 2 + (i))	/* i < j */
+
+static struct {
+	uint8_t color;				/* color of the matrix, 0xFF if not built */
+	uint16_t opp_cells;			/* cells occupied by the opponents */
+	uint16_t ms[COST_PAIRS];
+	uint16_t cells[COST_PAIRS];
+} zone_cost = { .color = 0xFF };
+
+/* shortest path length between two points around the heartfire disc */
+static int16_t strat_path_len(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	int32_t dx, dy, cx, cy, l2, t;
+	int16_t d, d1, d2, t1, t2, a;
+
+	d = distance_between(x1, y1, x2, y2);
+
+	/* closest point of the segment to the disc center */
+	dx = x2 - x1;
+	dy = y2 - y1;
+	cx = COST_HEART_X - x1;
+	cy = COST_HEART_Y - y1;
+	l2 = dx*dx + dy*dy;
+	t = (l2 == 0) ? 0 : ((cx*dx + cy*dy) * 256L) / l2;
+	if (t < 0)
+		t = 0;
+	if (t > 256)
+		t = 256;
+
+	if (distance_between(x1 + (dx * t) / 256, y1 + (dy * t) / 256,
+	                     COST_HEART_X, COST_HEART_Y) >= COST_HEART_R)
+		return d;
+
+	/* points inside the disc, go through */
+	d1 = distance_between(x1, y1, COST_HEART_X, COST_HEART_Y);
+	d2 = distance_between(x2, y2, COST_HEART_X, COST_HEART_Y);
+	if (d1 <= COST_HEART_R || d2 <= COST_HEART_R)
+		return d;
+
+	/* tangent segments plus the arc between tangent points */
+	t1 = sqrt((int32_t)d1*d1 - (int32_t)COST_HEART_R*COST_HEART_R);
+	t2 = sqrt((int32_t)d2*d2 - (int32_t)COST_HEART_R*COST_HEART_R);
+
+	a = fast_atan2(y1 - COST_HEART_Y, x1 - COST_HEART_X) -
+		fast_atan2(y2 - COST_HEART_Y, x2 - COST_HEART_X);
+	a = ABS(simple_modulo_360(a));
+	a -= fast_atan2(t1, COST_HEART_R) + fast_atan2(t2, COST_HEART_R);
+	if (a <= 0)
+		return d;
+
+	return t1 + t2 + ((int32_t)COST_HEART_R * a * 314L) / 18000L;
+}
+
+static uint8_t strat_cell(int16_t x, int16_t y)
+{
+	x = x / CELL_SIZE_X;
+	y = y / CELL_SIZE_Y;
+	x = (x < 0) ? 0 : (x >= CELLS_X ? CELLS_X - 1 : x);
+	y = (y < 0) ? 0 : (y >= CELLS_Y ? CELLS_Y - 1 : y);
+
+	return y * CELLS_X + x;
+}
+
+/* mask of cells crossed by the line between two points */
+static uint16_t strat_line_cells(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	uint16_t cells = 0;
+	int16_t n, k;
+
+	n = distance_between(x1, y1, x2, y2) / CELLS_STEP + 1;
+	for (k = 0; k <= n; k++)
+		cells |= 1 << strat_cell(x1 + ((int32_t)(x2 - x1) * k) / n,
+		                         y1 + ((int32_t)(y2 - y1) * k) / n);
+
+	return cells;
+}
+
+static int32_t strat_path_ms(int16_t len)
+{
+	return PLAN_GOTO_MS + ((int32_t)len * 1000L) / PLAN_SPEED;
+}
+
+/* build the zone costs matrix for our color, if not done yet */
+void strat_zone_cost_init(void)
+{
+	int16_t x1, y1, x2, y2;
+	uint8_t i, j;
+	uint16_t k;
+
+	if (zone_cost.color == mainboard.our_color)
+		return;
+
+	for (j = 1; j < ZONES_MAX; j++) {
+		x2 = COLOR_X(strat_infos.zones[j].init_x);
+		y2 = strat_infos.zones[j].init_y;
+
+		for (i = 0; i < j; i++) {
+			x1 = COLOR_X(strat_infos.zones[i].init_x);
+			y1 = strat_infos.zones[i].init_y;
+
+			k = COST_INDEX(i, j);
+			zone_cost.ms[k] = strat_path_ms(strat_path_len(x1, y1, x2, y2));
+			zone_cost.cells[k] = strat_line_cells(x1, y1, x2, y2);
+		}
+	}
+
+	zone_cost.opp_cells = 0;
+	zone_cost.color = mainboard.our_color;
+}
+
+/* update the cells occupied by the opponents */
+void strat_zone_cost_update(void)
+{
+	int16_t x, y;
+
+	zone_cost.opp_cells = 0;
+	if (get_opponent1_xy(&x, &y) == 0)
+		zone_cost.opp_cells |= 1 << strat_cell(x, y);
+	if (get_opponent2_xy(&x, &y) == 0)
+		zone_cost.opp_cells |= 1 << strat_cell(x, y);
+}
+
+/* travel time between the entry points of two zones */
+int32_t strat_zone_cost_ms(uint8_t from, uint8_t to)
+{
+	uint16_t k;
+	int32_t ms;
+
+	if (from == to)
+		return 0;
+
+	k = (from < to) ? COST_INDEX(from, to) : COST_INDEX(to, from);
+	ms = zone_cost.ms[k];
+	if (zone_cost.cells[k] & zone_cost.opp_cells)
+		ms += COST_BLOCKED_MS;
+
+	return ms;
+}
+
+/* travel time between a point and the entry point of a zone */
+int32_t strat_zone_travel_ms(int16_t x, int16_t y, uint8_t zone_num)
+{
+	int16_t x2, y2;
+	int32_t ms;
+
+	x2 = COLOR_X(strat_infos.zones[zone_num].init_x);
+	y2 = strat_infos.zones[zone_num].init_y;
+
+	ms = strat_path_ms(strat_path_len(x, y, x2, y2));
+	if (strat_line_cells(x, y, x2, y2) & zone_cost.opp_cells)
+		ms += COST_BLOCKED_MS;
+
+	return ms;
+}
+
+static void strat_plan_dfs(struct plan_state *s, uint8_t depth)
+{
+	struct plan_state next;
+	int32_t rate;
+	uint8_t i;
+
+	if (depth == 0 || plan.timeout)
+		return;
+
+	for (i = 0; i < ZONES_MAX; i++) {
+
+		/* check the budget from time to time */
+		if ((++plan.nodes & 0x0F) == 0 &&
+		    time_get_us2() - plan.start_us > PLAN_BUDGET_US) {
+			plan.timeout = 1;
+			return;
+		}
+
+		if ((s->done & (1UL << i)) || !(plan.valid & (1UL << i)))
+			continue;
+
+		next = *s;
+		next.done |= (1UL << i);
+		if (s->done == 0)
+			next.first = i;
+
+		/* the secondary robot zones cost no main robot time,
+		 * and it stays where it is */
+		if (strat_infos.zones[i].robot == MAIN_ROBOT) {
+			next.last = i;
+			if (s->last < 0)
+				next.time_ms += strat_zone_travel_ms(s->x, s->y, i);
+			else
+				next.time_ms += strat_zone_cost_ms(s->last, i);
+			next.time_ms += plan_work_ms[strat_infos.zones[i].type];
+			if (next.time_ms > plan.time_left_ms)
+				continue;
+
+			next.x = COLOR_X(strat_infos.zones[i].init_x);
+			next.y = strat_infos.zones[i].init_y;
+		}
+
+		/* points, fruits are scored in the basket */
+		if (strat_infos.zones[i].type == ZONE_TYPE_TREE) {
+			next.harvested_trees ++;
+		}
+		else if (strat_infos.zones[i].type == ZONE_TYPE_BASKET) {
+			if (next.harvested_trees == 0)
+				continue;
+			next.value += next.harvested_trees * 3 * PLAN_POINTS_WEIGHT;
+			next.harvested_trees = 0;
+		}
+		else
+			next.value += strat_zones_points[i] * PLAN_POINTS_WEIGHT;
+
+		next.value += strat_infos.zones[i].prio;
+
+		/* this sequence is a plan, if the main robot works in it */
+		if (next.time_ms > 0) {
+			rate = (next.value * 1000L) / next.time_ms;
+			if (rate > plan.best_rate) {
+				plan.best_rate = rate;
+				plan.best_zone = next.first;
+			}
+		}
+
+		strat_plan_dfs(&next, depth - 1);
+	}
+}
+
+/* return the first zone of the best plan, -1 if there is no plan */
+int8_t strat_plan_zone(void)
+{
+	struct plan_state s;
+	uint8_t depth, i;
+
+	memset(&s, 0, sizeof(s));
+	s.x = position_get_x_s16(&mainboard.pos);
+	s.y = position_get_y_s16(&mainboard.pos);
+	s.harvested_trees = strat_infos.harvested_trees;
+	s.last = -1;
+
+	strat_zone_cost_init();
+	strat_zone_cost_update();
+
+	plan.start_us = time_get_us2();
+	plan.timeout = 0;
+	plan.time_left_ms = (MATCH_TIME - time_get_s()) * 1000L;
+	plan.best_rate = 0;
+	plan.best_zone = -1;
+	plan.nodes = 0;
+
+	plan.valid = 0;
+	for (i = 0; i < ZONES_MAX; i++) {
+		if (strat_is_valid_zone(i))
+			plan.valid |= (1UL << i);
+	}
+
+	for (depth = 1; depth <= PLAN_DEPTH && !plan.timeout; depth++)
+		strat_plan_dfs(&s, depth);
+
+	DEBUG(E_USER_STRAT, "plan: zone %d rate %"PRId32" depth %d nodes %d us %"PRIu32,
+	      plan.best_zone, plan.best_rate, depth - 1, plan.nodes,
+	      (uint32_t)(time_get_us2() - plan.start_us));
+
+	return plan.best_zone;
+}
+
 /* return new work zone, -1 if any zone is found */
 int8_t strat_get_new_zone(void)
 {
@@ -155,17 +488,22 @@ int8_t strat_get_new_zone(void)
 			return ZONE_TREE_1;
 #endif	
 
+	/* best plan of zones */
+	zone_num = strat_plan_zone();
+
 	/* evaluate zones */
 	for(i=0; i < ZONES_MAX; i++) 
 	{
 		//printf_P("---i: %d\n",i);
 		
-		/* check if is a valid zone */
-		if(!strat_is_valid_zone(i))	
+		/* check if is a valid zone, as evaluated by the planner */
+		if(!(plan.valid & (1UL << i)))
+			continue;
+		if((strat_infos.zones[i].type==ZONE_TYPE_BASKET) && (strat_infos.harvested_trees==0))
 			continue;
 
-		/* compare current priority */
-		if(strat_infos.zones[i].prio >= prio_max) {
+		/* no plan with value, by priority */
+		if(plan.best_rate == 0 && strat_infos.zones[i].prio >= prio_max) {
 
 			prio_max = strat_infos.zones[i].prio;
 			zone_num = i;
@@ -564,6 +902,7 @@ uint8_t strat_smart(void)
 {
 	int8_t zone_num;
 	uint8_t err;
+	uint8_t harvested_trees;
 
 	/* recalculate priorities NOTYET */
 	
@@ -608,6 +947,7 @@ uint8_t strat_smart(void)
 		strat_infos.current_zone = strat_infos.goto_zone;
 		strat_dump_infos(__FUNCTION__);
 
+		harvested_trees = strat_infos.harvested_trees;
 		err = strat_work_on_zone(zone_num);
 		if (!TRAJ_SUCCESS(err)) {
 			//printf_P(PSTR("Work on zone %s fails.\r\n"), numzone2name[zone_num]);
@@ -615,6 +955,13 @@ uint8_t strat_smart(void)
 		else
 		{
 			// Switch off devices, go back to normal state if anything was deployed
+
+			/* match statistics, basket points depends on trees harvested */
+			strat_infos.stats.zones_done ++;
+			if (strat_infos.zones[zone_num].type == ZONE_TYPE_BASKET)
+				strat_infos.stats.points += harvested_trees * 3;
+			else
+				strat_infos.stats.points += strat_zones_points[zone_num];
 		}
 
 		/* mark the zone as checked */
@@ -65,6 +65,7 @@
 #include "strat_base.h"
 #include "sensor.h"
 #include "i2c_protocol.h"
+#include "opp_tracker.h"
 
 /* return the distance between two points */
 int16_t distance_between(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
@@ -396,49 +397,6 @@ uint8_t robot_2nd_y_is_more_than(int16_t y)
    return 0;
 }
 
-int16_t sin_table[] = {
-	0,
-	3211,
-	6392,
-	9512,
-	12539,
-	15446,
-	18204,
-	20787,
-	23170,
-	25330,
-	27245,
-	28898,
-	30273,
-	31357,
-	32138,
-	32610,
-	32767,
-};
-
-int16_t fast_sin(int16_t deg)
-{
-	deg %= 360;
-	
-	if (deg < 0)
-		deg += 360;
-
-	if (deg < 90) 
-		return sin_table[(deg*16)/90];
-	else if (deg < 180) 
-		return sin_table[((180-deg)*16)/90];
-	else if (deg < 270) 
-		return -sin_table[((deg-180)*16)/90];
-	else
-		return -sin_table[((360-deg)*16)/90];
-}
-
-int16_t fast_cos(int16_t deg)
-{
-	return fast_sin(90+deg);
-}
-
-
 /* get the color of our robot */
 uint8_t get_color(void)
 {
@@ -524,6 +482,314 @@ int8_t get_best_opponent2_xyda (int16_t *x, int16_t *y, int16_t *d, int16_t *a)
 
 #endif
 
+/* capture time of the opponent position, see bt_beacon_status_parser() */
+static microseconds get_opponent_time_us(uint8_t num)
+{
+	microseconds t;
+	uint8_t flags;
+
+	IRQ_LOCK(flags);
+#ifdef TWO_OPPONENTS
+	if (num == 1)
+		t = beaconboard.opponent2_time_us;
+	else
+#endif
+		t = beaconboard.opponent1_time_us;
+	IRQ_UNLOCK(flags);
+
+	return t;
+}
+
+/* 
+ * Opponent velocity estimation. The beacon refresh is slower than the
+ * call period, so a sample is only taken when the position changes or
+ * after OPP_V_STILL_US without changes (opponent stopped). Velocity is
+ * computed with the capture times of the samples, not with the
+ * reception times.
+ */
+#define OPP_V_STILL_US		150000L	/* no change, opponent is stopped */
+#define OPP_V_TIMEOUT_US	500000L	/* too old sample, restart */
+#define OPP_V_MIN_DT_US		20000L	/* same capture, jitter of the age */
+#define OPP_V_MAX			1500	/* mm/s, beacon jumps */
+#define OPP_V_FILTER_SHIFT	2		/* filter gain 1/4 */
+
+static void opponent_velocity_update(struct opp_velocity *v, int8_t err,
+				     int16_t x, int16_t y, microseconds t)
+{
+	microseconds now = time_get_us2();
+	int32_t dt_ms, vx, vy;
+
+	if (err == -1) {
+		v->valid = 0;
+		return;
+	}
+
+	/* first sample */
+	if (!v->valid || (now - v->time_us) > OPP_V_TIMEOUT_US) {
+		v->x = x;
+		v->y = y;
+		v->time_us = t;
+		v->vx = 0;
+		v->vy = 0;
+		v->valid = 1;
+		return;
+	}
+
+	/* wait for a new beacon sample */
+	if (x == v->x && y == v->y && (now - v->time_us) < OPP_V_STILL_US)
+		return;
+
+	/* same capture */
+	if ((int32_t)(t - v->time_us) < OPP_V_MIN_DT_US)
+		return;
+
+	dt_ms = (t - v->time_us) / 1000L;
+
+	vx = ((int32_t)(x - v->x) * 1000L) / dt_ms;
+	vy = ((int32_t)(y - v->y) * 1000L) / dt_ms;
+
+	if (vx > OPP_V_MAX) vx = OPP_V_MAX;
+	if (vx < -OPP_V_MAX) vx = -OPP_V_MAX;
+	if (vy > OPP_V_MAX) vy = OPP_V_MAX;
+	if (vy < -OPP_V_MAX) vy = -OPP_V_MAX;
+
+	v->vx += (vx - v->vx) >> OPP_V_FILTER_SHIFT;
+	v->vy += (vy - v->vy) >> OPP_V_FILTER_SHIFT;
+	v->x = x;
+	v->y = y;
+	v->time_us = t;
+}
+
+void opponents_velocity_update(void)
+{
+	int16_t x, y;
+	int8_t err;
+
+	err = get_opponent1_xy(&x, &y);
+	opponent_velocity_update(&strat_infos.opp_v[0], err, x, y,
+				 get_opponent_time_us(0));
+
+#ifdef TWO_OPPONENTS
+	err = get_opponent2_xy(&x, &y);
+	opponent_velocity_update(&strat_infos.opp_v[1], err, x, y,
+				 get_opponent_time_us(1));
+#endif
+}
+
+/* 
+ * Opponents tracker feed. Beacon positions are given on a new capture,
+ * robot 2nd positions on a new status frame if they changed (the robot
+ * 2nd repeats its last beacon data). The track of each beacon opponent
+ * is kept, so the getters below keep the beacon numbering.
+ */
+#ifdef TWO_OPPONENTS
+#define OPP_NUM		2
+#else
+#define OPP_NUM		1
+#endif
+
+static int8_t opp_track_num[2] = {-1, -1};
+
+void opponents_tracker_update(void)
+{
+	static microseconds beacon_time_us[OPP_NUM];
+	int16_t x[OPP_TRACK_MAX], y[OPP_TRACK_MAX];
+	uint32_t t[OPP_TRACK_MAX];
+	int8_t num[OPP_TRACK_MAX];
+	uint8_t opp[OPP_TRACK_MAX];
+	uint8_t i, n = 0;
+	microseconds t_i;
+#ifdef ROBOT_2ND
+	static uint16_t robot_2nd_count;
+	static int16_t robot_2nd_x[OPP_NUM], robot_2nd_y[OPP_NUM];
+	int16_t rx[OPP_NUM], ry[OPP_NUM];
+	uint16_t count;
+	uint8_t flags;
+#endif
+
+	/* beacon */
+	for (i = 0; i < OPP_NUM; i++) {
+		if ((i == 0? get_opponent1_xy(&x[n], &y[n]) :
+			     get_opponent2_xy(&x[n], &y[n])) == -1) {
+			opp_track_num[i] = -1;
+			continue;
+		}
+
+		t_i = get_opponent_time_us(i);
+		if (t_i == beacon_time_us[i])
+			continue;
+
+		beacon_time_us[i] = t_i;
+		t[n] = t_i;
+		opp[n] = i;
+		n++;
+	}
+
+	if (n) {
+		opp_tracker_update(OPP_SRC_BEACON, x, y, t, n, num);
+		for (i = 0; i < n; i++)
+			opp_track_num[opp[i]] = num[i];
+	}
+
+#ifdef ROBOT_2ND
+	IRQ_LOCK(flags);
+	count = robot_2nd.bt_status.count;
+	t_i = robot_2nd.bt_status.time_us;
+	rx[0] = robot_2nd.opponent1_x;
+	ry[0] = robot_2nd.opponent1_y;
+#ifdef TWO_OPPONENTS
+	rx[1] = robot_2nd.opponent2_x;
+	ry[1] = robot_2nd.opponent2_y;
+#endif
+	IRQ_UNLOCK(flags);
+
+	if (count != robot_2nd_count) {
+		robot_2nd_count = count;
+		n = 0;
+
+		for (i = 0; i < OPP_NUM; i++) {
+			if (rx[i] == I2C_OPPONENT_NOT_THERE ||
+			    (rx[i] == robot_2nd_x[i] && ry[i] == robot_2nd_y[i]))
+				continue;
+
+			robot_2nd_x[i] = rx[i];
+			robot_2nd_y[i] = ry[i];
+			x[n] = rx[i];
+			y[n] = ry[i];
+			t[n] = t_i;
+			n++;
+		}
+
+		if (n)
+			opp_tracker_update(OPP_SRC_ROBOT_2ND, x, y, t, n, NULL);
+	}
+#endif
+
+	opp_tracker_manage(time_get_us2());
+}
+
+/* copy of the track of a beacon opponent (0 or 1), -1 if none. The
+ * tracks are updated in the strat event */
+static int8_t get_opponent_track(uint8_t num, struct opp_track *tr)
+{
+	uint8_t flags;
+	int8_t track;
+
+	IRQ_LOCK(flags);
+	track = opp_track_num[num];
+	if (track >= 0)
+		memcpy(tr, opp_tracker_track(track), sizeof(*tr));
+	IRQ_UNLOCK(flags);
+
+	if (track < 0 || tr->valid == 0)
+		return -1;
+	return 0;
+}
+
+/* get the standard deviation in mm of the tracked position of an
+ * opponent (0 or 1), return -1 if not tracked */
+int16_t get_opponent_sigma(uint8_t num)
+{
+	struct opp_track tr;
+	uint16_t sigma;
+
+	if (num > 1 || get_opponent_track(num, &tr) < 0)
+		return -1;
+
+	opp_tracker_get(&tr, time_get_us2(), NULL, NULL, NULL, NULL, &sigma);
+	return sigma > 0x7FFF? 0x7FFF: (int16_t)sigma;
+}
+
+int8_t get_opponent_velocity(uint8_t num, int16_t *vx, int16_t *vy)
+{
+	struct opp_track tr;
+	uint8_t flags;
+	int8_t ret = -1;
+
+	if (num > 1)
+		return -1;
+
+	if (get_opponent_track(num, &tr) == 0)
+		return opp_tracker_get(&tr, 0, NULL, NULL, vx, vy, NULL);
+
+	IRQ_LOCK(flags);
+	if (strat_infos.opp_v[num].valid) {
+		*vx = strat_infos.opp_v[num].vx;
+		*vy = strat_infos.opp_v[num].vy;
+		ret = 0;
+	}
+	IRQ_UNLOCK(flags);
+
+	return ret;
+}
+
+/* get the age in ms of the opponent (0 or 1) position, return -1 if
+ * opponent is not there */
+int32_t get_opponent_age_ms(uint8_t num)
+{
+	int16_t x, y;
+	int8_t err;
+
+	if (num > 1)
+		return -1;
+
+	err = (num == 0? get_opponent1_xy(&x, &y) : get_opponent2_xy(&x, &y));
+	if (err == -1)
+		return -1;
+
+	return (int32_t)((time_get_us2() - get_opponent_time_us(num)) / 1000L);
+}
+
+/* 
+ * Get the position of an opponent (0 or 1) extrapolated to now with
+ * its velocity, the age of the position is limited to
+ * OPP_EXTRAPOLATE_MAX_MS. The tracked position is used when there is
+ * a track. Return -1 if opponent is not there.
+ */
+#define OPP_EXTRAPOLATE_MAX_MS	300
+
+int8_t get_opponent_xyda_now(uint8_t num, int16_t *x, int16_t *y,
+			     int16_t *d, int16_t *a)
+{
+	struct opp_track tr;
+	int16_t vx, vy;
+	int32_t age_ms;
+	double d_tmp, a_tmp;
+
+	if (num > 1)
+		return -1;
+
+	if ((num == 0? get_opponent1_xy(x, y) : get_opponent2_xy(x, y)) == -1)
+		return -1;
+
+	if (get_opponent_track(num, &tr) == 0) {
+		age_ms = (int32_t)((time_get_us2() - tr.time_us) / 1000L);
+		if (age_ms > OPP_EXTRAPOLATE_MAX_MS)
+			age_ms = OPP_EXTRAPOLATE_MAX_MS;
+
+		opp_tracker_get(&tr, tr.time_us + age_ms * 1000L, x, y, NULL, NULL, NULL);
+	}
+	else {
+		age_ms = get_opponent_age_ms(num);
+		if (age_ms > OPP_EXTRAPOLATE_MAX_MS)
+			age_ms = OPP_EXTRAPOLATE_MAX_MS;
+
+		if (age_ms > 0 && get_opponent_velocity(num, &vx, &vy) == 0) {
+			*x += (int16_t)((vx * age_ms) / 1000L);
+			*y += (int16_t)((vy * age_ms) / 1000L);
+		}
+	}
+
+	if (d != NULL && a != NULL) {
+		abs_xy_to_rel_da(*x, *y, &d_tmp, &a_tmp);
+		a_tmp = a_tmp * (180.0 / M_PI);
+		*d = (int16_t)d_tmp;
+		*a = (int16_t)(a_tmp < 0? a_tmp + 360: a_tmp);
+	}
+
+	return 0;
+}
+
 /* get the xy pos of a robot */
 int8_t get_opponent1_xy(int16_t *x, int16_t *y)
 {
@@ -36,12 +36,14 @@ struct xy_point {
 };
 
 /* wait traj end flag or cond. return 0 if cond become true, else
- * return the traj flag */
+ * return the traj flag. HOST_IDLE() is in main.h */
 #define WAIT_COND_OR_TRAJ_END(cond, mask)				\
 	({								\
 		uint8_t __err = 0;					\
 		while ( (! (cond)) && (__err == 0)) {			\
 			__err = test_traj_end(mask);	\
+			if (__err == 0)					\
+				HOST_IDLE();				\
 		}							\
 		__err;							\
 	})								\
@@ -92,6 +94,30 @@ uint8_t y_is_more_than(int16_t y);
  * robot. works in red or green color. */
 uint8_t x_is_more_than(int16_t x);
 
+/* estimate opponents velocity from beacon samples, call it periodically */
+void opponents_velocity_update(void);
+
+/* feed the opponents tracker with beacon and robot 2nd positions,
+ * call it periodically */
+void opponents_tracker_update(void);
+
+/* get the standard deviation in mm of the tracked position of an
+ * opponent (0 or 1), return -1 if not tracked */
+int16_t get_opponent_sigma(uint8_t num);
+
+/* get the velocity of an opponent (0 or 1) in mm/s, return -1 if
+ * unknown */
+int8_t get_opponent_velocity(uint8_t num, int16_t *vx, int16_t *vy);
+
+/* get the age in ms of the opponent (0 or 1) position, return -1 if
+ * opponent is not there */
+int32_t get_opponent_age_ms(uint8_t num);
+
+/* get the position of an opponent (0 or 1) extrapolated to now, d and a
+ * can be NULL, return -1 if opponent is not there */
+int8_t get_opponent_xyda_now(uint8_t num, int16_t *x, int16_t *y,
+			     int16_t *d, int16_t *a);
+
 /* return 1 if x > x_opp or opponent not there */
 uint8_t opp1_x_is_more_than(int16_t x);
 
@@ -110,9 +136,6 @@ uint8_t opp2_y_is_more_than(int16_t y);
 /* return 1 if y > y_opp or opponent not there */
 uint8_t robot_2nd_y_is_more_than(int16_t y);
 
-int16_t fast_sin(int16_t deg);
-int16_t fast_cos(int16_t deg);
-
 
 /* get the color of our robot */
 uint8_t get_color(void);
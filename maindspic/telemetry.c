@@ -0,0 +1,165 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <aversive.h>
+#include <aversive/error.h>
+
+#include <uart.h>
+#include <clock_time.h>
+
+#include <pid.h>
+#include <quadramp.h>
+#include <control_system_manager.h>
+#include <trajectory_manager.h>
+#include <vect_base.h>
+#include <lines.h>
+#include <polygon.h>
+#include <obstacle_avoidance.h>
+#include <blocking_detection_manager.h>
+#include <robot_system.h>
+#include <position_manager.h>
+
+#include <parse.h>
+#include <rdline.h>
+
+#include "../common/i2c_commands.h"
+#include "../common/log_ring.h"
+#include "main.h"
+#include "robotsim.h"
+#include "strat.h"
+#include "strat_utils.h"
+#include "telemetry.h"
+
+static uint8_t telem_div;		/* period in events, 0 is off */
+static uint8_t telem_cpt;
+static uint8_t telem_seq;
+static uint32_t telem_count;
+
+static uint8_t telemetry_put16(uint8_t *buf, uint16_t v)
+{
+	buf[0] = v;
+	buf[1] = v >> 8;
+	return 2;
+}
+
+static uint8_t telemetry_put32(uint8_t *buf, uint32_t v)
+{
+	buf[0] = v;
+	buf[1] = v >> 8;
+	buf[2] = v >> 16;
+	buf[3] = v >> 24;
+	return 4;
+}
+
+/* payload of the robot state, see telemetry.h */
+static uint8_t telemetry_fill(uint8_t *buf)
+{
+	int16_t opp1_x = I2C_OPPONENT_NOT_THERE, opp1_y = 0;
+	int16_t opp2_x = I2C_OPPONENT_NOT_THERE, opp2_y = 0;
+	uint8_t n = 0;
+
+	get_opponent1_xy(&opp1_x, &opp1_y);
+	get_opponent2_xy(&opp2_x, &opp2_y);
+
+	buf[n++] = telem_seq++;
+	n += telemetry_put32(&buf[n], (uint32_t)time_get_us2());
+	n += telemetry_put16(&buf[n], position_get_x_s16(&mainboard.pos));
+	n += telemetry_put16(&buf[n], position_get_y_s16(&mainboard.pos));
+	n += telemetry_put16(&buf[n], position_get_a_deg_s16(&mainboard.pos));
+	n += telemetry_put16(&buf[n], mainboard.speed_d);
+	n += telemetry_put16(&buf[n], mainboard.speed_a);
+	n += telemetry_put32(&buf[n], mainboard.dac_l);
+	n += telemetry_put32(&buf[n], mainboard.dac_r);
+	n += telemetry_put32(&buf[n], cs_get_error(&mainboard.distance.cs));
+	n += telemetry_put32(&buf[n], cs_get_error(&mainboard.angle.cs));
+	n += telemetry_put16(&buf[n], opp1_x);
+	n += telemetry_put16(&buf[n], opp1_y);
+	n += telemetry_put16(&buf[n], opp2_x);
+	n += telemetry_put16(&buf[n], opp2_y);
+	buf[n++] = strat_infos.current_zone;
+	buf[n++] = strat_infos.goto_zone;
+	buf[n++] = mainboard.traj.state;
+	n += telemetry_put16(&buf[n], mainboard.flags);
+	n += telemetry_put16(&buf[n], strat_infos.stats.points);
+	return n;
+}
+
+void telemetry_event(void *dummy)
+{
+	uint8_t frame[TELEMETRY_PAYLOAD_LEN + 4];
+	uint8_t i, n, sum = 0;
+
+	if (telem_div == 0 || ++telem_cpt < telem_div)
+		return;
+	telem_cpt = 0;
+
+	n = telemetry_fill(&frame[3]);
+	for (i = 0; i < n; i++)
+		sum += frame[3 + i];
+	frame[0] = LOG_FRAME_SYNC;
+	frame[1] = n;
+	frame[2] = LOG_FRAME_TELEM;
+	frame[3 + n] = sum;
+
+#ifdef HOST_VERSION
+	robotsim_telemetry_write(frame, n + 4);
+#else
+	for (i = 0; i < n + 4; i++)
+		uart_send(CMDLINE_UART, frame[i]);
+#endif
+	telem_count++;
+}
+
+void telemetry_set_period(uint16_t period_ms)
+{
+	uint32_t div;
+
+	div = ((uint32_t)period_ms * 1000L + EVENT_PERIOD_TELEMETRY / 2) /
+		EVENT_PERIOD_TELEMETRY;
+	if (period_ms && div == 0)
+		div = 1;
+	if (div > 255)
+		div = 255;
+
+	telem_div = div;
+	telem_cpt = 0;
+}
+
+uint16_t telemetry_get_period(void)
+{
+	return (uint16_t)(telem_div * (EVENT_PERIOD_TELEMETRY / 1000L));
+}
+
+uint32_t telemetry_get_count(void)
+{
+	return telem_count;
+}
+
+void telemetry_init(void)
+{
+#ifdef HOST_VERSION
+	if (robotsim_telemetry_enabled())
+		telemetry_set_period(TELEMETRY_PERIOD_HOST);
+#endif
+}
@@ -0,0 +1,62 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Match telemetry. A low priority event sends the robot state every
+ * period as a binary frame, with the framing of the deferred logs
+ * (../common/log_ring.h), type LOG_FRAME_TELEM. On the robot frames go
+ * to the cmdline uart, mixed with the logs and the console. In the host
+ * version they are written to the file or fifo named by the
+ * ROBOTSIM_TELEMETRY environment variable. telemetry.py extracts them
+ * from a capture as columns.
+ *
+ * Payload, little endian, TELEMETRY_PAYLOAD_LEN bytes:
+ *   seq (8), time_us (32),
+ *   x, y, a_deg (16), speed_d, speed_a (16), dac_l, dac_r (32),
+ *   distance and angle cs errors (32),
+ *   opponent1 x, y, opponent2 x, y (16, I2C_OPPONENT_NOT_THERE if lost),
+ *   current_zone, goto_zone, traj state (8), mainboard.flags (16),
+ *   points (16)
+ * A frame takes about 4.3 ms at 115200 bauds.
+ */
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stdint.h>
+
+#define TELEMETRY_PAYLOAD_LEN	46
+#define TELEMETRY_PERIOD_HOST	20	/* ms, host version with ROBOTSIM_TELEMETRY */
+
+/* in the host version, enable telemetry if ROBOTSIM_TELEMETRY is set */
+void telemetry_init(void);
+
+/* period in ms, rounded to EVENT_PERIOD_TELEMETRY, 0 is off */
+void telemetry_set_period(uint16_t period_ms);
+uint16_t telemetry_get_period(void);
+
+/* frames sent */
+uint32_t telemetry_get_count(void);
+
+/* low priority event, same priority as the logs drain */
+void telemetry_event(void *dummy);
+
+#endif
@@ -0,0 +1,86 @@
+# Reader of the match telemetry frames (telemetry.h).
+#
+# Extracts the LOG_FRAME_TELEM frames of a capture of the cmdline uart, or
+# of the ROBOTSIM_TELEMETRY file of the host version, as columns: one
+# list per field, or numpy arrays with --npz. Other bytes (logs, console)
+# are ignored.
+#
+#   cat /dev/ttyUSB0 > capture.bin
+#   python telemetry.py capture.bin -o match.csv
+#
+#   import telemetry
+#   cols = telemetry.read(open("capture.bin", "rb").read())
+#   plot(cols["time_us"], cols["err_d"])
+#
+# Without file reads stdin.
+
+import sys, struct, optparse
+
+FRAME_SYNC = 0xA5
+FRAME_TELEM = 4
+
+# payload of telemetry.h, little endian
+FIELDS = (
+    ("seq", "B"), ("time_us", "I"),
+    ("x", "h"), ("y", "h"), ("a", "h"),
+    ("speed_d", "h"), ("speed_a", "h"),
+    ("dac_l", "i"), ("dac_r", "i"),
+    ("err_d", "i"), ("err_a", "i"),
+    ("opp1_x", "h"), ("opp1_y", "h"), ("opp2_x", "h"), ("opp2_y", "h"),
+    ("current_zone", "B"), ("goto_zone", "B"), ("traj_state", "B"),
+    ("flags", "H"), ("points", "H"),
+)
+NAMES = [f[0] for f in FIELDS]
+PAYLOAD = struct.Struct("<" + "".join(f[1] for f in FIELDS))
+
+def frames(data):
+    """ payloads of the telemetry frames found in data """
+    i = 0
+    while i + 3 < len(data):
+        if data[i] == FRAME_SYNC and data[i + 2] == FRAME_TELEM \
+           and data[i + 1] == PAYLOAD.size:
+            end = i + 3 + PAYLOAD.size
+            if end < len(data) and sum(data[i + 3:end]) & 0xFF == data[end]:
+                yield bytes(data[i + 3:end])
+                i = end + 1
+                continue
+        i += 1
+
+def read(data):
+    """ columns of a recording, dict of lists, plus "lost" frames """
+    cols = dict((name, []) for name in NAMES)
+    lost = 0
+    for payload in frames(bytearray(data)):
+        values = PAYLOAD.unpack(payload)
+        if cols["seq"]:
+            lost += (values[0] - cols["seq"][-1] - 1) & 0xFF
+        for name, v in zip(NAMES, values):
+            cols[name].append(v)
+    cols["lost"] = lost
+    return cols
+
+def main():
+    parser = optparse.OptionParser(usage="%prog [options] [file]")
+    parser.add_option("-o", "--output", dest="output",
+                      help="csv output file (default stdout)")
+    parser.add_option("--npz", dest="npz",
+                      help="numpy .npz output file instead of csv")
+    opts, args = parser.parse_args()
+
+    f = open(args[0], "rb") if args else getattr(sys.stdin, "buffer", sys.stdin)
+    cols = read(f.read())
+    n = len(cols["seq"])
+    sys.stderr.write("%d frames, %d lost\n" % (n, cols["lost"]))
+
+    if opts.npz:
+        import numpy
+        numpy.savez(opts.npz, **dict((k, numpy.array(cols[k])) for k in NAMES))
+        return
+
+    out = open(opts.output, "w") if opts.output else sys.stdout
+    out.write(",".join(NAMES) + "\n")
+    for i in range(n):
+        out.write(",".join("%d" % cols[k][i] for k in NAMES) + "\n")
+
+if __name__ == "__main__":
+    main()
@@ -92,6 +92,21 @@ inline void bt_status_set_cmd_ack (uint8_t val) {
  	bt_status_set_cmd_ret (val);
 }
 
+/* status push mode, see bt_commands.h */
+static struct {
+	uint16_t period_ms;
+	uint16_t min_mm;
+	microseconds time_us;
+	int16_t x;
+	int16_t y;
+	uint8_t cmd_ret;
+	uint8_t cmd_seq;
+} bt_push;
+
+/* sequence numbers of status frames and of last binary command */
+static uint8_t bt_status_seq = 0;
+static uint8_t bt_cmd_seq = 0;
+
 /* send data in norma mode, any protocol is used */
 static void uart_send_buffer (uint8_t *buff, uint16_t length) 
 {
@@ -137,6 +152,9 @@ void bt_send_status (void)
 	//ans.cmd_args_checksum = robot_2nd.cmd_args_checksum;
 	IRQ_UNLOCK(flags);
 
+	ans.seq = bt_status_seq++;
+	ans.cmd_seq = bt_cmd_seq;
+
 //#define DEBUG_STATUS
 #ifdef DEBUG_STATUS
 	/* fill answer structure */
@@ -151,6 +169,54 @@ void bt_send_status (void)
 	uint8_t sync_header[] = BT_ROBOT_2ND_SYNC_HEADER;
 	uart_send_buffer (sync_header, sizeof(sync_header)); 
 	uart_send_buffer ((uint8_t*) &ans, sizeof(ans)); 
+
+	/* for the push mode */
+	bt_push.time_us = time_get_us2();
+	bt_push.x = ans.x;
+	bt_push.y = ans.y;
+	bt_push.cmd_ret = ans.cmd_ret;
+	bt_push.cmd_seq = ans.cmd_seq;
+}
+
+/* set push mode, period_ms 0 is pulling mode */
+void bt_status_set_push (uint16_t period_ms, uint16_t min_mm)
+{
+	bt_push.period_ms = period_ms;
+	bt_push.min_mm = min_mm;
+	bt_push.time_us = 0;
+}
+
+/* return 1 if status is pushed instead of answered */
+uint8_t bt_status_push_enabled (void) {
+	return (bt_push.period_ms != 0);
+}
+
+/* push the status if it's time, if robot has moved or if the command
+ * return value has changed, called from cmdline event */
+void bt_status_push (void)
+{
+	uint32_t elapsed_ms;
+	uint16_t moved_mm;
+	uint8_t cmd_ret, flags;
+
+	if (bt_push.period_ms == 0)
+		return;
+
+	elapsed_ms = (time_get_us2() - bt_push.time_us) / 1000L;
+
+	IRQ_LOCK(flags);
+	moved_mm = ABS(position_get_x_s16(&mainboard.pos) - bt_push.x) +
+	           ABS(position_get_y_s16(&mainboard.pos) - bt_push.y);
+	cmd_ret = robot_2nd.cmd_ret;
+	IRQ_UNLOCK(flags);
+
+	/* command feedback is sent as soon as possible */
+	if (cmd_ret != bt_push.cmd_ret || bt_cmd_seq != bt_push.cmd_seq)
+		moved_mm = bt_push.min_mm;
+
+	if (bt_status_push_test (elapsed_ms, bt_push.period_ms,
+	                         moved_mm, bt_push.min_mm))
+		bt_send_status ();
 }
 
 
@@ -272,6 +338,26 @@ void bt_trajectory_goto_xy_abs (int16_t x, int16_t y, int16_t args_checksum)
 
 	}
 }
+void bt_trajectory_goto_xy_rel (int16_t x, int16_t y, int16_t args_checksum)
+{
+	/* check args checksum */
+	if ((x+y) == args_checksum) {
+
+		/* set ACK */
+		bt_status_set_cmd_ack (0);
+
+		mainboard.strat_event_data[0] = x;
+		mainboard.strat_event_data[1] = y;
+
+		strat_event_schedule_single (strat_goto_xy_rel_event,
+							 (void *)mainboard.strat_event_data);
+	}
+	else {
+		/* set ACK */
+		bt_status_set_cmd_ack (END_ERROR);
+
+	}
+}
 void bt_goto_and_avoid (int16_t x, int16_t y, int16_t args_checksum)
 {
 	/* check args checksum */
@@ -539,6 +625,99 @@ void bt_strat_init (void)
 }
 
 
+/******************* BT BINARY COMMANDS ***************************************/
 
+static struct bt_robot_2nd_cmd_parser bt_cmd_parser;
+static uint16_t bt_cmd_errors_checksum = 0;
 
+/* execute a binary command, checksum of args is checked by the parser */
+static void bt_robot_2nd_cmd_exec (struct bt_robot_2nd_cmd *cmd)
+{
+	int16_t *arg = cmd->arg;
+
+	/* echoed in status, the mainboard only takes cmd_ret of its last command */
+	bt_cmd_seq = cmd->seq;
+
+	switch (cmd->cmd_id)
+	{
+		case BT_SET_COLOR:
+			bt_set_color (arg[0]);
+			break;
+		case BT_AUTOPOS:
+			bt_auto_position ();
+			break;
+		case BT_GOTO_XY_ABS:
+			bt_trajectory_goto_xy_abs (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_GOTO_XY_REL:
+			bt_trajectory_goto_xy_rel (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_GOTO_FW_XY_ABS:
+			bt_trajectory_goto_forward_xy_abs (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_GOTO_BW_XY_ABS:
+			bt_trajectory_goto_backward_xy_abs (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_GOTO_AVOID:
+			bt_goto_and_avoid (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_GOTO_AVOID_FW:
+			bt_goto_and_avoid_forward (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_GOTO_AVOID_BW:
+			bt_goto_and_avoid_backward (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_FRESCO:
+			bt_fresco ();
+			break;
+		case BT_PATROL:
+			bt_patrol (arg[0], arg[1], arg[2], arg[3],
+					   arg[0] + arg[1] + arg[2] + arg[3]);
+			break;
+		case BT_PATROL_FRESCO_MAMOOTH:
+			bt_patrol_fresco_mamooth (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_MAMOOTH:
+			bt_mamooth (arg[0], arg[1], arg[0] + arg[1]);
+			break;
+		case BT_NET:
+			bt_net ();
+			break;
+		case BT_PROTECT_HEART:
+			bt_protect_h (arg[0]);
+			break;
+		case BT_STATUS_PUSH:
+			bt_status_set_cmd_ack (0);
+			bt_status_set_push (arg[0], arg[1]);
+			break;
+
+		default:
+			bt_status_set_cmd_ack (END_ERROR);
+			break;
+	}
+}
+
+/* binary commands parser, return 1 if c is part of a command frame */
+uint8_t bt_cmd_char_in (int16_t c)
+{
+	uint8_t sync_header[] = BT_ROBOT_2ND_CMD_SYNC_HEADER;
+	uint8_t ret, i;
+
+	ret = bt_robot_2nd_cmd_parse (&bt_cmd_parser, (uint8_t)c);
 
+	/* give back to rdline the bytes that were not a frame */
+	for (i=0; i<bt_cmd_parser.lost; i++)
+		rdline_char_in (&gen.rdl, sync_header[i]);
+
+	if (ret == BT_CMD_PARSE_NONE)
+		return 0;
+
+	if (ret == BT_CMD_PARSE_DONE)
+		bt_robot_2nd_cmd_exec (&bt_cmd_parser.cmd);
+	else if (ret == BT_CMD_PARSE_ERROR) {
+		bt_cmd_errors_checksum ++;
+		NOTICE (E_USER_BT_PROTO, "cmd CHECKSUM error (%d)", bt_cmd_errors_checksum);
+	}
+
+	return 1;
+}
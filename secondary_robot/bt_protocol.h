@@ -34,6 +34,15 @@ void bt_status_set_cmd_ack (uint8_t val);
 
 void bt_send_status (void);
 
+/* set push mode, period_ms 0 is pulling mode */
+void bt_status_set_push (uint16_t period_ms, uint16_t min_mm);
+
+/* return 1 if status is pushed instead of answered */
+uint8_t bt_status_push_enabled (void);
+
+/* push the status if it's time, called from cmdline event */
+void bt_status_push (void);
+
 
 /******************* BT PROTOCOL COMMANDS *************************************/
 
@@ -44,6 +53,8 @@ void bt_set_color (uint8_t color);
 
 void bt_trajectory_goto_xy_abs (int16_t x, int16_t y, int16_t args_checksum);
 
+void bt_trajectory_goto_xy_rel (int16_t x, int16_t y, int16_t args_checksum);
+
 void bt_trajectory_goto_backward_xy_abs (int16_t x, int16_t y, int16_t args_checksum);
 
 void bt_trajectory_goto_forward_xy_abs (int16_t x, int16_t y, int16_t args_checksum);
@@ -73,6 +84,11 @@ void bt_strat_init (void);
 /* TODO bt_trajectory_XXXX and bt_goto_avoid_XXXX functions */
 
 
+/******************* BT BINARY COMMANDS ***************************************/
+
+/* binary commands parser, return 1 if c is part of a command frame */
+uint8_t bt_cmd_char_in (int16_t c);
+
 
 #endif /* __BT_PROTOCOL_H__ */
 
@@ -49,6 +49,7 @@
 #include "beacon.h"
 #include "cmdline.h"
 #include "strat_base.h"
+#include "bt_protocol.h"
 
 
 /* see in commands.c for the list of commands. */
@@ -193,6 +194,10 @@ void cmdline_interact(void *dummy)
     }
 #endif
 
+		/* binary commands from mainboard */
+		if (bt_cmd_char_in(c))
+			continue;
+
 		/* process character in */
 		ret = rdline_char_in(&gen.rdl, c);
 
@@ -227,6 +232,9 @@ void cmdline_interact_nowait (void *dummy)
 	const char *history, *buffer;
 	int8_t ret, same = 0;
 	int16_t c;
+
+	/* status push mode */
+	bt_status_push();
 	
 	while (1)
 	{
@@ -244,6 +252,10 @@ void cmdline_interact_nowait (void *dummy)
     	}
 #endif
 
+		/* binary commands from mainboard */
+		if (bt_cmd_char_in(c))
+			continue;
+
 		/* process character in */
 		ret = rdline_char_in(&gen.rdl, c);
 
@@ -1072,9 +1072,10 @@ static void cmd_status_parsed(void * parsed_result, void *data)
 	robot_2nd.opponent2_d = d;
 	IRQ_UNLOCK(flags);
 
-	/* send status of sencondary robot */
+	/* send status of sencondary robot, in push mode is sent by bt_status_push() */
 send_status:
-	bt_send_status();
+	if (!bt_status_push_enabled())
+		bt_send_status();
 }
 
 
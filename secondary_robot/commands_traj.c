@@ -827,7 +827,7 @@ static void cmd_bt_goto_parsed(void * parsed_result, void * data)
 		//bt_trajectory_turnto_xy_behind(res->arg2, res->arg3, res->arg4);
 	}
 	else if (!strcmp_P(res->arg1, PSTR("xy_rel"))) {
-		//bt_trajectory_goto_xy_rel(res->arg2, res->arg3, res->arg4);
+		bt_trajectory_goto_xy_rel(res->arg2, res->arg3, res->arg4);
 	}
 	else if (!strcmp_P(res->arg1, PSTR("xy_abs"))) {
 		bt_trajectory_goto_xy_abs(res->arg2, res->arg3, res->arg4);
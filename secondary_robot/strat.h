@@ -367,6 +367,7 @@ void strat_auto_position_event (void *data);
 
 /* trajectory functions */
 void strat_goto_xy_abs_event (void *data);
+void strat_goto_xy_rel_event (void *data);
 void strat_goto_forward_xy_abs_event (void *data);
 void strat_goto_backward_xy_abs_event (void *data);
 
@@ -147,6 +147,22 @@ void strat_goto_xy_abs_event (void *data)
 	/* return value */
 	bt_status_set_cmd_ret (err);
 }
+void strat_goto_xy_rel_event (void *data)
+{
+	int16_t *arg = (int16_t*)data;
+	uint8_t err;
+ 
+	interrupt_traj_reset();
+
+	trajectory_goto_xy_rel(&mainboard.traj, arg[0], arg[1]);
+	err = wait_traj_end(TRAJ_FLAGS_STD);
+
+	if (err != END_TRAJ && err != END_NEAR)
+		strat_hardstop();
+
+	/* return value */
+	bt_status_set_cmd_ret (err);
+}
 void strat_goto_forward_xy_abs_event (void *data)
 {
 	int16_t *arg = (int16_t*)data;
@@ -67,66 +67,126 @@ struct ax12_traj
     
     uint16_t pos;
 	int16_t angle_deg;
-    uint16_t speed;
+    uint16_t speed;			/* set by actuator_init(), 0 is 0x3ff */
+
+	/* position read without waiting the servo, fresh if it was sent
+	 * after the goal was set */
+	struct ax12_req pos_req;
+	uint8_t pos_fresh;
 };
 
 
-/* set position */
-void ax12_set_pos (struct ax12_traj *ax12, int16_t pos)
+/* time (ms) to go from a position to the goal at the servo speed */
+static uint16_t ax12_goal_time_ms (struct ax12_traj *ax12, uint16_t pos)
 {
-    float k_ms_deg = 0.0;
+    float k_ms_deg;
+	int16_t angle_deg;
 
-    /* update current position/angle */
-	ax12_user_read_int(&gen.ax12, ax12->id, AA_PRESENT_POSITION_L, &ax12->pos);
+ 	angle_deg = (int16_t)(pos - ax12->zero_offset_pos);
+ 	angle_deg = (int16_t)(angle_deg / AX12_K_IMP_DEG);
+
+    k_ms_deg = AX12_K_MS_DEG * 0x3ff;
+    k_ms_deg /= (ax12->speed==0? 0x3ff:ax12->speed);
+
+	return (ABS(angle_deg - ax12->goal_angle_deg) * k_ms_deg);
+}
+
+/* take the last position read. The first one sent after the goal gives
+ * the goal time from the position the servo started at */
+static void ax12_update_pos (struct ax12_traj *ax12)
+{
+	if (!ax12_async_done(&ax12->pos_req) || ax12->pos_req.err != 0)
+		return;
+
+	ax12->pos = ax12->pos_req.data;
  	ax12->angle_deg = (int16_t)(ax12->pos - ax12->zero_offset_pos);
  	ax12->angle_deg = (int16_t)(ax12->angle_deg / AX12_K_IMP_DEG);
 
-    /* set goal angle */
-    ax12->goal_pos = pos;
-    ax12->goal_angle_deg = (int16_t)((pos - ax12->zero_offset_pos) / AX12_K_IMP_DEG);
-	ax12_user_write_int(&gen.ax12, ax12->id , AA_GOAL_POSITION_L, ax12->goal_pos);
+	if (!ax12->pos_fresh && (int32_t)(ax12->pos_req.t - ax12->time_us) >= 0) {
+		ax12->pos_fresh = 1;
+		ax12->goal_time_ms = (ax12->pos_req.t - ax12->time_us)/1000 +
+			ax12_goal_time_ms(ax12, ax12->pos);
+	}
+}
 
-    /* update goal time */
-    ax12_user_read_int(&gen.ax12, ax12->id, AA_MOVING_SPEED_L, &ax12->speed);
-    k_ms_deg = AX12_K_MS_DEG * 0x3ff;
-    k_ms_deg /= (ax12->speed==0? 0x3ff:ax12->speed);
+/* servos of the batch, their goal time starts when it's sent */
+#define AX12_TRAJ_SYNC_MAX	8
+static struct ax12_traj *ax12_traj_sync[AX12_TRAJ_SYNC_MAX];
+static uint8_t ax12_traj_sync_n;
 
-	//ax12->goal_time_us = (microseconds)(ABS(ax12->angle_deg - ax12->goal_angle_deg) * AX12_K_MS_DEG * 1000);
-	ax12->goal_time_ms = (ABS(ax12->angle_deg - ax12->goal_angle_deg) * k_ms_deg);
+/* the goal is on the bus, its timeout starts now */
+static void ax12_goal_sent (struct ax12_traj *ax12)
+{
 	ax12->time_us = time_get_us2();
+	ax12->pos_fresh = 0;
+}
+
+/* the goals set until ax12_traj_sync_flush() are sent in one SYNC_WRITE */
+void ax12_traj_sync_begin (void)
+{
+	ax12_user_sync_begin();
+}
+
+void ax12_traj_sync_flush (void)
+{
+	uint8_t i;
+
+	ax12_user_sync_flush(&gen.ax12);
+	if (ax12_user_sync_open())
+		return;
+
+	for (i=0; i<ax12_traj_sync_n; i++)
+		ax12_goal_sent(ax12_traj_sync[i]);
+	ax12_traj_sync_n = 0;
+}
+
+/* set the goal, the goal time is estimated from the last position read
+ * and updated by ax12_test_traj_end() when a fresh one is received */
+static void ax12_set_goal (struct ax12_traj *ax12)
+{
+	uint8_t i;
+
+	ax12_update_pos(ax12);
+
+	ax12_user_sync_write_int(&gen.ax12, ax12->id , AA_GOAL_POSITION_L, ax12->goal_pos);
+
+	ax12->goal_time_ms = ax12_goal_time_ms(ax12, ax12->pos);
+	ax12_goal_sent(ax12);
+
+	/* batched, the time is taken again on flush */
+	if (ax12_user_sync_open()) {
+		for (i=0; i<ax12_traj_sync_n; i++) {
+			if (ax12_traj_sync[i] == ax12)
+				break;
+		}
+		if (i == ax12_traj_sync_n && i < AX12_TRAJ_SYNC_MAX)
+			ax12_traj_sync[ax12_traj_sync_n++] = ax12;
+	}
+
+	/* does nothing if the last one is pending */
+	ax12_async_read_int(&ax12->pos_req, ax12->id, AA_PRESENT_POSITION_L, NULL);
+}
+
+/* set position */
+void ax12_set_pos (struct ax12_traj *ax12, int16_t pos)
+{
+    /* set goal angle */
+    ax12->goal_pos = pos;
+    ax12->goal_angle_deg = (int16_t)((pos - ax12->zero_offset_pos) / AX12_K_IMP_DEG);
+	ax12_set_goal(ax12);
 }
 
 /* set angle */
 void ax12_set_a (struct ax12_traj *ax12, int16_t a)
 {
-    double k_ms_deg = 0.0;
 	//printf ("%s, a = %d\n\r", __FUNCTION__, a);
 
-    /* update current position/angle */
-	ax12_user_read_int(&gen.ax12, ax12->id, AA_PRESENT_POSITION_L, &ax12->pos);
- 	ax12->angle_deg = (int16_t)(ax12->pos - ax12->zero_offset_pos);
- 	ax12->angle_deg = (int16_t)(ax12->angle_deg / AX12_K_IMP_DEG);
-
     /* set goal angle */
     ax12->goal_angle_deg = a;
     ax12->goal_pos = ax12->zero_offset_pos + (int16_t)(ax12->goal_angle_deg * AX12_K_IMP_DEG);
 
 	//printf ("%s, goal pos = %d\n\r", __FUNCTION__, ax12->goal_pos);
-	ax12_user_write_int(&gen.ax12, ax12->id , AA_GOAL_POSITION_L, ax12->goal_pos);
-
-    /* update goal time */
-    ax12_user_read_int(&gen.ax12, ax12->id, AA_MOVING_SPEED_L, &ax12->speed);
-    k_ms_deg = AX12_K_MS_DEG * 0x3ff;
-    k_ms_deg /= (ax12->speed==0? 0x3ff:ax12->speed);
-
-	//printf("k_ms_deg = %f\n\r", k_ms_deg);
-
-	//ax12->goal_time_us = (ABS(ax12->angle_deg - ax12wri	->goal_angle_deg) * AX12_K_MS_DEG * 1000);
-	ax12->goal_time_ms = (ABS(ax12->angle_deg - ax12->goal_angle_deg) * k_ms_deg);
-	ax12->time_us = time_get_us2();
-
-	//printf ("da %d, goal_us %ld\n\r", (int16_t)ABS(ax12->angle_deg - ax12->goal_angle_deg), (int32_t)ax12->goal_time_ms);
-	//printf ("a=%d, goal_a =%d\n\r", ax12->angle_deg, ax12->goal_angle_deg);
+	ax12_set_goal(ax12);
 }
 
 /* get angle */
@@ -166,14 +226,20 @@ const char *get_err (uint8_t err)
 
 uint8_t ax12_test_traj_end (struct ax12_traj *ax12, uint8_t flags)
 {
-	ax12_user_read_int(&gen.ax12, ax12->id, AA_PRESENT_POSITION_L, &ax12->pos);
     uint8_t ret = 0;
 
-	if (flags & END_TRAJ)
+	/* last position read */
+	ax12_update_pos(ax12);
+
+	/* next read, does nothing if the last one is pending */
+	ax12_async_read_int(&ax12->pos_req, ax12->id, AA_PRESENT_POSITION_L, NULL);
+
+	/* positions read before the goal was set don't tell the end */
+	if ((flags & END_TRAJ) && ax12->pos_fresh)
 		if (ABS(ax12->goal_pos - ax12->pos) < AX12_WINDOW_NO_NEAR)
 			ret |= END_TRAJ;
 
-	if (flags & END_NEAR)
+	if ((flags & END_NEAR) && ax12->pos_fresh)
 		if (ABS(ax12->goal_pos - ax12->pos) < AX12_WINDOW_NEAR)
 			ret |=  END_NEAR;
 
@@ -183,7 +249,9 @@ uint8_t ax12_test_traj_end (struct ax12_traj *ax12, uint8_t flags)
 
 	//if (flags & END_BLOCKING)
         if ((time_get_us2() - ax12->time_us)/1000 > (2*ax12->goal_time_ms)) {
-            ax12_user_write_int(&gen.ax12, ax12->id , AA_GOAL_POSITION_L, ax12->pos);                       
+			/* hold the position, only if read during this move */
+			if (ax12->pos_fresh)
+				ax12_user_write_int(&gen.ax12, ax12->id , AA_GOAL_POSITION_L, ax12->pos);
 		    ret |=  END_BLOCKING;
         }
 
@@ -395,9 +463,11 @@ int8_t combs_set_mode(combs_t *combs, uint8_t mode, int16_t pos_offset)
 	if(combs->ax12_pos_r < combs_ax12_pos_r[COMBS_MODE_R_POS_MIN])
 		combs->ax12_pos_r = combs_ax12_pos_r[COMBS_MODE_R_POS_MIN];
  
-	/* apply to ax12 */
+	/* apply to ax12, both at the same time */
+	ax12_traj_sync_begin();
     ax12_set_pos (&ax12_comb_l, combs->ax12_pos_l);
     ax12_set_pos (&ax12_comb_r, combs->ax12_pos_r);
+	ax12_traj_sync_flush();
 
 	return 0;
 }
@@ -915,8 +985,10 @@ void arm_goto_hxaa (int16_t h, int16_t x, int16_t elbow_a, int16_t wrist_a)
 		arm_xy_wait_traj_end (END_TRAJ|END_NEAR|END_TIME);
 
 		arm_goto_h_elbow_a (h, elbow_a);	
+		ax12_traj_sync_begin();
 		arm_elbow_goto_a_abs (elbow_a);
 		arm_wrist_goto_a_abs (wrist_a);
+		ax12_traj_sync_flush();
 
 		/* wait end positions reached */
 		arm_xy_wait_traj_end (END_TRAJ);
@@ -927,8 +999,10 @@ void arm_goto_hxaa (int16_t h, int16_t x, int16_t elbow_a, int16_t wrist_a)
 	else {
 		/* set all except shoulder angle */
 		arm_goto_h_elbow_a (h, elbow_a);
+		ax12_traj_sync_begin();
 		arm_elbow_goto_a_abs (elbow_a);
 		arm_wrist_goto_a_abs (wrist_a);
+		ax12_traj_sync_flush();
 
 		/* wait for h reached */
 		arm_h_wait_traj_end();
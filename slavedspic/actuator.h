@@ -86,6 +86,11 @@
 /* init actuators */
 void actuator_init(void);
 
+/* batch the ax12 goals set until the flush in one SYNC_WRITE,
+ * batches nest */
+void ax12_traj_sync_begin (void);
+void ax12_traj_sync_flush (void);
+
 /**** lift functions ********************************************************/
 
 /* stop without rampe */
@@ -31,6 +31,7 @@
 #include <ax12.h>
 #include <uart.h>
 #include <clock_time.h>
+#include <scheduler.h>
 
 #include <rdline.h>
 #include <parse.h>
@@ -83,6 +84,9 @@ static microseconds t_prev_msg = 0;
  *
  * We don't use the CM-5 circuit as described in the AX12
  * documentation.
+ *
+ * Requests that don't need to wait the answer (polling of positions)
+ * use the asynchronous requests below, interrupt driven.
  */
 
 static volatile uint8_t ax12_state = AX12_STATE_READ;
@@ -113,6 +117,12 @@ static void ax12_send_callback(char c)
 	}
 }
 
+/* bytes received out of async requests, for ax12_recv_char() */
+#define AX12_RX_BUF_SIZE 32
+static volatile uint8_t ax12_rx_buf[AX12_RX_BUF_SIZE];
+static volatile uint8_t ax12_rx_head = 0;
+static volatile uint8_t ax12_rx_tail = 0;
+
 /* Called by ax12 module when we want to receive a char. Note that we
  * also receive the bytes we sent ! So we need to drop them. */
 static int16_t ax12_recv_char(void)
@@ -120,7 +130,11 @@ static int16_t ax12_recv_char(void)
 	microseconds t = time_get_us2();
 	int c;
 	while (1) {
-		c = uart_recv_nowait(UART_AX12_NUM);
+		c = -1;
+		if (ax12_rx_tail != ax12_rx_head) {
+			c = ax12_rx_buf[ax12_rx_tail];
+			ax12_rx_tail = (ax12_rx_tail + 1) % AX12_RX_BUF_SIZE;
+		}
 		if (c != -1) {
 			if (ax12_nsent == 0)
 				return c;
@@ -148,6 +162,7 @@ static void ax12_switch_uart(uint8_t state)
 		IRQ_LOCK(flags);
 		ax12_nsent=0;
 		// Empty the RX buffer		// Case of two follow writes, in RX buffer		// is the status packet		while (uart_recv_nowait(1) != -1);
+		ax12_rx_tail = ax12_rx_head;
 #ifndef EUROBOT_2011_BOARD
 		_TRISB9	= 0;	// U2RX/TX pin is output		_ODCB9 	= 1;	// open collector on#else
 		_TRISB4	= 0;	// U2RX/TX pin is output		_ODCB4 	= 1;	// open collector on
@@ -191,6 +206,341 @@ static void ax12_print_error(uint8_t err, uint16_t line)
 	t_prev_msg = t2;
 }
 
+/********************************* AX12 asynchronous requests */
+
+/*
+ * Queued requests are sent from a scheduler event. While a request is
+ * in flight, the UART RX interrupt drops the echo of the bytes sent and
+ * parses the status packet, matching it with the request. The
+ * scheduler event retries on timeout or error, updates the stats and
+ * calls the callback. The synchronous functions wait for the request
+ * in flight (not for the queue) and own the bus until they return.
+ */
+#define AX12_ASYNC_QUEUE_SIZE 8
+#define AX12_ASYNC_PERIOD 1024L /* in us */
+
+#define AX12_ASYNC_ERR_TIMEOUT 0xF0
+#define AX12_ASYNC_ERR_PACKET  0xF1
+#define AX12_SYNC_ERR_LOCKED   0xF2
+
+/* bound of the wait of a synchronous access, in loops as time_get_us2()
+ * doesn't advance if the scheduler or the interrupts are locked. About
+ * 50 ms at 40 MIPS, more than AX12_TIMEOUT plus AX12_ASYNC_PERIOD */
+#define AX12_SYNC_LOCK_LOOPS 200000L
+
+enum ax12_rx_state {
+	AX12_RX_HEADER1,
+	AX12_RX_HEADER2,
+	AX12_RX_ID,
+	AX12_RX_LEN,
+	AX12_RX_ERROR,
+	AX12_RX_PARAMS,
+	AX12_RX_CHECKSUM,
+};
+
+static struct {
+	struct ax12_req *queue[AX12_ASYNC_QUEUE_SIZE];
+	volatile uint8_t head;
+	volatile uint8_t tail;
+
+	struct ax12_req * volatile cur;	/* request in flight */
+	volatile uint8_t sync;			/* synchronous access running */
+
+	/* status packet parser, in RX interrupt */
+	volatile uint8_t waiting;
+	volatile uint8_t rx_done;
+	uint8_t rx_state;
+	uint8_t rx_id;
+	uint8_t rx_len;
+	uint8_t rx_err;
+	uint8_t rx_n;
+	uint8_t rx_params[2];
+	uint8_t rx_sum;
+} ax12_async;
+
+/* called by uart module on each received char, in interrupt */
+static void ax12_recv_callback(char ch)
+{
+	struct ax12_req *req = ax12_async.cur;
+	uint8_t c = ch;
+	uint8_t next;
+
+	/* synchronous access, store it for ax12_recv_char() */
+	if (!ax12_async.waiting) {
+		next = (ax12_rx_head + 1) % AX12_RX_BUF_SIZE;
+		if (next != ax12_rx_tail) {
+			ax12_rx_buf[ax12_rx_head] = c;
+			ax12_rx_head = next;
+		}
+		return;
+	}
+
+	/* echo of our own bytes */
+	if (ax12_nsent) {
+		ax12_nsent--;
+		return;
+	}
+
+	switch (ax12_async.rx_state) {
+	case AX12_RX_HEADER1:
+	case AX12_RX_HEADER2:
+		if (c == 0xFF)
+			ax12_async.rx_state++;
+		else
+			ax12_async.rx_state = AX12_RX_HEADER1;
+		break;
+	case AX12_RX_ID:
+		/* sync bytes may be repeated */
+		if (c == 0xFF)
+			break;
+		ax12_async.rx_id = c;
+		ax12_async.rx_sum = c;
+		ax12_async.rx_state = AX12_RX_LEN;
+		break;
+	case AX12_RX_LEN:
+		ax12_async.rx_len = c;
+		ax12_async.rx_sum += c;
+		ax12_async.rx_state = AX12_RX_ERROR;
+		break;
+	case AX12_RX_ERROR:
+		ax12_async.rx_err = c;
+		ax12_async.rx_sum += c;
+		ax12_async.rx_n = 0;
+		if (ax12_async.rx_len > 2)
+			ax12_async.rx_state = AX12_RX_PARAMS;
+		else
+			ax12_async.rx_state = AX12_RX_CHECKSUM;
+		break;
+	case AX12_RX_PARAMS:
+		if (ax12_async.rx_n < sizeof(ax12_async.rx_params))
+			ax12_async.rx_params[ax12_async.rx_n] = c;
+		ax12_async.rx_n++;
+		ax12_async.rx_sum += c;
+		if (ax12_async.rx_n >= ax12_async.rx_len - 2)
+			ax12_async.rx_state = AX12_RX_CHECKSUM;
+		break;
+	case AX12_RX_CHECKSUM:
+	default:
+		ax12_async.rx_state = AX12_RX_HEADER1;
+
+		/* not the answer of the request in flight */
+		if (req == NULL || ax12_async.rx_id != req->id)
+			break;
+
+		if ((uint8_t)~ax12_async.rx_sum != c ||
+		    (req->instruction == AX12_READ &&
+		     ax12_async.rx_n != req->len)) {
+			req->err = AX12_ASYNC_ERR_PACKET;
+		}
+		else {
+			req->err = ax12_async.rx_err;
+			if (req->instruction == AX12_READ) {
+				req->data = ax12_async.rx_params[0];
+				if (req->len == 2)
+					req->data |= (uint16_t)ax12_async.rx_params[1] << 8;
+			}
+		}
+		ax12_async.waiting = 0;
+		ax12_async.rx_done = 1;
+		break;
+	}
+}
+
+/* send the request in flight */
+static void ax12_async_send(struct ax12_req *req)
+{
+	uint8_t buf[9];
+	uint8_t i, n = 0, sum = 0;
+
+	buf[n++] = 0xFF;
+	buf[n++] = 0xFF;
+	buf[n++] = req->id;
+	buf[n++] = (req->instruction == AX12_READ) ? 4 : 3 + req->len;
+	buf[n++] = req->instruction;
+	buf[n++] = req->address;
+	if (req->instruction == AX12_READ)
+		buf[n++] = req->len;
+	else {
+		buf[n++] = req->data & 0xFF;
+		if (req->len == 2)
+			buf[n++] = req->data >> 8;
+	}
+	for (i = 2; i < n; i++)
+		sum += buf[i];
+	buf[n++] = ~sum;
+
+	ax12_switch_uart(AX12_STATE_WRITE);
+	ax12_async.rx_state = AX12_RX_HEADER1;
+	ax12_async.rx_done = 0;
+	ax12_async.waiting = (req->id != AX12_BROADCAST_ID);
+
+	for (i = 0; i < n; i++) {
+		/* count before sending, echo may arrive just after */
+		ax12_nsent++;
+		uart_send(UART_AX12_NUM, buf[i]);
+	}
+
+	ax12_switch_uart(AX12_STATE_READ);
+	req->t = time_get_us2();
+	req->state = AX12_REQ_BUSY;
+}
+
+/* end of the request in flight, with or without error */
+static void ax12_async_end(struct ax12_req *req)
+{
+	uint8_t flags;
+
+	IRQ_LOCK(flags);
+	ax12_async.waiting = 0;
+	ax12_async.cur = NULL;
+	IRQ_UNLOCK(flags);
+
+	if (req->err)
+		ax12_stats_drops++;
+	req->state = AX12_REQ_DONE;
+	if (req->cb)
+		req->cb(req);
+}
+
+/* scheduler event, progress of the request in flight and queue */
+static void ax12_async_event(void *dummy)
+{
+	struct ax12_req *req = ax12_async.cur;
+	uint8_t done, next, flags;
+
+	if (req) {
+		/* broadcast has no answer */
+		if (req->id == AX12_BROADCAST_ID) {
+			req->err = 0;
+			done = 1;
+		}
+		else
+			done = ax12_async.rx_done;
+
+		if (!done) {
+			if (time_get_us2() - req->t < AX12_TIMEOUT)
+				return;
+			req->err = AX12_ASYNC_ERR_TIMEOUT;
+		}
+
+		if (req->err == 0 || ++req->tries >= AX12_MAX_TRIES) {
+			if (req->err) {
+				ax12_stats_fails++;
+				ax12_print_error(req->err, __LINE__);
+			}
+			ax12_async_end(req);
+		}
+		else {
+			ax12_stats_fails++;
+			if (!ax12_async.sync) {
+				ax12_async_send(req);
+				return;
+			}
+
+			/* retry after the synchronous access, first in queue */
+			next = (ax12_async.head + AX12_ASYNC_QUEUE_SIZE - 1) % AX12_ASYNC_QUEUE_SIZE;
+			if (next == ax12_async.tail) {
+				ax12_async_end(req);
+				return;
+			}
+			IRQ_LOCK(flags);
+			ax12_async.cur = NULL;
+			ax12_async.waiting = 0;
+			IRQ_UNLOCK(flags);
+			ax12_async.head = next;
+			ax12_async.queue[next] = req;
+			req->state = AX12_REQ_QUEUED;
+		}
+	}
+
+	/* next request */
+	if (ax12_async.sync || ax12_async.head == ax12_async.tail)
+		return;
+
+	req = ax12_async.queue[ax12_async.head];
+	ax12_async.head = (ax12_async.head + 1) % AX12_ASYNC_QUEUE_SIZE;
+	ax12_async.cur = req;
+	ax12_async_send(req);
+}
+
+static int8_t ax12_async_queue(struct ax12_req *req)
+{
+	uint8_t flags, next;
+
+	if (req->state == AX12_REQ_QUEUED || req->state == AX12_REQ_BUSY)
+		return -1;
+
+	IRQ_LOCK(flags);
+	next = (ax12_async.tail + 1) % AX12_ASYNC_QUEUE_SIZE;
+	if (next == ax12_async.head) {
+		IRQ_UNLOCK(flags);
+		return -1;
+	}
+	req->state = AX12_REQ_QUEUED;
+	req->err = 0;
+	req->tries = 0;
+	ax12_async.queue[ax12_async.tail] = req;
+	ax12_async.tail = next;
+	IRQ_UNLOCK(flags);
+
+	ax12_stats_ops++;
+	return 0;
+}
+
+int8_t ax12_async_read_int(struct ax12_req *req, uint8_t id, AX12_ADDRESS address,
+			   void (*cb)(struct ax12_req *req))
+{
+	if (req->state == AX12_REQ_QUEUED || req->state == AX12_REQ_BUSY)
+		return -1;
+
+	req->id = id;
+	req->instruction = AX12_READ;
+	req->address = address;
+	req->len = 2;
+	req->cb = cb;
+	return ax12_async_queue(req);
+}
+
+int8_t ax12_async_write_int(struct ax12_req *req, uint8_t id, AX12_ADDRESS address,
+			    uint16_t data, void (*cb)(struct ax12_req *req))
+{
+	if (req->state == AX12_REQ_QUEUED || req->state == AX12_REQ_BUSY)
+		return -1;
+
+	req->id = id;
+	req->instruction = AX12_WRITE;
+	req->address = address;
+	req->len = 2;
+	req->data = data;
+	req->cb = cb;
+	return ax12_async_queue(req);
+}
+
+/* take the bus for a synchronous access, wait the request in flight,
+ * ended by ax12_async_event(). Called from an event of prio AX12_PRIO
+ * or higher or with interrupts locked it never ends, give up and
+ * return AX12_SYNC_ERR_LOCKED, see ax12_user.h */
+static uint8_t ax12_sync_lock(uint16_t line)
+{
+	uint32_t loops = 0;
+
+	ax12_async.sync++;
+	while (ax12_async.cur != NULL) {
+		if (++loops > AX12_SYNC_LOCK_LOOPS) {
+			ax12_async.sync--;
+			ax12_print_error(AX12_SYNC_ERR_LOCKED, line);
+			ax12_stats_drops++;
+			return AX12_SYNC_ERR_LOCKED;
+		}
+	}
+	return 0;
+}
+
+static void ax12_sync_unlock(void)
+{
+	ax12_async.sync--;
+}
+
 uint8_t __ax12_user_write_byte(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 			       uint8_t data, uint16_t line)
 {
@@ -198,6 +548,9 @@ uint8_t __ax12_user_write_byte(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 
 	ax12_stats_ops++;
 
+	err = ax12_sync_lock(line);
+	if (err)
+		return err;
 	for (i=0; i<AX12_MAX_TRIES ; i++) {
 		err = AX12_write_byte(ax12, id, address, data);
 		if (err == 0)
@@ -205,6 +558,8 @@ uint8_t __ax12_user_write_byte(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 		wait_ms(2); /* BAD HACK XXX */
 		ax12_stats_fails++;
 	}
+	ax12_sync_unlock();
+
 	if (err == 0)
 		return 0;
 
@@ -220,6 +575,9 @@ uint8_t __ax12_user_write_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 
 	ax12_stats_ops++;
 
+	err = ax12_sync_lock(line);
+	if (err)
+		return err;
 	for (i=0; i<AX12_MAX_TRIES ; i++) {
 		err = AX12_write_int(ax12, id, address, data);
 		if (err == 0)
@@ -227,6 +585,8 @@ uint8_t __ax12_user_write_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 		wait_ms(2); /* BAD HACK XXX */
 		ax12_stats_fails++;
 	}
+	ax12_sync_unlock();
+
 	if (err == 0)
 		return 0;
 
@@ -242,6 +602,9 @@ uint8_t __ax12_user_read_byte(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 
 	ax12_stats_ops++;
 
+	err = ax12_sync_lock(line);
+	if (err)
+		return err;
 	for (i=0; i<AX12_MAX_TRIES ; i++) {
 		err = AX12_read_byte(ax12, id, address, val);
 		if (err == 0)
@@ -249,6 +612,8 @@ uint8_t __ax12_user_read_byte(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 		wait_ms(2); /* BAD HACK XXX */
 		ax12_stats_fails++;
 	}
+	ax12_sync_unlock();
+
 	if (err == 0) {
 		/* XXX hack for broadcast */
 		if (id == AX12_BROADCAST_ID)
@@ -268,6 +633,9 @@ uint8_t __ax12_user_read_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 
 	ax12_stats_ops++;
 
+	err = ax12_sync_lock(line);
+	if (err)
+		return err;
 	for (i=0; i<AX12_MAX_TRIES ; i++) {
 		err = AX12_read_int(ax12, id, address, val);
 		if (err == 0)
@@ -275,6 +643,8 @@ uint8_t __ax12_user_read_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 		wait_ms(2); /* BAD HACK XXX */
 		ax12_stats_fails++;
 	}
+	ax12_sync_unlock();
+
 	if (err == 0) {
 		/* XXX hack for broadcast */
 		if (id == AX12_BROADCAST_ID)
@@ -287,6 +657,116 @@ uint8_t __ax12_user_read_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 	return err;
 }
 
+/********************************* AX12 sync write */
+
+/*
+ * Writes to the same address of several servos can be batched between
+ * ax12_user_sync_begin() and ax12_user_sync_flush(), the batch is sent
+ * in only one SYNC_WRITE packet so all the servos start at the same
+ * time. SYNC_WRITE is a broadcast, there is no status packet.
+ * Batches nest, the packet is sent by the outermost flush.
+ */
+#define AX12_SYNC_MAX ((AX12_MAX_PARAMS - 2) / 3)
+
+static struct {
+	uint8_t open;				/* nesting depth */
+	AX12_ADDRESS address;
+	uint8_t n;
+	uint8_t id[AX12_SYNC_MAX];
+	uint16_t data[AX12_SYNC_MAX];
+} ax12_sync;
+
+void ax12_user_sync_begin(void)
+{
+	ax12_sync.open++;
+}
+
+uint8_t ax12_user_sync_open(void)
+{
+	return ax12_sync.open;
+}
+
+/* send the batch, it stays open */
+static uint8_t ax12_sync_send(AX12 *ax12, uint16_t line)
+{
+	AX12_Packet p;
+	uint8_t err, i, n;
+
+	n = ax12_sync.n;
+	ax12_sync.n = 0;
+
+	if (n == 0)
+		return 0;
+
+	/* with status packet and retries */
+	if (n == 1)
+		return __ax12_user_write_int(ax12, ax12_sync.id[0],
+					     ax12_sync.address, ax12_sync.data[0], line);
+
+	p.id = AX12_BROADCAST_ID;
+	p.instruction = AX12_SYNC_WRITE;
+	p.nparams = 2 + 3*n;
+	p.params[0] = ax12_sync.address;
+	p.params[1] = 2;
+	for (i=0; i<n; i++) {
+		p.params[2 + 3*i] = ax12_sync.id[i];
+		p.params[3 + 3*i] = ax12_sync.data[i] & 0xFF;
+		p.params[4 + 3*i] = ax12_sync.data[i] >> 8;
+	}
+
+	ax12_stats_ops++;
+
+	err = ax12_sync_lock(line);
+	if (err)
+		return err;
+	err = AX12_send(ax12, &p);
+	ax12_sync_unlock();
+	if (err == 0)
+		return 0;
+
+	ax12_print_error(err, line);
+	ax12_stats_fails++;
+	ax12_stats_drops++;
+	return err;
+}
+
+uint8_t __ax12_user_sync_flush(AX12 *ax12, uint16_t line)
+{
+	if (ax12_sync.open == 0)
+		return 0;
+	if (--ax12_sync.open)
+		return 0;
+	return ax12_sync_send(ax12, line);
+}
+
+uint8_t __ax12_user_sync_write_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
+				   uint16_t data, uint16_t line)
+{
+	uint8_t i;
+
+	if (!ax12_sync.open)
+		return __ax12_user_write_int(ax12, id, address, data, line);
+
+	/* only one address per packet */
+	if (ax12_sync.n && (ax12_sync.address != address ||
+			    ax12_sync.n == AX12_SYNC_MAX))
+		ax12_sync_send(ax12, line);
+
+	/* last write of a servo wins */
+	for (i=0; i<ax12_sync.n; i++) {
+		if (ax12_sync.id[i] == id)
+			break;
+	}
+
+	ax12_sync.address = address;
+	ax12_sync.id[i] = id;
+	ax12_sync.data[i] = data;
+	if (i == ax12_sync.n)
+		ax12_sync.n++;
+
+	return 0;
+}
+
 void ax12_dump_stats(void)
 {
 	printf_P(PSTR("AX12 stats:\r\n"));
@@ -304,5 +784,10 @@ void ax12_user_init(void)
 	AX12_set_hardware_recv(&gen.ax12, ax12_recv_char);
 	AX12_set_hardware_switch(&gen.ax12, ax12_switch_uart);
 	uart_register_tx_event(UART_AX12_NUM, ax12_send_callback);
+	uart_register_rx_event(UART_AX12_NUM, ax12_recv_callback);
+
+	scheduler_add_periodical_event_priority(ax12_async_event, NULL,
+						AX12_ASYNC_PERIOD / SCHEDULER_UNIT,
+						AX12_PRIO);
 	t_prev_msg = time_get_us2();
 }
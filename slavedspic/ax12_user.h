@@ -29,6 +29,14 @@
  * module are done either in init() functions or in a scheduler event
  * with assigned prio.
  */
+/* The asynchronous requests (ax12_async_*) are sent by a scheduler
+ * event and received in the UART RX interrupt, they can be issued from
+ * anywhere and don't block. A synchronous call waits for the
+ * asynchronous request in flight before using the bus, and only the
+ * AX12_PRIO event ends it: synchronous calls _must not_ be done from a
+ * scheduler event of prio AX12_PRIO or higher, nor with interrupts
+ * locked. They would wait forever, so they give up after about 50 ms
+ * and return the error 0xF2 (AX12_SYNC_ERR_LOCKED). */
 
 /* XXX do a safe_ax12() function that will retry once or twice if we
  * see some problems. */
@@ -51,6 +59,12 @@ void ax12_dump_stats(void);
 #define ax12_user_read_int(ax12, id, addr, data)		\
 	__ax12_user_read_int(ax12, id, addr, data, __LINE__)
 
+#define ax12_user_sync_write_int(ax12, id, addr, data)		\
+	__ax12_user_sync_write_int(ax12, id, addr, data, __LINE__)
+
+#define ax12_user_sync_flush(ax12)				\
+	__ax12_user_sync_flush(ax12, __LINE__)
+
 /** @brief Write byte in AX-12 memory 
  * @return Error code from AX-12 (0 means okay) */
 uint8_t __ax12_user_write_byte(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
@@ -74,3 +88,66 @@ uint8_t __ax12_user_read_byte(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
  * @return Error code from AX-12 (0 means okay) */
 uint8_t __ax12_user_read_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
 			     uint16_t *val, uint16_t line);
+
+/** @brief Start a batch of writes, sent in one SYNC_WRITE on flush.
+ * Batches nest, the writes are sent by the outermost flush. */
+void ax12_user_sync_begin(void);
+
+/** @brief Nesting depth of the batch, 0 if writes are immediate */
+uint8_t ax12_user_sync_open(void);
+
+/** @brief Write integer (2 bytes) in AX-12 memory, batched if a batch
+ * is started, written immediately otherwise.
+ * @return Error code from AX-12 (0 means okay) */
+uint8_t __ax12_user_sync_write_int(AX12 *ax12, uint8_t id, AX12_ADDRESS address,
+				   uint16_t data, uint16_t line);
+
+/** @brief Close the batch, send the writes if it's the outermost
+ * @return Error code from AX-12 (0 means okay) */
+uint8_t __ax12_user_sync_flush(AX12 *ax12, uint16_t line);
+
+/*
+ * Asynchronous AX-12 requests. The request is queued and the function
+ * returns immediately, the status packet is received by the UART RX
+ * interrupt. Completion is polled with ax12_async_done() or notified
+ * by the callback, called from the scheduler event. The request
+ * structure is owned by the caller and must not be modified until it
+ * is done.
+ */
+
+#define AX12_REQ_FREE   0
+#define AX12_REQ_QUEUED 1
+#define AX12_REQ_BUSY   2
+#define AX12_REQ_DONE   3
+
+struct ax12_req {
+	uint8_t id;
+	uint8_t instruction;	/* AX12_READ or AX12_WRITE */
+	AX12_ADDRESS address;
+	uint8_t len;			/* number of data bytes, 1 or 2 */
+	uint16_t data;			/* data to write or data read */
+
+	volatile uint8_t state;
+	uint8_t err;			/* error code, 0 means okay */
+	uint8_t tries;
+	microseconds t;			/* time of last sent */
+
+	void (*cb)(struct ax12_req *req);
+};
+
+/** @brief Queue a read of an integer (2 bytes) from AX-12 memory
+ * @return 0 if queued, -1 if the request is pending or queue is full */
+int8_t ax12_async_read_int(struct ax12_req *req, uint8_t id, AX12_ADDRESS address,
+			   void (*cb)(struct ax12_req *req));
+
+/** @brief Queue a write of an integer (2 bytes) in AX-12 memory
+ * @return 0 if queued, -1 if the request is pending or queue is full */
+int8_t ax12_async_write_int(struct ax12_req *req, uint8_t id, AX12_ADDRESS address,
+			    uint16_t data, void (*cb)(struct ax12_req *req));
+
+/** @brief Return 1 if the request is done, the result is in req->err
+ * and req->data */
+static inline uint8_t ax12_async_done(struct ax12_req *req)
+{
+	return req->state == AX12_REQ_DONE;
+}
@@ -113,6 +113,7 @@
 #define SENSOR_PRIO        120
 #define I2C_POLL_PRIO      110
 #define CS_PRIO            100
+#define AX12_PRIO           90
 
 #define CS_PERIOD 2000L
 
@@ -254,11 +254,18 @@ void state_do_stick_mode(void)
 
 	/*** RIGHT STICK */
 	if(mainboard_command.stick.type == I2C_STICK_TYPE_RIGHT) {
-		/* hide the other */
+		/* hide the other and set right, in one SYNC_WRITE */
+		ax12_traj_sync_begin();
 //retry_hide_left:
 		if(stick_set_mode(&slavedspic.stick_l, STICK_MODE_HIDE, 0))
 			STMCH_ERROR("ERROR %s mode=%d", __FUNCTION__, state_get_mode());
 
+//retry_right:
+		if(stick_set_mode(&slavedspic.stick_r, slavedspic.stick_mode, 
+								slavedspic.stick_offset))
+			STMCH_ERROR("ERROR %s mode=%d", __FUNCTION__, state_get_mode());
+		ax12_traj_sync_flush();
+
 		err = stick_wait_end(&slavedspic.stick_l);
 #if 0
 		if((err & END_BLOCKING) && (nb_tries < STICK_MODES_NB_TRIES)) {
@@ -269,11 +276,6 @@ void state_do_stick_mode(void)
 		/* set right */
 		nb_tries = 0;
 #endif
-//retry_right:
-		if(stick_set_mode(&slavedspic.stick_r, slavedspic.stick_mode, 
-								slavedspic.stick_offset))
-			STMCH_ERROR("ERROR %s mode=%d", __FUNCTION__, state_get_mode());
-
 		err = stick_wait_end(&slavedspic.stick_r);
 #if 0
 		if((err & END_BLOCKING) && (nb_tries < STICK_MODES_NB_TRIES)) {
@@ -287,11 +289,18 @@ void state_do_stick_mode(void)
 	/*** LEFT_STICK */
 	else if(mainboard_command.stick.type == I2C_STICK_TYPE_LEFT) {
 
-		/* hide the other */
+		/* hide the other and set left, in one SYNC_WRITE */
+		ax12_traj_sync_begin();
 //retry_hide_right:
 		if(stick_set_mode(&slavedspic.stick_r, STICK_MODE_HIDE, 0))
 			STMCH_ERROR("ERROR %s mode=%d", __FUNCTION__, state_get_mode());
 
+//retry_left:
+		if(stick_set_mode(&slavedspic.stick_l, slavedspic.stick_mode, 
+								slavedspic.stick_offset))
+			STMCH_ERROR("ERROR %s mode=%d", __FUNCTION__, state_get_mode());
+		ax12_traj_sync_flush();
+
 		err = stick_wait_end(&slavedspic.stick_r);
 #if 0
 		if((err & END_BLOCKING) && (nb_tries < STICK_MODES_NB_TRIES)) {
@@ -301,11 +310,6 @@ void state_do_stick_mode(void)
 		/* set right */
 		nb_tries = 0;
 #endif
-//retry_left:
-		if(stick_set_mode(&slavedspic.stick_l, slavedspic.stick_mode, 
-								slavedspic.stick_offset))
-			STMCH_ERROR("ERROR %s mode=%d", __FUNCTION__, state_get_mode());
-
 		err = stick_wait_end(&slavedspic.stick_l);
 #if 0
 		if((err & END_BLOCKING) && (nb_tries < STICK_MODES_NB_TRIES)) {
@@ -345,8 +349,10 @@ void state_do_harvest_fruits_mode(void)
 	{
 		case I2C_SLAVEDSPIC_MODE_HARVEST_FRUITS_READY:
 
+			ax12_traj_sync_begin();
 			tree_tray_set_mode(&slavedspic.tree_tray, TREE_TRAY_MODE_OPEN, 0);
 			combs_set_mode(&slavedspic.combs, COMBS_MODE_OPEN, 0);
+			ax12_traj_sync_flush();
 			
 			err = combs_wait_end(&slavedspic.combs);
 			if(err & END_BLOCKING)
@@ -361,10 +367,12 @@ void state_do_harvest_fruits_mode(void)
 		case I2C_SLAVEDSPIC_MODE_HARVEST_FRUITS_DO:
 
 			/* new speed */
-			combs_set_mode(&slavedspic.combs, COMBS_MODE_HARVEST_CLOSE, 0);
-
 			ax12_user_write_int(&gen.ax12, AX12_ID_TREE_TRAY, AA_MOVING_SPEED_L, 300);
+
+			ax12_traj_sync_begin();
+			combs_set_mode(&slavedspic.combs, COMBS_MODE_HARVEST_CLOSE, 0);
 			tree_tray_set_mode(&slavedspic.tree_tray, TREE_TRAY_MODE_HARVEST, 0);
+			ax12_traj_sync_flush();
 
 			err = tree_tray_wait_end (&slavedspic.tree_tray);
 			ax12_user_write_int(&gen.ax12, AX12_ID_TREE_TRAY, AA_MOVING_SPEED_L, 0x3FF);
@@ -379,8 +387,10 @@ void state_do_harvest_fruits_mode(void)
 
 		case I2C_SLAVEDSPIC_MODE_HARVEST_FRUITS_END:
 
+			ax12_traj_sync_begin();
 			tree_tray_set_mode(&slavedspic.tree_tray, TREE_TRAY_MODE_OPEN, -126);
 			combs_set_mode(&slavedspic.combs, COMBS_MODE_HIDE, 0);
+			ax12_traj_sync_flush();
 
 			err = tree_tray_wait_end(&slavedspic.tree_tray);
 
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+#
+#  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+#
+#  This program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2 of the License, or
+#  (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software
+#  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+#  Revision : $Id$
+#
+
+"""
+Distance model of the beaconboard sensors, from the calibration samples.
+
+Same fit as beacon_calib.m: polynomial of degree 6 of the scaled measure
+((size/period) x 100000) to distance in cm. The polynomial is sampled in
+mm at knots every 2^KNOT_SHIFT measures, get_dist_array() interpolates
+between knots. Only python standard library, the .mat files are v5.
+
+usage: beacon_dist_fit.py            C tables for beacon_calib.c
+       beacon_dist_fit.py -v         fit residuals and interpolation error
+"""
+
+import os
+import struct
+import sys
+import zlib
+import statistics
+
+KNOT_SHIFT = 7
+DEGREE = 6
+
+# sensor, calibration file, first sample, working range of measure
+SENSORS = (
+    ("S180", "beacon_robot_calib_3m.mat", 0, 920, 5400),
+    ("S0", "beacon_robot_calib_2ndrobot_3m.mat", 1, 820, 4500),
+)
+
+MAT_TYPES = {1: "b", 2: "B", 3: "h", 4: "H", 5: "i", 6: "I", 7: "f", 9: "d"}
+
+
+def load_mat(path):
+    """ (measures, distances) of the 'data' matrix of a v5 .mat file """
+    raw = open(path, "rb").read()
+    pos = 128
+    while pos < len(raw):
+        dtype, size = struct.unpack("<II", raw[pos:pos + 8])
+        elem = raw[pos + 8:pos + 8 + size]
+        pos += 8 + ((size + 7) & ~7)
+        if dtype == 15:
+            elem = zlib.decompress(elem)
+            dtype, size = struct.unpack("<II", elem[:8])
+            elem = elem[8:8 + size]
+        if dtype != 14:
+            continue
+
+        fields, off = [], 0
+        while off < len(elem):
+            ftype, fsize = struct.unpack("<II", elem[off:off + 8])
+            if ftype >> 16:
+                fields.append((ftype & 0xFFFF, elem[off + 4:off + 4 + (ftype >> 16)]))
+                off += 8
+            else:
+                fields.append((ftype, elem[off + 8:off + 8 + fsize]))
+                off += 8 + ((fsize + 7) & ~7)
+
+        rows, cols = struct.unpack("<2i", fields[1][1])
+        name = fields[2][1].decode()
+        ftype, data = fields[3]
+        fmt = MAT_TYPES[ftype]
+        vals = struct.unpack("<%d%s" % (len(data) // struct.calcsize(fmt), fmt), data)
+        if name == "data" and cols == 2:
+            return list(vals[rows:]), list(vals[:rows])
+
+    raise ValueError("%s: no data matrix" % path)
+
+
+def polyfit(x, y, deg):
+    """ least squares, coefficients of increasing degree """
+    n = deg + 1
+    a = [[sum(xi ** (i + j) for xi in x) for j in range(n)] for i in range(n)]
+    b = [sum(yi * xi ** i for xi, yi in zip(x, y)) for i in range(n)]
+
+    for i in range(n):
+        p = max(range(i, n), key=lambda k: abs(a[k][i]))
+        a[i], a[p] = a[p], a[i]
+        b[i], b[p] = b[p], b[i]
+        for k in range(i + 1, n):
+            f = a[k][i] / a[i][i]
+            for j in range(i, n):
+                a[k][j] -= f * a[i][j]
+            b[k] -= f * b[i]
+
+    c = [0.0] * n
+    for i in reversed(range(n)):
+        c[i] = (b[i] - sum(a[i][j] * c[j] for j in range(i + 1, n))) / a[i][i]
+    return c
+
+
+def fit(path, first):
+    """ distance (cm) function of the measure """
+    x, y = load_mat(path)
+    x, y = x[first:], y[first:]
+    mu = statistics.mean(x)
+    sigma = statistics.stdev(x)
+    c = polyfit([(xi - mu) / sigma for xi in x], y, DEGREE)
+
+    def model(m):
+        s = (m - mu) / sigma
+        return sum(ci * s ** i for i, ci in enumerate(c))
+
+    return model, x, y
+
+
+def knots(model, m_min, m_max):
+    """ distance (mm) at each knot from m_min, covering m_max """
+    step = 1 << KNOT_SHIFT
+    n = (m_max - m_min + step - 1) // step + 1
+    return [int(round(model(m_min + i * step) * 10)) for i in range(n)]
+
+
+def interp(table, m_min, m):
+    i = (m - m_min) >> KNOT_SHIFT
+    if i >= len(table) - 1:
+        i = len(table) - 2
+    frac = (m - m_min) - (i << KNOT_SHIFT)
+    # C division, truncated to zero
+    return table[i] + int((table[i + 1] - table[i]) * frac / (1 << KNOT_SHIFT))
+
+
+def main():
+    verbose = "-v" in sys.argv[1:]
+    here = os.path.dirname(os.path.abspath(__file__))
+
+    for name, mat, first, m_min, m_max in SENSORS:
+        model, x, y = fit(os.path.join(here, mat), first)
+        table = knots(model, m_min, m_max)
+
+        if verbose:
+            res = [yi - model(xi) for xi, yi in zip(x, y)]
+            err = max(abs(interp(table, m_min, m) - model(m) * 10)
+                      for m in range(m_min, m_max + 1))
+            print("%s: %s, %d samples, max residual %.1f cm, "
+                  "max interpolation error %.1f mm"
+                  % (name, mat, len(x), max(abs(r) for r in res), err))
+            continue
+
+        print("/* %s distance (mm) every 2^%s_KNOT_SHIFT measures from %s_X_EVAL_MIN,"
+              % (name, name, name))
+        print(" * generated by tests/beacon/beacon_dist_fit.py from %s */" % mat)
+        print("#define %s_KNOTS\t\t%d" % (name, len(table)))
+        print()
+        print("static const int16_t %s_knots[%s_KNOTS] = {"
+              % (name.lower(), name))
+        for i in range(0, len(table), 8):
+            print("\t" + ", ".join("%4d" % v for v in table[i:i + 8]) + ",")
+        print("};")
+        print()
+
+
+if __name__ == "__main__":
+    main()
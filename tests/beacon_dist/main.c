@@ -0,0 +1,191 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Accuracy and time of get_dist_array() of beacon_calib.c, interpolated
+ * model, against the former arrays (dist_array.c):
+ *  - error to the calibration samples of the .mat files of tests/beacon,
+ *  - difference between both over all the working range,
+ *  - distance resolution, mm per measure step at long range,
+ *  - host time per call.
+ * The measure is (size/period) x 100000, size is given with period
+ * 100000 so there is no rounding.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "beacon_host.h"
+#include "../../beaconboard/beacon.h"
+#include "../../beaconboard/beacon_calib.h"
+
+#define BENCH_LOOPS		200
+
+uint16_t get_dist_array_legacy(uint8_t sensor, int32_t size, int32_t period);
+
+struct sample {
+	int32_t measure;
+	double dist_cm;
+};
+
+/* beacon_robot_calib_3m.mat */
+static const struct sample samples_180[] = {
+	{5443, 20.09}, {5318, 30.03}, {5088, 40.02}, {5006, 50.02},
+	{4883, 60.02}, {4754, 70.02}, {4536, 80.02}, {4280, 90.02},
+	{3974, 100.02}, {3670, 110.02}, {3414, 120.02}, {3156, 130.01},
+	{2897, 140.01}, {2681, 150.01}, {2509, 160.01}, {2247, 170.01},
+	{2075, 180.01}, {1901, 190.01}, {1643, 200.01}, {1338, 210.01},
+	{952, 220.01},
+};
+
+/* beacon_robot_calib_2ndrobot_3m.mat, first sample is not in the fit */
+static const struct sample samples_0[] = {
+	{4536, 30}, {3886, 40}, {3587, 50}, {3377, 60}, {3198, 70},
+	{3025, 80}, {2895, 90}, {2679, 100}, {2552, 110}, {2373, 120},
+	{2247, 130}, {2033, 140}, {1813, 150}, {1641, 160}, {1513, 170},
+	{1296, 180}, {1169, 190}, {1080, 200}, {908, 210}, {864, 220},
+	{821, 230},
+};
+
+typedef uint16_t (dist_fn_t)(uint8_t sensor, int32_t size, int32_t period);
+
+struct sensor {
+	const char *name;
+	uint8_t sensor;
+	int32_t min, max;			/* working range of measure */
+	const struct sample *samples;
+	uint8_t nb_samples;
+};
+
+static const struct sensor sensors[] = {
+	{ "s180", IR_SENSOR_180_DEG, 920, 5400, samples_180,
+	  sizeof(samples_180) / sizeof(samples_180[0]) },
+	{ "s0", IR_SENSOR_0_DEG, 1236, 4500, samples_0,
+	  sizeof(samples_0) / sizeof(samples_0[0]) },
+};
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* rms and max error (mm) to the calibration samples in working range */
+static void samples_error(const struct sensor *s, dist_fn_t *fn,
+			  double *rms, double *max)
+{
+	double e, sum = 0;
+	uint8_t i, n = 0;
+
+	*max = 0;
+	for (i = 0; i < s->nb_samples; i++) {
+		if (s->samples[i].measure < s->min || s->samples[i].measure > s->max)
+			continue;
+		e = fn(s->sensor, s->samples[i].measure, 100000) -
+			s->samples[i].dist_cm * 10;
+		sum += e * e;
+		if (fabs(e) > *max)
+			*max = fabs(e);
+		n++;
+	}
+	*rms = n? sqrt(sum / n): 0;
+}
+
+/* mean distance step (mm) between consecutive measures from a distance */
+static double resolution(const struct sensor *s, dist_fn_t *fn, int32_t from_mm)
+{
+	int32_t m, d, last = -1, n = 0, steps = 0, sum = 0;
+
+	for (m = s->max; m >= s->min; m--) {
+		d = fn(s->sensor, m, 100000);
+		if (d < from_mm)
+			continue;
+		if (last >= 0 && d != last) {
+			sum += abs(d - last);
+			steps++;
+		}
+		last = d;
+		n++;
+	}
+	return steps? (double)sum / steps: 0;
+}
+
+static double bench(const struct sensor *s, dist_fn_t *fn)
+{
+	volatile uint16_t d;
+	double t0;
+	int32_t m, l;
+
+	t0 = now_ns();
+	for (l = 0; l < BENCH_LOOPS; l++)
+		for (m = s->min; m <= s->max; m++)
+			d = fn(s->sensor, m, 100000);
+	(void)d;
+
+	return (now_ns() - t0) / (BENCH_LOOPS * (s->max - s->min + 1));
+}
+
+int main(void)
+{
+	double rms, max, rms_old, max_old, diff, diff_max;
+	int32_t m, d;
+	uint8_t i;
+	int ret = 0;
+
+	for (i = 0; i < sizeof(sensors) / sizeof(sensors[0]); i++) {
+		const struct sensor *s = &sensors[i];
+
+		samples_error(s, get_dist_array, &rms, &max);
+		samples_error(s, get_dist_array_legacy, &rms_old, &max_old);
+
+		diff_max = 0;
+		for (m = s->min; m <= s->max; m++) {
+			d = get_dist_array(s->sensor, m, 100000);
+			diff = fabs(d - (double)get_dist_array_legacy(s->sensor, m, 100000));
+			if (diff > diff_max)
+				diff_max = diff;
+		}
+
+		printf("%s samples error: model rms %.1f max %.1f mm, "
+		       "arrays rms %.1f max %.1f mm\n", s->name, rms, max, rms_old, max_old);
+		printf("%s model to arrays: max %.1f mm\n", s->name, diff_max);
+		printf("%s step from 1500 mm: model %.2f mm, arrays %.2f mm\n", s->name,
+		       resolution(s, get_dist_array, 1500),
+		       resolution(s, get_dist_array_legacy, 1500));
+		printf("%s time per call: model %.1f ns, arrays %.1f ns\n", s->name,
+		       bench(s, get_dist_array), bench(s, get_dist_array_legacy));
+
+		/* same curve, the arrays round to cm */
+		if (diff_max > 10 || rms > rms_old + 2) {
+			printf("ERROR: %s model is out of the calibration\n", s->name);
+			ret = -1;
+		}
+	}
+
+	printf("%s\n", ret? "FAILED": "OK");
+	return ret? 1: 0;
+}
@@ -0,0 +1,63 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host replacement of aversive and main.h for the beaconboard sources
+ * built with HOST_VERSION_BEACON_TEST.
+ */
+
+#ifndef _BEACON_HOST_H_
+#define _BEACON_HOST_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef int32_t microseconds;
+
+/* single thread, nothing to lock */
+#define IRQ_LOCK(flags)		do { (flags) = 0; } while (0)
+#define IRQ_UNLOCK(flags)	do { (void)(flags); } while (0)
+
+#define ABS(val) ({					\
+			__typeof(val) __val = (val);	\
+			if (__val < 0)			\
+				__val = - __val;	\
+			__val;				\
+		})
+
+/* logs are dropped, the harness prints its own results */
+#define E_USER_BEACON		197
+#define DEBUG(e, args...)	do { } while (0)
+#define NOTICE(e, args...)	do { } while (0)
+#define ERROR(e, args...)	do { } while (0)
+
+/* as beaconboard main.h, with the 0 deg. sensor of the secondary robot */
+#define TWO_OPPONENTS
+#define ROBOT_2ND
+
+struct beaconboard {
+	uint8_t flags;
+	uint8_t our_color;
+};
+
+extern struct beaconboard beaconboard;
+
+#endif
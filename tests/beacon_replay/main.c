@@ -0,0 +1,691 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host replay of beaconboard Timer 2 captures through the code of the
+ * board: beacon.c (sensor_calc), beacon_calib.c and beacon_track.c are
+ * built with HOST_VERSION_BEACON_TEST, the captures are given as the
+ * input capture interrupts do.
+ *
+ * Stream format, one event per line, '#' comments:
+ *   robot <x> <y> <a>                        beacon robot pose (mm, deg)
+ *   <time_us> P <count> <ov>                 turn sensor, Timer 2 reset
+ *   <time_us> R|F <sensor> <count> <ov>      IR sensor rising/falling edge
+ *   <time_us> C                              beacon_calc event
+ *   <time_us> O <x> <y> [<sensor>]           truth of the last pulse
+ * Truth lines are optional, streams with them give the position error.
+ * Truth -1 -1 is a spurious pulse, the sensor defaults to the 180 deg.
+ *
+ * "gen" writes a simulated stream: the beacon turning at 20 rps, two
+ * opponents around the table seen by the 180 deg. sensor, the secondary
+ * robot seen by the 0 deg. sensor, pulse widths from the calibration of
+ * each sensor, and jitter of the captures. Some pulses are spurious
+ * (reflections) and some widths are wrong (partial occlusions). The 0 deg.
+ * sensor also sees the beacon of an opponent with a width under its
+ * calibration, that get_dist_array() must discard.
+ *
+ * The replay runs the stream once without pulse width filter, then
+ * <loops> times with it, and gives the time per beacon_calc (sensor_calc()
+ * of both sensors) and the revolutions replayed per second.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "beacon_host.h"
+#include "../../common/i2c_commands.h"
+#include "../../beaconboard/beacon.h"
+#include "../../beaconboard/beacon_calib.h"
+
+#define TIMER2_US		6.4			/* Timer 2 period, prescaler 256 */
+#define TURN_US			50000L		/* beacon turn */
+#define EVENT_US		20000L		/* beacon_calc period */
+#define GEN_US			90000000L	/* a match */
+
+#define SPURIOUS_PCT	4			/* spurious pulses per turn */
+#define OCCLUDED_PCT	5			/* wrong widths of opponent pulses */
+#define FAINT_MEASURE	1000		/* opponent beacon seen by the 0 deg. sensor */
+#define BAD_FIX_MM		300			/* fix far from the opponent */
+
+#define ROBOT_X			250
+#define ROBOT_Y			1000
+#define ROBOT_A			0
+
+struct beaconboard beaconboard;
+
+/*
+ * Random numbers and trajectories of the simulation
+ */
+
+static uint32_t seed = 1;
+
+static double uniform(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return ((seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+static double gauss(double sigma)
+{
+	double u = uniform() + 1e-6, v = uniform();
+	return sigma * sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static void opponent_xy(uint8_t num, double t, double *x, double *y)
+{
+	if (num == 0) {
+		*x = 1600 + 900 * sin(0.7 * t);
+		*y = 700 + 300 * cos(1.1 * t);
+	}
+	else {
+		*x = 1600 - 900 * sin(0.5 * t + 0.3);
+		*y = 1300 - 300 * cos(0.9 * t);
+	}
+}
+
+static void robot_2nd_xy(double t, double *x, double *y)
+{
+	*x = 1100 + 500 * sin(0.4 * t);
+	*y = 1400 + 300 * cos(0.6 * t);
+}
+
+/*
+ * Generation
+ */
+
+struct event {
+	int32_t time_us;
+	char type;
+	int32_t sensor, count, ov;
+	double x, y;
+};
+
+static int event_cmp(const void *a, const void *b)
+{
+	const struct event *ea = a, *eb = b;
+
+	if (ea->time_us != eb->time_us)
+		return ea->time_us < eb->time_us? -1: 1;
+	/* captures before the calc event of the same time */
+	return ea->type == 'C'? 1: (eb->type == 'C'? -1: 0);
+}
+
+/* pulse width of a sensor nearest to a distance, inverse of
+ * get_dist_array() */
+static int32_t dist_to_size(uint8_t sensor, int32_t dist, int32_t period)
+{
+	int32_t size, best = 0, err, best_err = -1;
+
+	for (size = 1; size < period / 10; size++) {
+		err = abs((int)get_dist_array(sensor, size, period) - dist);
+		if (best_err < 0 || err < best_err) {
+			best_err = err;
+			best = size;
+		}
+	}
+	return best;
+}
+
+/* Timer 2 count and overflow flag at time t, reset at turn_us */
+static void timer2(double t, int32_t turn_us, int32_t *count, int32_t *ov)
+{
+	int32_t c = (int32_t)((t - turn_us) / TIMER2_US);
+
+	*ov = c > 65535;
+	*count = c & 0xFFFF;
+}
+
+/* a pulse of a sensor in a turn */
+struct pulse {
+	double x, y;			/* beacon seen */
+	int32_t size;			/* width, Timer 2 counts */
+	uint8_t spurious;		/* truth -1 -1 */
+	uint8_t visible;
+	double rising, falling;
+};
+
+/* Pulses of a sensor in a turn, the last one is a reflection. Overlapped
+ * pulses are seen as the nearest one. Write the captures and the truths,
+ * return the number of events. */
+static uint32_t gen_pulses(struct event *ev, uint8_t sensor, int32_t turn_us,
+			   struct pulse *p, uint8_t nb)
+{
+	double t, a, middle;
+	int32_t count, ov;
+	uint32_t n = 0;
+	uint8_t i, j, r = nb - 1;
+
+	for (i = 0; i < r; i++) {
+		/* angle relative to the robot, inverse of get_angle() */
+		a = atan2(p[i].y - ROBOT_Y, p[i].x - ROBOT_X) * 180.0 / M_PI - ROBOT_A;
+		middle = fmod((sensor == IR_SENSOR_180_DEG? 180.0: 360.0) - a + 720.0,
+			      360.0) * TURN_US / 360.0;
+
+		p[i].rising = turn_us + middle - p[i].size * TIMER2_US / 2 + gauss(TIMER2_US);
+		p[i].falling = turn_us + middle + p[i].size * TIMER2_US / 2 + gauss(TIMER2_US);
+		p[i].visible = 1;
+	}
+
+	/* overlapped pulses, the sensor only sees the nearest */
+	for (i = 0; i < r; i++) {
+		for (j = i + 1; j < r; j++) {
+			if (p[i].rising < p[j].falling && p[j].rising < p[i].falling)
+				p[(p[i].falling - p[i].rising) > (p[j].falling - p[j].rising)? j: i].visible = 0;
+		}
+	}
+
+	/* reflection, any angle and width */
+	p[r].visible = uniform() * 100 < SPURIOUS_PCT;
+	p[r].rising = turn_us + uniform() * TURN_US;
+	p[r].falling = p[r].rising + (300 + uniform() * 6700) * TURN_US / 100000;
+	p[r].spurious = 1;
+	for (i = 0; i < r && p[r].visible; i++) {
+		if (p[i].visible && p[r].rising < p[i].falling + 2000 &&
+		    p[i].rising < p[r].falling + 2000)
+			p[r].visible = 0;
+	}
+
+	for (i = 0; i < nb; i++) {
+		if (!p[i].visible || p[i].rising < 0)
+			continue;
+
+		/* the timer is reset each turn */
+		for (j = 0; j < 2; j++) {
+			t = j? p[i].falling: p[i].rising;
+			count = turn_us;
+			if (t >= turn_us + TURN_US)
+				count += TURN_US;
+			else if (t < turn_us)
+				count -= TURN_US;
+			timer2(t, count, &count, &ov);
+
+			ev[n].time_us = (int32_t)t;
+			ev[n].type = j? 'F': 'R';
+			ev[n].sensor = sensor;
+			ev[n].count = count;
+			ev[n].ov = ov;
+			n++;
+		}
+
+		ev[n].time_us = (int32_t)p[i].falling;
+		ev[n].type = 'O';
+		ev[n].sensor = sensor;
+		ev[n].x = p[i].spurious? -1: p[i].x;
+		ev[n].y = p[i].spurious? -1: p[i].y;
+		n++;
+	}
+	return n;
+}
+
+static int gen(const char *file)
+{
+	struct event *ev;
+	struct pulse p[3];
+	uint32_t n = 0, max, i;
+	int32_t turn_us, period, dist;
+	double t;
+	uint8_t num;
+	FILE *f;
+
+	max = (GEN_US / TURN_US) * 19 + (GEN_US / EVENT_US) + 16;
+	ev = malloc(max * sizeof(*ev));
+	if (ev == NULL)
+		return -1;
+
+	/* calc events */
+	for (t = EVENT_US; t < GEN_US; t += EVENT_US) {
+		ev[n].time_us = t;
+		ev[n++].type = 'C';
+	}
+
+	/* turns, pulses of each sensor */
+	period = (int32_t)(TURN_US / TIMER2_US);
+	for (turn_us = 0; turn_us < GEN_US; turn_us += TURN_US) {
+		ev[n].time_us = turn_us;
+		ev[n].type = 'P';
+		timer2(turn_us + TURN_US, turn_us, &ev[n].count, &ev[n].ov);
+		n++;
+
+		/* 180 deg. sensor, opponents */
+		memset(p, 0, sizeof(p));
+		for (num = 0; num < 2; num++) {
+			opponent_xy(num, turn_us * 1e-6, &p[num].x, &p[num].y);
+			dist = (int32_t)hypot(p[num].x - ROBOT_X, p[num].y - ROBOT_Y);
+			p[num].size = dist_to_size(IR_SENSOR_180_DEG, dist, period);
+
+			/* partial occlusion */
+			if (uniform() * 100 < OCCLUDED_PCT)
+				p[num].size = p[num].size * (0.5 + uniform());
+		}
+		n += gen_pulses(&ev[n], IR_SENSOR_180_DEG, turn_us, p, 3);
+
+		/* 0 deg. sensor, secondary robot and the beacon of
+		 * opponent 1 under the calibration range */
+		memset(p, 0, sizeof(p));
+		robot_2nd_xy(turn_us * 1e-6, &p[0].x, &p[0].y);
+		dist = (int32_t)hypot(p[0].x - ROBOT_X, p[0].y - ROBOT_Y);
+		p[0].size = dist_to_size(IR_SENSOR_0_DEG, dist, period);
+		if (uniform() * 100 < OCCLUDED_PCT)
+			p[0].size = p[0].size * (0.5 + uniform());
+
+		opponent_xy(0, turn_us * 1e-6, &p[1].x, &p[1].y);
+		p[1].size = FAINT_MEASURE * (0.95 + 0.1 * uniform()) * period / 100000;
+		p[1].spurious = 1;
+		n += gen_pulses(&ev[n], IR_SENSOR_0_DEG, turn_us, p, 3);
+	}
+
+	qsort(ev, n, sizeof(*ev), event_cmp);
+
+	f = fopen(file, "w");
+	if (f == NULL) {
+		perror(file);
+		free(ev);
+		return -1;
+	}
+
+	fprintf(f, "# simulated beaconboard captures, see main.c\n");
+	fprintf(f, "robot %d %d %d\n", ROBOT_X, ROBOT_Y, ROBOT_A);
+
+	for (i = 0; i < n; i++) {
+		switch (ev[i].type) {
+		case 'P':
+			fprintf(f, "%d P %d %d\n", ev[i].time_us, ev[i].count, ev[i].ov);
+			break;
+		case 'R':
+		case 'F':
+			fprintf(f, "%d %c %d %d %d\n", ev[i].time_us, ev[i].type,
+				ev[i].sensor, ev[i].count, ev[i].ov);
+			break;
+		case 'C':
+			fprintf(f, "%d C\n", ev[i].time_us);
+			break;
+		case 'O':
+			fprintf(f, "%d O %d %d %d\n", ev[i].time_us,
+				(int)floor(ev[i].x + 0.5), (int)floor(ev[i].y + 0.5),
+				ev[i].sensor);
+			break;
+		}
+	}
+
+	fclose(f);
+	free(ev);
+	return 0;
+}
+
+/*
+ * Replay
+ */
+
+struct result {
+	uint32_t turns;
+	uint32_t calcs;
+	uint32_t fixes;
+	uint32_t spurious;				/* fixes of spurious pulses */
+	uint32_t bad;					/* fixes far from the opponent */
+	double err;
+	uint32_t n_err;
+	double latency, latency_max;	/* capture to calc event, us */
+	double calc_ns, calc_ns_max;	/* host cpu time of sensor_calc() */
+};
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int load(const char *file, struct event **events, uint32_t *n_events)
+{
+	struct event *ev = NULL, *tmp;
+	uint32_t n = 0, max = 0;
+	int32_t rx, ry, ra, x, y;
+	char line[128], type;
+	FILE *f;
+	int ret;
+
+	f = fopen(file, "r");
+	if (f == NULL) {
+		perror(file);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+
+		if (n == max) {
+			max = max? max * 2: 4096;
+			tmp = realloc(ev, max * sizeof(*ev));
+			if (tmp == NULL) {
+				free(ev);
+				fclose(f);
+				return -1;
+			}
+			ev = tmp;
+		}
+		memset(&ev[n], 0, sizeof(ev[n]));
+
+		if (sscanf(line, "robot %d %d %d", &rx, &ry, &ra) == 3) {
+			ev[n].type = 'r';
+			ev[n].x = rx;
+			ev[n].y = ry;
+			ev[n].count = ra;
+			n++;
+			continue;
+		}
+
+		if (sscanf(line, "%d %c", &ev[n].time_us, &type) != 2)
+			goto bad;
+		ev[n].type = type;
+
+		switch (type) {
+		case 'P':
+			ret = sscanf(line, "%*d P %d %d", &ev[n].count, &ev[n].ov) == 2;
+			break;
+		case 'R':
+		case 'F':
+			ret = sscanf(line, "%*d %*c %d %d %d", &ev[n].sensor,
+				     &ev[n].count, &ev[n].ov) == 3 &&
+				ev[n].sensor >= 0 && ev[n].sensor < IR_SENSOR_MAX;
+			break;
+		case 'C':
+			ret = 1;
+			break;
+		case 'O':
+			ev[n].sensor = IR_SENSOR_180_DEG;
+			ret = sscanf(line, "%*d O %d %d %d", &x, &y, &ev[n].sensor) >= 2 &&
+				ev[n].sensor >= 0 && ev[n].sensor < IR_SENSOR_MAX;
+			ev[n].x = x;
+			ev[n].y = y;
+			break;
+		default:
+			ret = 0;
+			break;
+		}
+		if (!ret)
+			goto bad;
+		n++;
+		continue;
+ bad:
+		fprintf(stderr, "bad line: %s", line);
+	}
+	fclose(f);
+
+	*events = ev;
+	*n_events = n;
+	return 0;
+}
+
+/* check a fix of the calc event against the truth of its pulse */
+static void result_fix(struct result *r, int32_t t_calc, int32_t t_fix,
+		       int32_t x, int32_t y, const struct event *truth)
+{
+	double lat = t_calc - t_fix;
+	double e;
+
+	r->fixes++;
+	r->latency += lat;
+	if (lat > r->latency_max)
+		r->latency_max = lat;
+
+	if (truth == NULL || truth->time_us != t_fix)
+		return;
+
+	if (truth->x < 0) {
+		r->spurious++;
+		return;
+	}
+
+	e = (x - truth->x) * (x - truth->x) + (y - truth->y) * (y - truth->y);
+	if (e > BAD_FIX_MM * BAD_FIX_MM)
+		r->bad++;
+	r->err += e;
+	r->n_err++;
+}
+
+static void replay_once(const struct event *ev, uint32_t n, struct result *r,
+			struct result *r_2nd, uint8_t filter, FILE *out)
+{
+	const struct event *truth[IR_SENSOR_MAX] = { NULL, NULL };
+	int32_t last_time[3];
+	double t0, dt;
+	uint32_t i;
+
+	beacon_init();
+	beaconboard.flags = 0;
+	last_time[0] = last_time[1] = last_time[2] = 0;
+
+	/* no pulse width filter, as before */
+	for (i = 0; i < IR_SENSOR_MAX && !filter; i++) {
+		beacon.filter[i].n = 1;
+		beacon.filter[i].measure_min = 0;
+		beacon.filter[i].measure_max = INT32_MAX;
+	}
+
+	for (i = 0; i < n; i++) {
+		switch (ev[i].type) {
+		case 'r':
+			beacon.robot_x = ev[i].x;
+			beacon.robot_y = ev[i].y;
+			beacon.robot_a = ev[i].count;
+			break;
+		case 'P':
+			beacon_host_period(ev[i].count, ev[i].ov);
+			r->turns++;
+			break;
+		case 'R':
+		case 'F':
+			beacon_host_edge(ev[i].sensor, ev[i].type == 'R',
+					 ev[i].count, ev[i].ov, ev[i].time_us);
+			break;
+		case 'O':
+			truth[ev[i].sensor] = &ev[i];
+			break;
+		case 'C':
+			/* as beacon_calc() */
+			t0 = now_ns();
+			sensor_calc(IR_SENSOR_0_DEG);
+			sensor_calc(IR_SENSOR_180_DEG);
+			dt = now_ns() - t0;
+
+			r->calcs++;
+			r->calc_ns += dt;
+			if (dt > r->calc_ns_max)
+				r->calc_ns_max = dt;
+
+			/* new fixes of each opponent */
+			if (beacon.opponent1_x != I2C_OPPONENT_NOT_THERE &&
+			    beacon.opponent1_time_us != last_time[0]) {
+				last_time[0] = beacon.opponent1_time_us;
+				result_fix(r, ev[i].time_us, last_time[0],
+					   beacon.opponent1_x, beacon.opponent1_y,
+					   truth[IR_SENSOR_180_DEG]);
+				if (out)
+					fprintf(out, "%d fix 1 %d %d %d\n", ev[i].time_us,
+						beacon.opponent1_x, beacon.opponent1_y,
+						ev[i].time_us - last_time[0]);
+			}
+			if (beacon.opponent2_x != I2C_OPPONENT_NOT_THERE &&
+			    beacon.opponent2_time_us != last_time[1]) {
+				last_time[1] = beacon.opponent2_time_us;
+				result_fix(r, ev[i].time_us, last_time[1],
+					   beacon.opponent2_x, beacon.opponent2_y,
+					   truth[IR_SENSOR_180_DEG]);
+				if (out)
+					fprintf(out, "%d fix 2 %d %d %d\n", ev[i].time_us,
+						beacon.opponent2_x, beacon.opponent2_y,
+						ev[i].time_us - last_time[1]);
+			}
+
+			/* new fixes of the secondary robot */
+			r_2nd->calcs++;
+			if (beacon.robot_2nd_x != I2C_OPPONENT_NOT_THERE &&
+			    beacon.robot_2nd_time_us != last_time[2]) {
+				last_time[2] = beacon.robot_2nd_time_us;
+				result_fix(r_2nd, ev[i].time_us, last_time[2],
+					   beacon.robot_2nd_x, beacon.robot_2nd_y,
+					   truth[IR_SENSOR_0_DEG]);
+				if (out)
+					fprintf(out, "%d fix 0 %d %d %d\n", ev[i].time_us,
+						beacon.robot_2nd_x, beacon.robot_2nd_y,
+						ev[i].time_us - last_time[2]);
+			}
+			break;
+		}
+	}
+}
+
+static void result_print(const char *name, const struct result *r)
+{
+	printf("%-14s fixes %u (%.1f%% of calcs), spurious %u, bad %u, "
+	       "rms error %.1f mm\n", name, r->fixes,
+	       r->calcs? 100.0 * r->fixes / r->calcs: 0, r->spurious, r->bad,
+	       r->n_err? sqrt(r->err / r->n_err): 0);
+}
+
+static int replay(const char *file, uint32_t loops, const char *out_file)
+{
+	struct event *ev;
+	struct result r, r_off, r_bench, r_2nd, r_2nd_off, r_2nd_bench;
+	struct beacon_filter_stats *st;
+	uint32_t n, l, i;
+	double t0, t;
+	FILE *out = NULL;
+	int ret = 0;
+
+	if (load(file, &ev, &n))
+		return -1;
+
+	if (out_file != NULL) {
+		out = fopen(out_file, "w");
+		if (out == NULL) {
+			perror(out_file);
+			free(ev);
+			return -1;
+		}
+		fprintf(out, "# time_us fix <opponent, 0 robot 2nd> x y latency_us\n");
+	}
+
+	memset(&r_off, 0, sizeof(r_off));
+	memset(&r_2nd_off, 0, sizeof(r_2nd_off));
+	replay_once(ev, n, &r_off, &r_2nd_off, 0, NULL);
+
+	memset(&r, 0, sizeof(r));
+	memset(&r_2nd, 0, sizeof(r_2nd));
+	replay_once(ev, n, &r, &r_2nd, 1, out);
+
+	memset(&r_bench, 0, sizeof(r_bench));
+	memset(&r_2nd_bench, 0, sizeof(r_2nd_bench));
+	t0 = now_ns();
+	for (l = 0; l < loops; l++)
+		replay_once(ev, n, &r_bench, &r_2nd_bench, 1, NULL);
+	t = (now_ns() - t0) * 1e-9;
+
+	if (out)
+		fclose(out);
+	free(ev);
+
+	printf("events %u, turns %u, calcs %u\n", n, r.turns, r.calcs);
+	result_print("no filter", &r_off);
+	result_print("filter", &r);
+	result_print("r2nd no filter", &r_2nd_off);
+	result_print("r2nd filter", &r_2nd);
+	for (i = 0; i < IR_SENSOR_MAX; i++) {
+		st = &beacon.filter[i].stats;
+		printf("filter s%d: pulses %u, rejects: range %u, isolated %u, "
+		       "outliers %u\n", i == IR_SENSOR_180_DEG? 180: 0,
+		       st->pulses, st->range, st->isolated, st->outliers);
+	}
+	if (r.fixes)
+		printf("latency avg %.1f ms, max %.1f ms\n",
+		       r.latency / r.fixes * 1e-3, r.latency_max * 1e-3);
+	if (r_bench.calcs)
+		printf("beacon_calc avg %.0f ns, max %.0f ns\n",
+		       r_bench.calc_ns / r_bench.calcs, r_bench.calc_ns_max);
+	printf("replay %u loops %.3f s, %.0f turns/s\n", loops, t,
+	       t > 0? r_bench.turns / t: 0);
+
+	/* simulated stream: at least a fix every two turns, and the filter
+	 * must discard the wrong pulses */
+	if (r.n_err && (r.fixes < r.turns / 2 || sqrt(r.err / r.n_err) > 150)) {
+		printf("ERROR: beacon fixes out of the simulation\n");
+		ret = -1;
+	}
+	if (r.n_err && r.spurious + r.bad > r_off.spurious + r_off.bad) {
+		printf("ERROR: pulse width filter gives more wrong fixes\n");
+		ret = -1;
+	}
+
+	/* the 0 deg. sensor must see the secondary robot, a fix every four
+	 * turns as the opponent beacon takes the capture half of the time,
+	 * and never give this beacon */
+	if (r_2nd.n_err && (r_2nd.fixes < r.turns / 4 ||
+			    sqrt(r_2nd.err / r_2nd.n_err) > 150)) {
+		printf("ERROR: robot 2nd fixes out of the simulation\n");
+		ret = -1;
+	}
+	if (r_2nd.n_err && r_2nd.spurious) {
+		printf("ERROR: robot 2nd fixes of spurious pulses\n");
+		ret = -1;
+	}
+
+	/* both filters must see and reject pulses of the simulated stream */
+	for (i = 0; i < IR_SENSOR_MAX && r.n_err; i++) {
+		st = &beacon.filter[i].stats;
+		if (st->pulses == 0 || st->isolated + st->outliers == 0) {
+			printf("ERROR: filter s%d rejects nothing\n",
+			       i == IR_SENSOR_180_DEG? 180: 0);
+			ret = -1;
+		}
+	}
+
+	printf("%s\n", ret? "FAILED": "OK");
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	const char *out = NULL;
+	uint32_t loops = 1;
+
+	if (argc == 3 && !strcmp(argv[1], "gen"))
+		return gen(argv[2])? 1: 0;
+
+	if (argc >= 2 && argc <= 4) {
+		if (argc >= 3)
+			loops = strtoul(argv[2], NULL, 0);
+		if (argc == 4)
+			out = argv[3];
+		if (loops == 0)
+			loops = 1;
+		return replay(argv[1], loops, out)? 1: 0;
+	}
+
+	fprintf(stderr, "usage: %s <stream> [<loops> [<fixes out>]] | gen <stream>\n",
+		argv[0]);
+	return 1;
+}
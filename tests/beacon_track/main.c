@@ -0,0 +1,348 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host replay of beacon fixes through the two opponents association of
+ * the beaconboard, and through the former nearest in window association
+ * for comparison.
+ *
+ * Stream format, one fix per line, '#' comments:
+ *   robot <x> <y> <a>                   beacon robot pose (mm, deg)
+ *   <time_us> <angle> <dist> [<opp>]    fix relative to the robot
+ * opp is the true opponent of the fix (0, 1, or -1 for a false fix),
+ * streams with it give the swap statistics.
+ *
+ * "gen" writes a simulated stream: two opponents crossing around the
+ * table, one fix every 20 ms of a random visible opponent, beacon noise,
+ * false fixes and occlusions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "../../beaconboard/beacon_track.h"
+
+#define EVENT_US		20000L		/* beacon_calc period */
+#define GEN_US			90000000L	/* a match */
+
+#define OPP_NONE		(-2)		/* no truth in the stream */
+
+/*
+ * Random numbers and trajectories of the simulation
+ */
+
+static uint32_t seed = 1;
+
+static double uniform(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return ((seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+static double gauss(double sigma)
+{
+	double u = uniform() + 1e-6, v = uniform();
+	return sigma * sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/* opponents go back and forth crossing each other at 350 mm */
+static void opponent_xy(uint8_t num, double t, double *x, double *y)
+{
+	if (num == 0) {
+		*x = 1500 + 1000 * sin(0.7 * t);
+		*y = 825 + 250 * cos(1.1 * t);
+	}
+	else {
+		*x = 1500 - 1000 * sin(0.5 * t + 0.3);
+		*y = 1175 - 250 * cos(0.9 * t);
+	}
+}
+
+/* opponent hidden by obstacles */
+static uint8_t opponent_visible(uint8_t num, double t)
+{
+	double p = fmod(t, 15.0);
+
+	if (num == 0)
+		return !(p > 5.0 && p < 5.6);
+	return !(p > 11.0 && p < 12.0);
+}
+
+static int gen(const char *file)
+{
+	const int32_t rx = 250, ry = 1000, ra = 0;
+	double x, y, t, a, d;
+	int32_t time_us, t_us;
+	int8_t opp, vis[2];
+	FILE *f;
+
+	f = fopen(file, "w");
+	if (f == NULL) {
+		perror(file);
+		return -1;
+	}
+
+	fprintf(f, "# simulated beacon fixes: time_us angle dist opponent\n");
+	fprintf(f, "robot %d %d %d\n", rx, ry, ra);
+
+	for (time_us = EVENT_US; time_us < GEN_US; time_us += EVENT_US) {
+
+		/* capture time of the last pulse */
+		t_us = time_us - (int32_t)(uniform() * EVENT_US);
+		t = t_us * 1e-6;
+
+		vis[0] = opponent_visible(0, t);
+		vis[1] = opponent_visible(1, t);
+
+		if (uniform() < 0.03) {
+			/* reflections */
+			opp = -1;
+			x = 200 + uniform() * 2600;
+			y = 200 + uniform() * 1600;
+		}
+		else {
+			if (vis[0] && vis[1])
+				opp = uniform() < 0.5? 0: 1;
+			else if (vis[0] || vis[1])
+				opp = vis[0]? 0: 1;
+			else
+				continue;
+
+			/* non valid pulse */
+			if (uniform() < 0.1)
+				continue;
+
+			opponent_xy(opp, t, &x, &y);
+		}
+
+		a = atan2(y - ry, x - rx) * 180.0 / M_PI - ra + gauss(0.7);
+		d = hypot(x - rx, y - ry) * (1.0 + gauss(0.03));
+		if (a < 0)
+			a += 360;
+
+		fprintf(f, "%d %d %d %d\n", t_us, (int)(a + 0.5), (int)(d + 0.5), opp);
+	}
+
+	fclose(f);
+	return 0;
+}
+
+/*
+ * Former association of sensor_calc(): nearest track inside
+ * TRACKING_WINDOW_mm, else the nearer one is overwritten
+ */
+
+#define TRACKING_WINDOW_mm    200
+
+struct legacy {
+	uint8_t valid[2];
+	uint8_t counts[2];
+	int32_t x[2], y[2];
+};
+
+static int8_t legacy_fix(struct legacy *l, int32_t x, int32_t y)
+{
+	int32_t d[2];
+	int8_t i, num = -1;
+
+	for (i = 0; i < 2; i++)
+		d[i] = l->valid[i]? (int32_t)hypot(x - l->x[i], y - l->y[i]): 100000;
+
+	if (d[0] <= d[1]) {
+		if (d[0] < TRACKING_WINDOW_mm)
+			num = 0;
+	}
+	else if (d[1] < TRACKING_WINDOW_mm)
+		num = 1;
+
+	if (num < 0) {
+		if (!l->valid[0])
+			num = 0;
+		else if (!l->valid[1])
+			num = 1;
+		else
+			num = d[0] < d[1]? 0: 1;
+	}
+
+	l->valid[num] = 1;
+	l->x[num] = x;
+	l->y[num] = y;
+	l->counts[num] = 0;
+
+	for (i = 0; i < 2; i++) {
+		if (l->counts[i] < 10)
+			l->counts[i]++;
+		else
+			l->valid[i] = 0;
+	}
+
+	return num;
+}
+
+/*
+ * Replay
+ */
+
+struct result {
+	int8_t owner[2];		/* true opponent of each track */
+	uint32_t fixes;
+	uint32_t swaps;			/* opponent fix to the track of the other */
+	uint32_t false_fixes;	/* reflection fix given to a track */
+	uint32_t dropouts;		/* track lost while its opponent is visible */
+	double err;
+	uint32_t n_err;
+};
+
+static void result_fix(struct result *r, int8_t num, int8_t opp,
+		       int32_t x, int32_t y, double t, uint8_t *valid_before,
+		       uint8_t *valid_after)
+{
+	double ox, oy;
+	uint8_t i;
+
+	r->fixes++;
+
+	/* lost tracks */
+	for (i = 0; i < 2; i++) {
+		if (valid_before[i] && !valid_after[i] && r->owner[i] >= 0 &&
+		    opponent_visible(r->owner[i], t))
+			r->dropouts++;
+		if (!valid_after[i])
+			r->owner[i] = -1;
+	}
+
+	if (num < 0 || opp == OPP_NONE)
+		return;
+
+	if (opp < 0) {
+		r->false_fixes++;
+		return;
+	}
+
+	if (valid_before[num] && r->owner[num] >= 0 && r->owner[num] != opp)
+		r->swaps++;
+	r->owner[num] = opp;
+
+	opponent_xy(opp, t, &ox, &oy);
+	r->err += (x - ox) * (x - ox) + (y - oy) * (y - oy);
+	r->n_err++;
+}
+
+static void result_print(const char *name, struct result *r)
+{
+	printf("%-8s fixes %u, swaps %u, false fixes used %u, dropouts %u, "
+	       "rms error %.1f mm\n", name, r->fixes, r->swaps, r->false_fixes,
+	       r->dropouts, r->n_err? sqrt(r->err / r->n_err): 0);
+}
+
+static int replay(const char *file)
+{
+	struct beacon_tracker bt;
+	struct legacy l;
+	struct result r_new, r_old;
+	int32_t rx = 0, ry = 0, ra = 0, t_us, a, d, x, y;
+	int opp, n, ret = 0;
+	uint8_t before[2], after[2], i;
+	int8_t num;
+	char line[128];
+	FILE *f;
+
+	f = fopen(file, "r");
+	if (f == NULL) {
+		perror(file);
+		return -1;
+	}
+
+	memset(&bt, 0, sizeof(bt));
+	beacon_track_init(&bt);
+	memset(&l, 0, sizeof(l));
+	memset(&r_new, 0, sizeof(r_new));
+	memset(&r_old, 0, sizeof(r_old));
+	r_new.owner[0] = r_new.owner[1] = -1;
+	r_old.owner[0] = r_old.owner[1] = -1;
+
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+
+		if (sscanf(line, "robot %d %d %d", &rx, &ry, &ra) == 3)
+			continue;
+
+		opp = OPP_NONE;
+		n = sscanf(line, "%d %d %d %d", &t_us, &a, &d, &opp);
+		if (n < 3) {
+			fprintf(stderr, "bad line: %s", line);
+			continue;
+		}
+
+		/* as beacon_angle_dist_to_x_y() */
+		x = rx + (int32_t)(cos((ra + a) * 2 * M_PI / 360) * d);
+		y = ry + (int32_t)(sin((ra + a) * 2 * M_PI / 360) * d);
+
+		for (i = 0; i < 2; i++)
+			before[i] = bt.track[i].valid;
+		num = beacon_track_fix(&bt, x, y, t_us);
+		for (i = 0; i < 2; i++)
+			after[i] = bt.track[i].valid;
+		result_fix(&r_new, num, opp, x, y, t_us * 1e-6, before, after);
+
+		for (i = 0; i < 2; i++)
+			before[i] = l.valid[i];
+		num = legacy_fix(&l, x, y);
+		for (i = 0; i < 2; i++)
+			after[i] = l.valid[i];
+		result_fix(&r_old, num, opp, x, y, t_us * 1e-6, before, after);
+	}
+	fclose(f);
+
+	result_print("window", &r_old);
+	result_print("gated", &r_new);
+	printf("gated stats: fixes %u, updates %u, ambiguous %u, outliers %u, "
+	       "inits %u, replaces %u, lost %u\n",
+	       bt.stats.fixes, bt.stats.updates, bt.stats.ambiguous,
+	       bt.stats.outliers, bt.stats.inits, bt.stats.replaces,
+	       bt.stats.lost);
+
+	/* with the truth, the gated association must do better */
+	if (r_new.n_err &&
+	    (r_new.swaps > r_old.swaps || r_new.false_fixes > r_old.false_fixes)) {
+		printf("ERROR: gated association is worse\n");
+		ret = -1;
+	}
+
+	printf("%s\n", ret? "FAILED": "OK");
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 3 && !strcmp(argv[1], "gen"))
+		return gen(argv[2])? 1: 0;
+
+	if (argc == 2)
+		return replay(argv[1])? 1: 0;
+
+	fprintf(stderr, "usage: %s <stream> | gen <stream>\n", argv[0]);
+	return 1;
+}
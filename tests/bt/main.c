@@ -0,0 +1,190 @@
+/*  
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ * 
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host round trip test of the robot_2nd binary commands: frames are
+ * encoded as the mainboard does, mixed with cmdline text and parsed
+ * byte by byte as the robot_2nd cmdline does. The text must reach the
+ * cmdline untouched and every frame must be decoded with its arguments.
+ * The rules of the status push mode are checked too.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../common/bt_commands.h"
+
+#define STREAM_SIZE 4096
+
+static uint8_t stream[STREAM_SIZE];
+static uint16_t stream_len;
+
+/* text expected by the cmdline and text received */
+static char text_in[STREAM_SIZE], text_out[STREAM_SIZE];
+static uint16_t text_in_len, text_out_len;
+
+static struct bt_robot_2nd_cmd cmds_in[128], cmds_out[128];
+static uint8_t ncmds_in, ncmds_out, nerrors;
+
+static void add_text(const char *s)
+{
+	while (*s) {
+		stream[stream_len++] = *s;
+		text_in[text_in_len++] = *s++;
+	}
+}
+
+static void add_cmd(uint8_t cmd_id, int16_t a0, int16_t a1, int16_t a2, int16_t a3)
+{
+	struct bt_robot_2nd_cmd *cmd = &cmds_in[ncmds_in++];
+
+	cmd->cmd_id = cmd_id;
+	cmd->seq = ncmds_in;
+	cmd->arg[0] = a0;
+	cmd->arg[1] = a1;
+	cmd->arg[2] = a2;
+	cmd->arg[3] = a3;
+	stream_len += bt_robot_2nd_cmd_encode(&stream[stream_len], cmd_id,
+	                                      cmd->seq, a0, a1, a2, a3);
+}
+
+/* as bt_cmd_char_in() of robot_2nd */
+static void parse_stream(void)
+{
+	uint8_t sync_header[] = BT_ROBOT_2ND_CMD_SYNC_HEADER;
+	struct bt_robot_2nd_cmd_parser p;
+	uint16_t i;
+	uint8_t j, ret;
+
+	memset(&p, 0, sizeof(p));
+
+	for (i = 0; i < stream_len; i++) {
+		ret = bt_robot_2nd_cmd_parse(&p, stream[i]);
+
+		for (j = 0; j < p.lost; j++)
+			text_out[text_out_len++] = sync_header[j];
+
+		if (ret == BT_CMD_PARSE_NONE)
+			text_out[text_out_len++] = stream[i];
+		else if (ret == BT_CMD_PARSE_DONE)
+			cmds_out[ncmds_out++] = p.cmd;
+		else if (ret == BT_CMD_PARSE_ERROR)
+			nerrors++;
+	}
+}
+
+static int check(const char *name, uint8_t expected_errors)
+{
+	uint8_t i, k;
+	int err = 0;
+
+	parse_stream();
+
+	if (text_out_len != text_in_len || memcmp(text_in, text_out, text_in_len)) {
+		printf("%s: text differs (%d/%d bytes)\n", name, text_out_len, text_in_len);
+		err = 1;
+	}
+	if (nerrors != expected_errors) {
+		printf("%s: %d checksum errors, expected %d\n", name, nerrors, expected_errors);
+		err = 1;
+	}
+	if (ncmds_out != ncmds_in - expected_errors) {
+		printf("%s: %d commands decoded, expected %d\n", name, ncmds_out,
+		       ncmds_in - expected_errors);
+		err = 1;
+	}
+
+	for (i = 0; i < ncmds_out && !err; i++) {
+		if (cmds_out[i].cmd_id != cmds_in[i].cmd_id ||
+		    cmds_out[i].seq != cmds_in[i].seq) {
+			printf("%s: command %d id %d seq %d, expected %d %d\n", name, i,
+			       cmds_out[i].cmd_id, cmds_out[i].seq,
+			       cmds_in[i].cmd_id, cmds_in[i].seq);
+			err = 1;
+		}
+		for (k = 0; k < BT_ROBOT_2ND_CMD_ARGS_MAX; k++) {
+			if (cmds_out[i].arg[k] != cmds_in[i].arg[k]) {
+				printf("%s: command %d arg %d is %d, expected %d\n", name, i, k,
+				       cmds_out[i].arg[k], cmds_in[i].arg[k]);
+				err = 1;
+			}
+		}
+	}
+
+	printf("%s: %s\n", name, err ? "FAIL" : "ok");
+
+	stream_len = text_in_len = text_out_len = 0;
+	ncmds_in = ncmds_out = nerrors = 0;
+	return err;
+}
+
+int main(void)
+{
+	char ascii[64];
+	int16_t v[] = { 0, 1, -1, 255, 256, 1500, -1500, 32767, -32768, 0x1b };
+	uint8_t id, i;
+	int err = 0;
+
+	/* all the command ids and some edge values */
+	for (id = BT_SET_COLOR; id <= BT_STATUS_PUSH; id++) {
+		for (i = 0; i < sizeof(v)/sizeof(v[0]) - 3; i++)
+			add_cmd(id, v[i], v[i+1], v[i+2], v[i+3]);
+	}
+	err |= check("all ids", 0);
+
+	/* frames mixed with cmdline text and escape sequences */
+	add_text("\nstatus 1 2 3 4 5 6 7 28\n");
+	add_cmd(BT_GOTO_AVOID, 1200, 1400, 0, 0);
+	add_text("\x1b[A\x1b" "c\x1b" "cm");
+	add_cmd(BT_PATROL, 300, 400, 2700, 400);
+	add_cmd(BT_PROTECT_HEART, 2, 0, 0, 0);
+	add_text("\x1b\x1b" "c");
+	add_cmd(BT_GOTO_XY_ABS, -10, 0x1b1b, 0, 0);
+	add_text("help\n");
+	err |= check("mixed text", 0);
+
+	/* corrupted frame is rejected, next one is decoded */
+	add_cmd(BT_GOTO_XY_ABS, 1000, 500, 0, 0);
+	stream[stream_len - 4] ^= 0x01;
+	add_cmd(BT_GOTO_XY_ABS, 1000, 600, 0, 0);
+	cmds_in[0] = cmds_in[1];
+	err |= check("bad checksum", 1);
+
+	/* status push rules */
+	if (bt_status_push_test(1000, 0, 1000, 10) ||
+	    bt_status_push_test(BT_STATUS_PUSH_MIN_MS - 1, 100, 1000, 10) ||
+	    bt_status_push_test(50, 100, 9, 10) ||
+	    !bt_status_push_test(50, 100, 10, 10) ||
+	    !bt_status_push_test(100, 100, 0, 10)) {
+		printf("status push: FAIL\n");
+		err = 1;
+	}
+	else
+		printf("status push: ok\n");
+
+	/* bytes on the link, binary vs ascii */
+	sprintf(ascii, "\nbt_goto xy_abs %d %d %d\n", 1500, 1050, 2550);
+	printf("frame size %d bytes, ascii \"bt_goto xy_abs\" %d bytes\n",
+	       (int)BT_ROBOT_2ND_CMD_FRAME_SIZE, (int)strlen(ascii));
+
+	return err;
+}
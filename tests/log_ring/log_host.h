@@ -0,0 +1,39 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host replacement of aversive for ../../common/log_ring.c built with
+ * HOST_VERSION_LOG_TEST.
+ */
+
+#ifndef _LOG_HOST_H_
+#define _LOG_HOST_H_
+
+#include <stdio.h>
+
+/* single thread, nothing to lock */
+#define IRQ_LOCK(flags)		do { (flags) = 0; } while (0)
+#define IRQ_UNLOCK(flags)	do { (void)(flags); } while (0)
+
+#define PSTR(s)				(s)
+#define printf_P			printf
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host test of the deferred logs (../../common/log_ring.c):
+ *   ./main text      logs of the boards drained as text
+ *   ./main binary    same logs drained as binary frames, the text of
+ *                    ../../maindspic/log_decode.py must be the same
+ *   ./main bench     time of a log stored in the ring against the time
+ *                    of formatting it, as the former mylog()
+ * Some logs are dropped with the ring full, some have too many or too
+ * long arguments.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "log_host.h"
+#include "../../common/log_ring.h"
+
+#define BENCH_LOGS		200000
+#define BENCH_CHUNK		16		/* logs between drains */
+
+static uint32_t now_us = 1000;
+static int16_t pos[3] = { 250, 1500, 90 };
+
+static void send_char(char c)
+{
+	putchar(c);
+}
+
+static int8_t log_push(uint8_t err_num, const char *fmt, ...)
+{
+	va_list ap;
+	int8_t ret;
+
+	va_start(ap, fmt);
+	ret = log_ring_vpush(err_num, 5, fmt, now_us, pos, 3, ap);
+	va_end(ap);
+
+	now_us += 1237;
+	pos[0] += 3;
+	return ret;
+}
+
+/* as the drain event, enough calls to empty the ring */
+static void drain_all(void)
+{
+	int i;
+
+	for (i = 0; i < LOG_RING_SIZE / 8; i++)
+		log_ring_drain();
+}
+
+/* logs of the boards, formats as in the sources */
+static void logs(void)
+{
+	int i;
+
+	log_push(198, "discard xy (%ld %ld), x is out of playground", -120L, 3100L);
+	log_push(198, "opponent rel beacon angle= %.3d\t", 45);
+	log_push(194, "%s: goto (%d,%d) speed %2.2f", "goto_and_avoid", 1500, -300, 12.3456);
+	log_push(195, "i2c error %x, addr %lx", -2, 0x12345678L);
+	log_push(200, "robot_2nd (%.4ld %.4ld) age %.5ld %.3ld", 21L, -3L, 9999L, 7L);
+	log_push(194, "100%% done, %c%c", 'o', 'k');
+	log_push(194, "%-8s|%8s|", "left", "right");
+	log_push(194, "long name %s end", "a string longer than the copied chars");
+	log_push(194, "no arguments");
+	log_push(194, "big %lld %llu", -123456789012LL, 123456789012ULL);
+	log_push(194, "lost %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld %ld end",
+		 1L, 2L, 3L, 4L, 5L, 6L, 7L, 8L, 9L, 10L, 11L, 12L, 13L, 14L, 15L, 16L, 17L, 18L);
+	drain_all();
+
+	/* ring full, drops are reported */
+	for (i = 0; i < 60; i++)
+		log_push(198, "fix %d (%ld %ld)", i, 1000L + i, 500L - i);
+	drain_all();
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void format(char *buf, const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(buf, 128, fmt, ap);
+	va_end(ap);
+}
+
+static void bench(void)
+{
+	struct log_ring_stats st;
+	char buf[128];
+	double t0, t_push = 0, t_format;
+	int i, j;
+
+	/* log_ring_drain() runs at low priority, only the store is timed.
+	 * Frames are not sent, there is no send function */
+	log_ring_init(NULL);
+	log_ring_set_mode(LOG_MODE_BINARY);
+	for (i = 0; i < BENCH_LOGS; i += BENCH_CHUNK) {
+		t0 = now_ns();
+		for (j = 0; j < BENCH_CHUNK; j++)
+			log_push(198, "discard xy (%ld %ld), x is out of playground", -120L, (long)i);
+		t_push += now_ns() - t0;
+		drain_all();
+	}
+	t_push /= BENCH_LOGS;
+
+	log_ring_get_stats(&st);
+	if (st.drops) {
+		printf("ERROR: %lu logs dropped in bench\n", (unsigned long)st.drops);
+		exit(1);
+	}
+
+	t0 = now_ns();
+	for (i = 0; i < BENCH_LOGS; i++)
+		format(buf, "%ld.%.3ld: (%d,%d,%d) discard xy (%ld %ld), x is out of playground",
+		       (long)now_us / 1000000, (long)(now_us / 1000) % 1000,
+		       pos[0], pos[1], pos[2], -120L, (long)i);
+	t_format = (now_ns() - t0) / BENCH_LOGS;
+
+	printf("log stored %.0f ns, formatted %.0f ns (without uart)\n",
+	       t_push, t_format);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s text|binary|bench\n", argv[0]);
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "bench")) {
+		bench();
+		return 0;
+	}
+
+	log_ring_init(send_char);
+	log_ring_set_mode(strcmp(argv[1], "binary")? LOG_MODE_TEXT: LOG_MODE_BINARY);
+	logs();
+	return 0;
+}
@@ -0,0 +1,200 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ * 
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * goto_and_avoid() latency benchmark.
+ *
+ * Build with "make TARGET=bench". Generates a reproducible set of
+ * random scenes (robot, destination, two opponents and robot 2nd) and
+ * runs the whole planning (go in area, escape from polys, poly
+ * reduction loop, oa_process and the corner arcs smoothing) in-process
+ * for each one.
+ *
+ *   ./bench [nb_scenes] [seed] [runs_per_scene]
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#include <aversive.h>
+#include <aversive/error.h>
+
+#include <vect_base.h>
+#include <lines.h>
+#include <polygon.h>
+#include <obstacle_avoidance.h>
+
+#include "../../common/i2c_commands.h"
+
+#include "../../maindspic/strat.h"
+#include "../../maindspic/strat.c"
+#include "../../maindspic/strat_avoid.h"
+#include "../../maindspic/strat_avoid.c"
+#include "../../maindspic/fast_math.c"
+
+#ifndef HOST_VERSION
+#error only for host
+#endif
+
+#define NB_SCENES_DEFAULT	10000
+#define RUNS_DEFAULT		1
+
+/* histogram of poly reduction loop iterations */
+#define LOOPS_HIST_MAX		16
+
+struct scene {
+	int16_t robot_x;
+	int16_t robot_y;
+	int16_t dst_x;
+	int16_t dst_y;
+	int16_t opp1_x;
+	int16_t opp1_y;
+	int16_t opp2_x;
+	int16_t opp2_y;
+	int16_t robot_2nd_x;
+	int16_t robot_2nd_y;
+};
+
+/* logs are disabled, printf would be most of the time */
+void mylog(struct error * e, ...) 
+{
+}
+
+/* return a random integer in [min, max] */
+static int16_t rand_between(unsigned int *state, int16_t min, int16_t max)
+{
+	return min + (rand_r(state) % (max - min + 1));
+}
+
+/* random scene, same seed gives the same scene set */
+static void scene_random(struct scene *s, unsigned int *state)
+{
+	s->robot_x = rand_between(state, 100, AREA_X - 100);
+	s->robot_y = rand_between(state, 100, AREA_Y - 100);
+	s->dst_x = rand_between(state, strat_infos.area_bbox.x1, strat_infos.area_bbox.x2);
+	s->dst_y = rand_between(state, strat_infos.area_bbox.y1, strat_infos.area_bbox.y2);
+	s->opp1_x = rand_between(state, 200, AREA_X - 200);
+	s->opp1_y = rand_between(state, 200, AREA_Y - 200);
+	s->opp2_x = rand_between(state, 200, AREA_X - 200);
+	s->opp2_y = rand_between(state, 200, AREA_Y - 200);
+	s->robot_2nd_x = rand_between(state, 200, AREA_X - 200);
+	s->robot_2nd_y = rand_between(state, 200, AREA_Y - 200);
+}
+
+static double time_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000. + ts.tv_nsec / 1000.;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+	double da = *(const double *)a, db = *(const double *)b;
+	return (da > db) - (da < db);
+}
+
+int main(int argc, char **argv)
+{
+	struct scene s;
+	unsigned int seed = 1, state;
+	uint32_t nb_scenes = NB_SCENES_DEFAULT, runs = RUNS_DEFAULT;
+	uint32_t i, j, n;
+	uint32_t hist[LOOPS_HIST_MAX + 1];
+	uint32_t nb_ok = 0, nb_error = 0, nb_arcs = 0, nb_smoothed = 0;
+	double *lat, t, total = 0;
+	int8_t ret;
+
+	if (argc > 1)
+		nb_scenes = strtoul(argv[1], NULL, 0);
+	if (argc > 2)
+		seed = strtoul(argv[2], NULL, 0);
+	if (argc > 3)
+		runs = strtoul(argv[3], NULL, 0);
+	if (nb_scenes == 0 || runs == 0) {
+		printf("bad args\n");
+		return -1;
+	}
+
+	lat = malloc(sizeof(double) * nb_scenes * runs);
+	if (lat == NULL)
+		return -1;
+	memset(hist, 0, sizeof(hist));
+
+	/* LOGS */
+	error_register_emerg(mylog);
+	error_register_error(mylog);
+	error_register_warning(mylog);
+	error_register_notice(mylog);
+	error_register_debug(mylog);
+
+	/* set playground boundingbox */
+	strat_set_bounding_box(I2C_COLOR_YELLOW);
+	strat_avoid_static_init();
+
+	state = seed;
+	for (i = 0, n = 0; i < nb_scenes; i++) {
+		scene_random(&s, &state);
+
+		for (j = 0; j < runs; j++, n++) {
+			t = time_us();
+			ret = goto_and_avoid(s.dst_x, s.dst_y,
+					   s.robot_x, s.robot_y, 0.0,
+					   s.robot_2nd_x, s.robot_2nd_y,
+					   s.opp1_x, s.opp1_y, s.opp2_x, s.opp2_y);
+			lat[n] = time_us() - t;
+			total += lat[n];
+		}
+
+		if (ret == END_TRAJ) {
+			nb_ok ++;
+			nb_arcs += g_oa_arcs;
+			if (g_oa_arcs)
+				nb_smoothed ++;
+		}
+		else
+			nb_error ++;
+
+		hist[g_oa_loops > LOOPS_HIST_MAX? LOOPS_HIST_MAX: g_oa_loops] ++;
+	}
+
+	qsort(lat, n, sizeof(double), cmp_double);
+
+	printf("scenes %"PRIu32" seed %u runs %"PRIu32"\n", nb_scenes, seed, runs);
+	printf("path found %"PRIu32" error %"PRIu32"\n", nb_ok, nb_error);
+	printf("corner arcs %"PRIu32" in %"PRIu32" paths\n", nb_arcs, nb_smoothed);
+	printf("latency us: avg %.1f p50 %.1f p99 %.1f max %.1f\n",
+	       total / n, lat[n / 2], lat[(n * 99) / 100], lat[n - 1]);
+	printf("reduction loop iterations:\n");
+	for (i = 0; i <= LOOPS_HIST_MAX; i++) {
+		if (hist[i] == 0)
+			continue;
+		printf("  %s%2"PRIu32" %8"PRIu32"\n",
+		       i == LOOPS_HIST_MAX? ">=": "  ", i, hist[i]);
+	}
+
+	free(lat);
+	return 0;
+}
@@ -0,0 +1,208 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ * 
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Accuracy test of the integer geometry used to build the obstacle
+ * avoidance polys (fast_sin(), fast_atan2(), set_rotated_poly(),
+ * set_rotated_pentagon()) against the double precision version.
+ *
+ * Build with "make TARGET=geometry". Returns 0 if all errors are
+ * under the limits.
+ *
+ *   ./geometry [nb_tests] [seed]
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include <aversive.h>
+#include <aversive/error.h>
+
+#include <vect_base.h>
+#include <lines.h>
+#include <polygon.h>
+#include <obstacle_avoidance.h>
+
+#include "../../common/i2c_commands.h"
+
+#include "../../maindspic/strat.h"
+#include "../../maindspic/strat.c"
+#include "../../maindspic/strat_avoid.h"
+#include "../../maindspic/strat_avoid.c"
+#include "../../maindspic/fast_math.c"
+
+#ifndef HOST_VERSION
+#error only for host
+#endif
+
+#define NB_TESTS_DEFAULT	100000
+
+/* limits */
+#define SIN_ERR_MAX		0.002	/* Q15 -> 1.0 */
+#define ATAN2_ERR_MAX		0.7	/* deg */
+#define POLY_ERR_MAX		10.	/* mm */
+
+void mylog(struct error * e, ...) 
+{
+}
+
+/* return a random integer in [min, max] */
+static int16_t rand_between(unsigned int *state, int16_t min, int16_t max)
+{
+	return min + (rand_r(state) % (max - min + 1));
+}
+
+/* double version of set_rotated_poly() */
+static void ref_rotated_poly(point_t *pts, double robot_x, double robot_y, 
+			     int16_t w, int16_t l, int16_t x, int16_t y)
+{
+	const int8_t sign[4][2] = { {1, 1}, {-1, 1}, {-1, -1}, {1, -1} };
+	double a_rad, px, py;
+	uint8_t i;
+
+	a_rad = atan2(y - robot_y, x - robot_x);
+
+	for (i = 0; i < 4; i++) {
+		px = sign[i][0] * w;
+		py = sign[i][1] * l;
+		pts[i].x = x + px * cos(a_rad) - py * sin(a_rad);
+		pts[i].y = y + px * sin(a_rad) + py * cos(a_rad);
+	}
+}
+
+/* double version of set_rotated_pentagon() */
+static void ref_rotated_pentagon(point_t *pts, double robot_x, double robot_y, 
+				 int16_t radius, int16_t x, int16_t y)
+{
+	double a_rad;
+	uint8_t i;
+
+	a_rad = atan2(y - robot_y, x - robot_x) + M_PI/EDGE_NUMBER;
+
+	for (i = 0; i < EDGE_NUMBER; i++) {
+		pts[i].x = x + radius * cos(a_rad);
+		pts[i].y = y + radius * sin(a_rad);
+		a_rad -= 2*M_PI/EDGE_NUMBER;
+	}
+}
+
+/* max distance between points of two polys */
+static double poly_err(point_t *pts, point_t *ref, uint8_t n)
+{
+	double err = 0, d;
+	uint8_t i;
+
+	for (i = 0; i < n; i++) {
+		d = hypot(pts[i].x - ref[i].x, pts[i].y - ref[i].y);
+		if (d > err)
+			err = d;
+	}
+	return err;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int seed = 1, state;
+	uint32_t nb_tests = NB_TESTS_DEFAULT, i;
+	double err, sin_err = 0, atan2_err = 0, rect_err = 0, pent_err = 0;
+	point_t pts[EDGE_NUMBER], ref[EDGE_NUMBER], robot_pt;
+	poly_t pol;
+	int16_t deg, x, y, w, l;
+	int ret = 0;
+
+	if (argc > 1)
+		nb_tests = strtoul(argv[1], NULL, 0);
+	if (argc > 2)
+		seed = strtoul(argv[2], NULL, 0);
+
+	/* LOGS */
+	error_register_emerg(mylog);
+	error_register_error(mylog);
+	error_register_warning(mylog);
+	error_register_notice(mylog);
+	error_register_debug(mylog);
+
+	pol.pts = pts;
+
+	/* trigonometry, all the range */
+	for (deg = -720; deg <= 720; deg++) {
+		err = fabs(fast_sin(deg) / 32768. - sin(RAD(deg)));
+		if (err > sin_err)
+			sin_err = err;
+		err = fabs(fast_cos(deg) / 32768. - cos(RAD(deg)));
+		if (err > sin_err)
+			sin_err = err;
+	}
+
+	state = seed;
+	for (i = 0; i < nb_tests; i++) {
+
+		/* vectors of playground size */
+		x = rand_between(&state, -AREA_X, AREA_X);
+		y = rand_between(&state, -AREA_X, AREA_X);
+		if (x == 0 && y == 0)
+			continue;
+		err = fabs(fast_atan2(y, x) - DEG(atan2(y, x)));
+		if (err > 180)
+			err = 360 - err;
+		if (err > atan2_err)
+			atan2_err = err;
+
+		/* polys as placed by goto_and_avoid() */
+		robot_pt.x = rand_between(&state, 0, AREA_X);
+		robot_pt.y = rand_between(&state, 0, AREA_Y);
+		x = rand_between(&state, 0, AREA_X);
+		y = rand_between(&state, 0, AREA_Y);
+		w = rand_between(&state, 0, 400);
+		l = rand_between(&state, 0, 600);
+
+		pol.l = 4;
+		set_rotated_poly(&pol, &robot_pt, w, l, x, y);
+		ref_rotated_poly(ref, robot_pt.x, robot_pt.y, w, l, x, y);
+		err = poly_err(pts, ref, 4);
+		if (err > rect_err)
+			rect_err = err;
+
+		pol.l = EDGE_NUMBER;
+		set_rotated_pentagon(&pol, &robot_pt, HEARTFIRE_RAD, x, y);
+		ref_rotated_pentagon(ref, robot_pt.x, robot_pt.y, HEARTFIRE_RAD, x, y);
+		err = poly_err(pts, ref, EDGE_NUMBER);
+		if (err > pent_err)
+			pent_err = err;
+	}
+
+	printf("tests %"PRIu32" seed %u\n", nb_tests, seed);
+	printf("fast_sin/cos max error  %f (max %f)\n", sin_err, SIN_ERR_MAX);
+	printf("fast_atan2 max error    %f deg (max %f)\n", atan2_err, ATAN2_ERR_MAX);
+	printf("rotated poly max error  %f mm (max %f)\n", rect_err, POLY_ERR_MAX);
+	printf("pentagon max error      %f mm (max %f)\n", pent_err, POLY_ERR_MAX);
+
+	if (sin_err > SIN_ERR_MAX || atan2_err > ATAN2_ERR_MAX ||
+	    rect_err > POLY_ERR_MAX || pent_err > POLY_ERR_MAX) {
+		printf("FAILED\n");
+		ret = -1;
+	}
+
+	return ret;
+}
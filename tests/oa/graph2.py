@@ -150,6 +150,16 @@ def graph(filename, stx, sty, sta, enx, eny, op1x, op1y, op2x, op2y, robot_2nd_x
         m = re.match("With avoidance (-?\d+): x=(-?\d+) y=(-?\d+)", l)
         if m:
             path.append((int(m.groups()[1]), int(m.groups()[2])))
+
+        # corner arc starting at the last point
+        m = re.match("With avoidance arc (-?\d+): cx=(-?\d+) cy=(-?\d+) r=(-?\d+) a=(-?\d+)", l)
+        if m:
+            cx,cy,r,a = [int(v) for v in m.groups()[1:]]
+            x,y = path[-1]
+            a0 = math.atan2(y - cy, x - cx)
+            for i in range(1, 11):
+                ai = a0 + math.radians(a) * i / 10.
+                path.append((cx + r * math.cos(ai), cy + r * math.sin(ai)))
         
         m = re.match("nb_rays = (-?\d+)", l)
         if m:
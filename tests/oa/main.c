@@ -17,6 +17,7 @@
 #include "../../maindspic/strat.c"
 #include "../../maindspic/strat_avoid.h"
 #include "../../maindspic/strat_avoid.c"
+#include "../../maindspic/fast_math.c"
 
 #ifndef HOST_VERSION
 #error only for host
@@ -94,6 +95,7 @@ int main(void)
 	
 	/* set playground boundingbox */
 	strat_set_bounding_box(I2C_COLOR_YELLOW);
+	strat_avoid_static_init();
 
 	/* goto and avoid */
 	DEBUG(E_USER_STRAT, "robot at: %d %d %d", robot_x, robot_y, (int16_t)robot_a_deg);
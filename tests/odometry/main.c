@@ -0,0 +1,231 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host equivalence test of the fixed point odometry
+ * (../../maindspic/odometry.c) against a double odometry, arc of circle
+ * between two samples, fed with the same virtual encoders. Matches of
+ * random lines, arcs and turns at the mainboard cs period, with a
+ * position reset in the middle as strat_reset_pos(). Fails if the
+ * positions differ more than MAX_ERR_MM or MAX_ERR_DEG. Then times a
+ * step of both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "../../maindspic/odometry.h"
+
+/* as maindspic/main.h and cs.c */
+#define TRACK_MM		293.51078578114
+#define IMP_MM			((((3600.0*4) / (55.0 * M_PI)) * 10.0) * 0.9875567845)
+#define CS_HZ			200
+
+#define MATCHES			20
+#define MATCH_CYCLES	(90 * CS_HZ)
+#define MAX_ERR_MM		0.5
+#define MAX_ERR_DEG		0.01
+#define BENCH_STEPS		2000000
+#define BENCH_WRAP		500000	/* i * 3000 stays in an int32 */
+
+struct pos_double {
+	double x, y, a;
+	int32_t prev_d, prev_a;
+};
+
+static unsigned int rand_state = 1;
+
+static double rand_range(double min, double max)
+{
+	return min + (max - min) * rand_r(&rand_state) / RAND_MAX;
+}
+
+/* reference, arc of circle between two samples */
+static void pos_double_update(struct pos_double *p, int32_t enc_d, int32_t enc_a)
+{
+	double ds, da, r;
+
+	ds = (enc_d - p->prev_d) / IMP_MM;
+	da = 2. * (enc_a - p->prev_a) / (TRACK_MM * IMP_MM);
+	p->prev_d = enc_d;
+	p->prev_a = enc_a;
+
+	if (da == 0) {
+		p->x += ds * cos(p->a);
+		p->y += ds * sin(p->a);
+	}
+	else {
+		r = ds / da;
+		p->x += r * (sin(p->a + da) - sin(p->a));
+		p->y += r * (cos(p->a) - cos(p->a + da));
+	}
+	p->a += da;
+}
+
+static double angle_diff_deg(double a_deg, double b_rad)
+{
+	double d = a_deg - b_rad * 180. / M_PI;
+
+	d = fmod(d, 360.);
+	if (d > 180.)
+		d -= 360.;
+	else if (d < -180.)
+		d += 360.;
+	return fabs(d);
+}
+
+/* one match, return 0 if the positions are the same */
+static int match(int num, double *err_mm, double *err_deg)
+{
+	struct odometry odo;
+	struct pos_double ref = { 0 };
+	double speed_d = 0, speed_a = 0, target_d = 0, target_a = 0;
+	double enc_d = 0, enc_a = 0, e;
+	int32_t d, a;
+	int i, left = 0;
+
+	odometry_init(&odo, TRACK_MM, IMP_MM);
+	odometry_set(&odo, 250., 1000., 0.);
+	ref.x = 250.;
+	ref.y = 1000.;
+
+	for (i = 0; i < MATCH_CYCLES; i++) {
+		/* next segment: line, arc or turn, speeds in mm/s and deg/s */
+		if (left-- == 0) {
+			left = rand_range(0.2, 2.) * CS_HZ;
+			switch (rand_r(&rand_state) % 3) {
+			case 0:
+				target_d = rand_range(-1500, 1500);
+				target_a = 0;
+				break;
+			case 1:
+				target_d = rand_range(-1000, 1000);
+				target_a = rand_range(-180, 180);
+				break;
+			default:
+				target_d = 0;
+				target_a = rand_range(-360, 360);
+				break;
+			}
+		}
+
+		/* first order ramp to the target speed */
+		speed_d += (target_d - speed_d) * 0.05;
+		speed_a += (target_a - speed_a) * 0.05;
+
+		/* virtual encoders, angle is (right - left) / 2 */
+		enc_d += speed_d * IMP_MM / CS_HZ;
+		enc_a += (speed_a * M_PI / 180.) * TRACK_MM * IMP_MM / 2. / CS_HZ;
+		d = (int32_t)floor(enc_d + rand_range(-0.5, 0.5));
+		a = (int32_t)floor(enc_a + rand_range(-0.5, 0.5));
+
+		odometry_update(&odo, d, a);
+		pos_double_update(&ref, d, a);
+
+		/* strat_reset_pos() against a border */
+		if (i == MATCH_CYCLES / 2) {
+			odometry_set(&odo, 1500., 2000. - 162.5, M_PI / 2);
+			ref.x = 1500.;
+			ref.y = 2000. - 162.5;
+			ref.a = M_PI / 2;
+		}
+
+		e = hypot(odo.x / 65536. - ref.x, odo.y / 65536. - ref.y);
+		if (e > *err_mm)
+			*err_mm = e;
+		e = angle_diff_deg(odometry_get_a_deg(&odo), ref.a);
+		if (e > *err_deg)
+			*err_deg = e;
+	}
+
+	printf("match %2d: fixed (%d,%d,%.1f) double (%.0f,%.0f,%.1f)\n", num,
+	       odometry_get_x_s16(&odo), odometry_get_y_s16(&odo),
+	       odometry_get_a_deg(&odo), ref.x, ref.y,
+	       fmod(fmod(ref.a * 180. / M_PI, 360.) + 360., 360.));
+
+	return (*err_mm > MAX_ERR_MM || *err_deg > MAX_ERR_DEG);
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench(void)
+{
+	struct odometry odo;
+	struct pos_double ref = { 0 };
+	double t0, t_fixed, t_double;
+	int32_t i;
+
+	odometry_init(&odo, TRACK_MM, IMP_MM);
+	t0 = now_ns();
+	for (i = 0; i < BENCH_STEPS; i++)
+		odometry_update(&odo, (i % BENCH_WRAP) * 3000, (i % BENCH_WRAP) * 700);
+	t_fixed = (now_ns() - t0) / BENCH_STEPS;
+
+	t0 = now_ns();
+	for (i = 0; i < BENCH_STEPS; i++)
+		pos_double_update(&ref, (i % BENCH_WRAP) * 3000, (i % BENCH_WRAP) * 700);
+	t_double = (now_ns() - t0) / BENCH_STEPS;
+
+	/* keep the results alive */
+	printf("bench: fixed %.1f ns, double %.1f ns per step (%d %.0f)\n",
+	       t_fixed, t_double, odometry_get_x_s16(&odo), ref.x);
+}
+
+int main(void)
+{
+	double err_mm, err_deg, sin_err = 0, e;
+	int i, fail = 0;
+	uint32_t a;
+
+	/* sine table */
+	for (a = 0; a < 0xFFFF0000; a += 0x10000) {
+		e = fabs(odometry_sin(a) / 32768. - sin(a * (2. * M_PI / 4294967296.)));
+		if (e > sin_err)
+			sin_err = e;
+	}
+	printf("sin: max error %.2e\n", sin_err);
+	if (sin_err > 5e-5)
+		fail = 1;
+
+	for (i = 0; i < MATCHES; i++) {
+		err_mm = err_deg = 0;
+		if (match(i, &err_mm, &err_deg)) {
+			printf("match %d: max error %.3f mm %.4f deg, FAIL\n",
+			       i, err_mm, err_deg);
+			fail = 1;
+		}
+		else
+			printf("match %2d: max error %.3f mm %.4f deg\n",
+			       i, err_mm, err_deg);
+	}
+
+	bench();
+	return fail;
+}
@@ -0,0 +1,186 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host test of the simulation inputs record and replay
+ * (../../maindspic/robotsim_rec.c), with a toy robot in place of
+ * robotsim_update():
+ *   ./main record <file>    random opponents and BT chars, recorded
+ *   ./main replay <file>    same inputs read from the record, the
+ *                           printed inputs and the state must be the same
+ *   ./main perturb <file>   replay with the encoders pushed at cycle
+ *                           PERTURB_CYCLE, the first check that differs
+ *                           must be reported
+ * Inputs are received as in robotsim.c: the opponents in the cs cycle,
+ * the BT chars read until -1 by a slower event. The cycles are run by a
+ * toy strat waiting with WAIT_COND_OR_TRAJ_END() of
+ * ../../maindspic/strat_utils.h, as the lockstep clock of robotsim.c
+ * only advances in the HOST_IDLE() of the strat wait loops.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rec_host.h"
+#include "../../maindspic/robotsim_rec.h"
+#include "../../maindspic/strat_utils.h"
+
+#define CYCLES			3000
+#define BT_PERIOD		2		/* cycles between BT reads */
+#define PERTURB_CYCLE	500		/* a check cycle */
+#define TRAJ_CYCLES		50		/* toy trajectory timeout */
+#define TRAJ_END		1		/* toy traj flag */
+#define WAIT_SPINS_MAX	1000	/* test_traj_end() calls in a cycle */
+
+static int32_t l_enc, r_enc, l_pwm, r_pwm;
+static unsigned int rand_state = 1;
+static uint32_t cycle, traj_end_cycle, wait_spins;
+static int perturb;
+
+/* BT chars not read yet, as the robot 2nd fifo */
+static char bt_fifo[64];
+static uint8_t bt_head, bt_tail;
+
+static int16_t bt_fifo_read(void)
+{
+	if (bt_head == bt_tail)
+		return -1;
+	return (uint8_t)bt_fifo[bt_tail++ % sizeof(bt_fifo)];
+}
+
+static int16_t uart_recv_bt(void)
+{
+	if (robotsim_rec_mode() == ROBOTSIM_REC_REPLAY)
+		return robotsim_rec_bt(-1);
+	return robotsim_rec_bt(bt_fifo_read());
+}
+
+static void set_opponent(uint8_t num, int16_t x, int16_t y, uint32_t cycle)
+{
+	robotsim_rec_opp(num, x, y);
+	printf("%u: opp%d %d %d\n", cycle, num, x, y);
+
+	/* the robot reacts to the opponent */
+	l_pwm = (x - 1500) / 4;
+	r_pwm = (y - 1000) / 4;
+}
+
+static void toy_update(void)
+{
+	uint8_t num;
+	int16_t x, y, c;
+
+	robotsim_rec_cycle();
+
+	/* inputs of the simulation */
+	if (robotsim_rec_mode() == ROBOTSIM_REC_REPLAY) {
+		while (robotsim_rec_opp_get(&num, &x, &y) == 0)
+			set_opponent(num, x, y, cycle);
+	}
+	else {
+		if ((rand_r(&rand_state) % 7) == 0)
+			set_opponent(1 + rand_r(&rand_state) % 2,
+				     rand_r(&rand_state) % 3000,
+				     rand_r(&rand_state) % 2000, cycle);
+		if ((rand_r(&rand_state) % 11) == 0) {
+			for (c = rand_r(&rand_state) % 8; c > 0; c--)
+				bt_fifo[bt_head++ % sizeof(bt_fifo)] =
+					'a' + rand_r(&rand_state) % 26;
+		}
+	}
+
+	/* BT event */
+	if ((cycle % BT_PERIOD) == 0) {
+		while ((c = uart_recv_bt()) != -1) {
+			printf("%u: bt %c\n", cycle, c);
+			l_pwm += c & 0x7;
+		}
+	}
+
+	l_enc += l_pwm;
+	r_enc += r_pwm;
+	if (perturb && cycle == PERTURB_CYCLE)
+		l_enc += 5000;
+
+	robotsim_rec_state(l_enc, r_enc, l_pwm, r_pwm);
+}
+
+/* HOST_IDLE() of the strat wait loops, a cycle of the toy robot */
+void toy_idle(void)
+{
+	wait_spins = 0;
+	cycle++;
+	toy_update();
+}
+
+/* traj end of the toy strat, the wait loop must let the cycles go */
+static uint8_t test_traj_end(uint8_t mask)
+{
+	if (++wait_spins > WAIT_SPINS_MAX) {
+		printf("ERROR: wait loop without HOST_IDLE() at cycle %u\n", cycle);
+		exit(1);
+	}
+	return cycle >= traj_end_cycle? (mask & TRAJ_END): 0;
+}
+
+/* toy strat, moves until the left encoder went far enough or the toy
+ * trajectory ends */
+static void toy_strat(void)
+{
+	int32_t l_start;
+	uint8_t err;
+
+	while (cycle < CYCLES) {
+		l_start = l_enc;
+		traj_end_cycle = cycle + TRAJ_CYCLES;
+		if (traj_end_cycle > CYCLES)
+			traj_end_cycle = CYCLES;
+
+		err = WAIT_COND_OR_TRAJ_END(l_enc - l_start > 5000 ||
+					    l_start - l_enc > 5000, TRAJ_END);
+		printf("%u: wait %s\n", cycle, err? "traj end": "cond");
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 3) {
+		printf("usage: %s record|replay|perturb <file>\n", argv[0]);
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "record"))
+		setenv("ROBOTSIM_RECORD", argv[2], 1);
+	else {
+		setenv("ROBOTSIM_REPLAY", argv[2], 1);
+		perturb = !strcmp(argv[1], "perturb");
+	}
+	if (robotsim_rec_init() < 0)
+		return 1;
+
+	toy_strat();
+
+	printf("end enc %d %d\n", l_enc, r_enc);
+	robotsim_rec_close();
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host replacement of aversive for ../../maindspic/robotsim_rec.c built
+ * with HOST_VERSION_REC_TEST.
+ */
+
+#ifndef _REC_HOST_H_
+#define _REC_HOST_H_
+
+/* as maindspic/scheduler_config.h in the host version */
+#define SCHEDULER_UNIT		1000UL
+
+/* as maindspic/main.h in the headless version, the strat wait loops
+ * give the cycles to the toy robot */
+void toy_idle(void);
+#define HOST_IDLE()			toy_idle()
+
+#endif
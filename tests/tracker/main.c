@@ -0,0 +1,183 @@
+/*  
+ *  Copyright Robotics Association of Coslada, Eurobotics Engineering (2014)
+ * 
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Revision : $Id$
+ *
+ */
+
+/*
+ * Host test of the opponents tracker. Two opponents move around the
+ * table, the beaconboard sees them every 50 ms with 60 mm of noise and
+ * a random capture age, the robot 2nd every 100 ms with 100 mm of
+ * noise, 40 ms late and in any order. The position error of the tracks
+ * is compared with the raw beacon positions and with a beacon only
+ * tracker. Tracks must not swap opponents.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "../../maindspic/opp_tracker.h"
+
+#define DT_US			10000L		/* strat event period */
+#define BEACON_US		50000L
+#define BEACON_NOISE	60.0
+#define ROBOT_2ND_US	100000L
+#define ROBOT_2ND_NOISE	100.0
+#define ROBOT_2ND_LAG_US	40000L
+#define TEST_US			90000000L	/* a match */
+
+static uint32_t seed = 1;
+
+static double uniform(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return ((seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+static double gauss(double sigma)
+{
+	double u = uniform() + 1e-9, v = uniform();
+	return sigma * sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/* opponent trajectories, at different speeds and never closer than
+ * 400 mm */
+static void opponent_xy(uint8_t num, uint32_t t_us, double *x, double *y)
+{
+	double t = t_us * 1e-6;
+
+	if (num == 0) {
+		*x = 1500 + 900 * cos(0.8 * t);
+		*y = 1000 + 700 * sin(0.8 * t);
+	}
+	else {
+		*x = 1500 + 300 * cos(-2.0 * t + 1.0);
+		*y = 1000 + 300 * sin(-2.0 * t + 1.0);
+	}
+}
+
+struct result {
+	double err_raw, err_track;
+	uint32_t n, swaps;
+};
+
+static void run(uint8_t fusion, struct result *res)
+{
+	int16_t bx[2], by[2], mx[2], my[2];
+	uint32_t bt[2], mt[2];
+	int8_t num[2], track[2] = {-1, -1};
+	int16_t x, y;
+	double ox, oy, e;
+	uint32_t t;
+	uint8_t i, n;
+
+	memset(res, 0, sizeof(*res));
+	seed = 1;
+	opp_tracker_init();
+
+	for (t = 10 * DT_US; t < TEST_US; t += DT_US) {
+
+		/* beacon */
+		if (t % BEACON_US == 2 * DT_US) {
+			for (i = 0; i < 2; i++) {
+				bt[i] = t - (uint32_t)(uniform() * 30000);
+				opponent_xy(i, bt[i], &ox, &oy);
+				bx[i] = (int16_t)(ox + gauss(BEACON_NOISE));
+				by[i] = (int16_t)(oy + gauss(BEACON_NOISE));
+			}
+			opp_tracker_update(OPP_SRC_BEACON, bx, by, bt, 2, num);
+			for (i = 0; i < 2; i++) {
+				if (track[i] >= 0 && num[i] >= 0 && num[i] != track[i])
+					res->swaps++;
+				if (num[i] >= 0)
+					track[i] = num[i];
+			}
+		}
+
+		/* robot 2nd, opponents order changes */
+		if (fusion && t % ROBOT_2ND_US == 0) {
+			n = uniform() < 0.5;
+			for (i = 0; i < 2; i++) {
+				mt[i] = t - ROBOT_2ND_LAG_US;
+				opponent_xy(i ^ n, mt[i], &ox, &oy);
+				mx[i] = (int16_t)(ox + gauss(ROBOT_2ND_NOISE));
+				my[i] = (int16_t)(oy + gauss(ROBOT_2ND_NOISE));
+			}
+			opp_tracker_update(OPP_SRC_ROBOT_2ND, mx, my, mt, 2, NULL);
+		}
+
+		opp_tracker_manage(t);
+
+		/* skip the start */
+		if (t < 1000000L)
+			continue;
+
+		for (i = 0; i < 2; i++) {
+			opponent_xy(i, t, &ox, &oy);
+
+			e = hypot(bx[i] - ox, by[i] - oy);
+			res->err_raw += e * e;
+
+			if (track[i] < 0 ||
+			    opp_tracker_get(opp_tracker_track(track[i]), t,
+					    &x, &y, NULL, NULL, NULL) < 0) {
+				res->err_track += 1e6;
+				continue;
+			}
+
+			e = hypot(x - ox, y - oy);
+			res->err_track += e * e;
+		}
+		res->n += 2;
+	}
+
+	res->err_raw = sqrt(res->err_raw / res->n);
+	res->err_track = sqrt(res->err_track / res->n);
+}
+
+int main(void)
+{
+	struct result beacon, fused;
+	int nerrors = 0;
+
+	run(0, &beacon);
+	run(1, &fused);
+
+	printf("rms error, raw beacon %.1f mm, beacon track %.1f mm, "
+	       "fused track %.1f mm\n",
+	       beacon.err_raw, beacon.err_track, fused.err_track);
+	printf("track swaps, beacon %u, fused %u\n", beacon.swaps, fused.swaps);
+
+	if (beacon.err_track >= beacon.err_raw) {
+		printf("ERROR: beacon track worse than raw beacon\n");
+		nerrors++;
+	}
+	if (fused.err_track >= beacon.err_track) {
+		printf("ERROR: fusion worse than beacon track\n");
+		nerrors++;
+	}
+	if (beacon.swaps || fused.swaps) {
+		printf("ERROR: tracks swapped\n");
+		nerrors++;
+	}
+
+	printf("%s\n", nerrors? "FAILED": "OK");
+	return nerrors? 1: 0;
+}